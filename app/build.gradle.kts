@@ -52,6 +52,7 @@ android {
 
     buildFeatures {
         viewBinding = true
+        buildConfig = true
         compose = true
     }
 
@@ -0,0 +1,83 @@
+// Host benchmark: per-frame tensor temporaries through the heap, pool and arena allocators.
+// A "frame" builds the shapes the detector touches (input, head, a few activations), runs a
+// couple of in-place ops and drops them, like one camera frame would.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_alloc
+
+#include "allocator.hpp"
+#include "tensor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+void runFrame() {
+    Tensor input({1, 3, 640, 640});
+    Tensor head({1, 55, 8400});
+    Tensor act0({1, 16, 320, 320});
+    Tensor act1({1, 32, 160, 160});
+    Tensor act2({1, 64, 80, 80});
+    input.addScalar(0.5f);
+    act0.ReLU();
+    act2.multiplyScalar(2.0f);
+    head.fill(0.25f);
+}
+
+struct Timing {
+    double meanUs;
+    double maxUs;
+};
+
+template <typename AfterFrame>
+Timing timeFrames(int frames, AfterFrame afterFrame) {
+    double total = 0.0, worst = 0.0;
+    for (int f = 0; f < frames; ++f) {
+        auto start = std::chrono::high_resolution_clock::now();
+        runFrame();
+        afterFrame();
+        auto end = std::chrono::high_resolution_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count();
+        total += us;
+        worst = std::max(worst, us);
+    }
+    return {total / frames, worst};
+}
+
+void report(const char* name, const Timing& t, const AllocatorStats& s) {
+    std::cout << name << "  mean: " << t.meanUs << " us  max: " << t.maxUs << " us"
+              << "  hits: " << s.hits << "  misses: " << s.misses
+              << "  high-water: " << s.highWaterBytes / 1024 << " KB"
+              << "  reserved: " << s.reservedBytes / 1024 << " KB" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    const int frames = 200;
+
+    AllocatorStats heapBefore = currentAllocator().stats();
+    Timing heap = timeFrames(frames, [] {});
+    AllocatorStats heapStats = currentAllocator().stats();
+    heapStats.hits -= heapBefore.hits;
+    heapStats.misses -= heapBefore.misses;
+    report("heap ", heap, heapStats);
+
+    PoolAllocator pool;
+    Timing pooled;
+    {
+        AllocatorScope scope(pool);
+        pooled = timeFrames(frames, [] {});
+    }
+    report("pool ", pooled, pool.stats());
+
+    ArenaAllocator arena;
+    Timing arenaTiming;
+    {
+        AllocatorScope scope(arena);
+        arenaTiming = timeFrames(frames, [&arena] { arena.reset(); });
+    }
+    report("arena", arenaTiming, arena.stats());
+    return 0;
+}
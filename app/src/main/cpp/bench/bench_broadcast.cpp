@@ -0,0 +1,87 @@
+// Host benchmark: broadcasting binary ops read in place through stride-0 dims (in-place
+// multiplyTensor and out-of-place Tensor::multiply) against the old route of expanding the
+// operand with broadcast().toContiguous() before a same-shape op. Results are compared
+// element by element with the expanded route.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_broadcast
+
+#include "simd.hpp"
+#include "tensor.hpp"
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+double timeUs(const std::function<void()>& fn, int iters) {
+    double best = 1e30;
+    for (int i = 0; i < iters; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return best;
+}
+
+void randomize(Tensor& t, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(0.5f, 2.0f);
+    for (int i = 0; i < t.size(); ++i) t.data()[i] = dist(rng);
+}
+
+void run(const char* name, const Tensor& x, const Tensor& operand) {
+    Tensor expected = x.clone();
+    expected.multiplyTensor(operand.broadcast(x.getShape()).toContiguous());
+    Tensor inPlace = x.clone();
+    inPlace.multiplyTensor(operand);
+    Tensor outOfPlace = Tensor::multiply(x, operand);
+    const size_t bytes = x.size() * sizeof(float);
+    const bool exact = std::memcmp(inPlace.data(), expected.data(), bytes) == 0 &&
+                       std::memcmp(outOfPlace.data(), expected.data(), bytes) == 0;
+
+    Tensor work = x.clone();
+    const double tExpand = timeUs([&] { work.multiplyTensor(operand.broadcast(x.getShape()).toContiguous()); }, 20);
+    const double tInPlace = timeUs([&] { work.multiplyTensor(operand); }, 20);
+    const double tOut = timeUs([&] { Tensor r = Tensor::multiply(x, operand); }, 20);
+    std::cout << name << "\n  expand + op: " << tExpand << " us  in place: " << tInPlace << " us ("
+              << 2.0 * bytes * 1e-3 / tInPlace << " GB/s)  out of place: " << tOut << " us  speedup: "
+              << tExpand / tInPlace << "x  " << (exact ? "EXACT" : "MISMATCH") << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "SIMD: " << simd::isaName() << std::endl;
+    std::mt19937 rng(5);
+
+    Tensor x({4, 32, 160, 160});
+    randomize(x, rng);
+
+    Tensor scalar({1});
+    randomize(scalar, rng);
+    run("scalar-like [4,32,160,160] * [1]", x, scalar);
+
+    Tensor channel({32, 1, 1});
+    randomize(channel, rng);
+    run("channel [4,32,160,160] * [32,1,1]", x, channel);
+
+    Tensor row({160});
+    randomize(row, rng);
+    run("row [4,32,160,160] * [160]", x, row);
+
+    Tensor plane({1, 1, 160, 160});
+    randomize(plane, rng);
+    run("plane [4,32,160,160] * [1,1,160,160]", x, plane);
+
+    Tensor column({4, 1, 160, 1});
+    randomize(column, rng);
+    run("column [4,32,160,160] * [4,1,160,1]", x, column);
+
+    Tensor same({4, 32, 160, 160});
+    randomize(same, rng);
+    run("same shape [4,32,160,160]", x, same);
+    return 0;
+}
@@ -0,0 +1,228 @@
+// Host benchmark: conv2d paths (im2col+GEMM, direct, Winograd) and pooling against a naive
+// reference loop, on layer shapes typical of the 224x224 cascade classifiers. Each line
+// reports the path conv2d picks on its own plus the max abs error vs. the reference.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_conv
+
+#include "layers.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+
+namespace {
+
+double timeUs(const std::function<void()>& fn, int iters) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iters;
+}
+
+void randomize(Tensor& t, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (int i = 0; i < t.size(); ++i) t.data()[i] = dist(rng);
+}
+
+float maxDiff(const Tensor& a, const Tensor& b) {
+    if (a.getShape() != b.getShape()) return INFINITY;
+    float worst = 0.0f;
+    for (int i = 0; i < a.size(); ++i) worst = std::max(worst, std::fabs(a.data()[i] - b.data()[i]));
+    return worst;
+}
+
+Tensor referenceConv(const Tensor& x, const Tensor& w, const Tensor* bias, const Conv2dParams& p) {
+    const std::vector<int>& xs = x.getShape();
+    const std::vector<int>& ws = w.getShape();
+    const int N = xs[0], Cin = xs[1], H = xs[2], W = xs[3];
+    const int Cout = ws[0], cinG = ws[1], kH = ws[2], kW = ws[3];
+    const int coutG = Cout / p.groups;
+    const int Hout = convOutputSize(H, kH, p.strideH, p.padH, p.dilationH);
+    const int Wout = convOutputSize(W, kW, p.strideW, p.padW, p.dilationW);
+    Tensor out({N, Cout, Hout, Wout});
+    for (int n = 0; n < N; ++n) {
+        for (int co = 0; co < Cout; ++co) {
+            const int g = co / coutG;
+            for (int oy = 0; oy < Hout; ++oy) {
+                for (int ox = 0; ox < Wout; ++ox) {
+                    double acc = bias ? bias->data()[co] : 0.0;
+                    for (int ci = 0; ci < cinG; ++ci) {
+                        for (int ky = 0; ky < kH; ++ky) {
+                            const int iy = oy * p.strideH + ky * p.dilationH - p.padH;
+                            if (iy < 0 || iy >= H) continue;
+                            for (int kx = 0; kx < kW; ++kx) {
+                                const int ix = ox * p.strideW + kx * p.dilationW - p.padW;
+                                if (ix < 0 || ix >= W) continue;
+                                acc += (double)x.data()[((n * Cin + g * cinG + ci) * H + iy) * W + ix] *
+                                       w.data()[((co * cinG + ci) * kH + ky) * kW + kx];
+                            }
+                        }
+                    }
+                    float v = (float)acc;
+                    if (p.activation == Activation::ReLU) v = v > 0.0f ? v : 0.0f;
+                    if (p.activation == Activation::LReLU) v = v < 0.0f ? v * p.alpha : v;
+                    out.data()[((n * Cout + co) * Hout + oy) * Wout + ox] = v;
+                }
+            }
+        }
+    }
+    return out;
+}
+
+Tensor referencePool(const Tensor& x, const Pool2dParams& p, bool isMax) {
+    const std::vector<int>& xs = x.getShape();
+    const int N = xs[0], C = xs[1], H = xs[2], W = xs[3];
+    const int sH = p.strideH ? p.strideH : p.kernelH, sW = p.strideW ? p.strideW : p.kernelW;
+    const int Hout = convOutputSize(H, p.kernelH, sH, p.padH), Wout = convOutputSize(W, p.kernelW, sW, p.padW);
+    Tensor out({N, C, Hout, Wout});
+    for (int nc = 0; nc < N * C; ++nc) {
+        for (int oy = 0; oy < Hout; ++oy) {
+            for (int ox = 0; ox < Wout; ++ox) {
+                float best = -std::numeric_limits<float>::infinity();
+                double sum = 0.0;
+                int count = 0;
+                for (int ky = 0; ky < p.kernelH; ++ky) {
+                    for (int kx = 0; kx < p.kernelW; ++kx) {
+                        const int iy = oy * sH + ky - p.padH, ix = ox * sW + kx - p.padW;
+                        if (iy < 0 || iy >= H || ix < 0 || ix >= W) continue;
+                        const float v = x.data()[(nc * H + iy) * W + ix];
+                        best = std::max(best, v);
+                        sum += v;
+                        ++count;
+                    }
+                }
+                if (p.countIncludePad) count = p.kernelH * p.kernelW;
+                out.data()[(nc * Hout + oy) * Wout + ox] = isMax ? best : (float)(sum / count);
+            }
+        }
+    }
+    return out;
+}
+
+const char* algoName(ConvAlgo algo) {
+    switch (algo) {
+        case ConvAlgo::Im2colGemm: return "im2col";
+        case ConvAlgo::Direct: return "direct";
+        case ConvAlgo::Winograd: return "winograd";
+        default: return "auto";
+    }
+}
+
+bool algoApplies(ConvAlgo algo, const std::vector<int>& ws, const Conv2dParams& p, int cin) {
+    if (algo == ConvAlgo::Direct) {
+        const bool depthwise = p.groups > 1 && p.groups == cin && ws[0] % cin == 0;
+        const bool pointwise = ws[2] == 1 && ws[3] == 1 && p.strideH == 1 && p.strideW == 1 && p.padH == 0 &&
+                               p.padW == 0;
+        return depthwise || pointwise;
+    }
+    if (algo == ConvAlgo::Winograd) {
+        return ws[2] == 3 && ws[3] == 3 && p.strideH == 1 && p.strideW == 1 && p.dilationH == 1 &&
+               p.dilationW == 1 && p.groups == 1;
+    }
+    return true;
+}
+
+void runConv(const char* name, const std::vector<int>& xs, const std::vector<int>& ws, Conv2dParams p,
+             std::mt19937& rng) {
+    Tensor x(xs), w(ws), b({ws[0]});
+    randomize(x, rng);
+    randomize(w, rng);
+    randomize(b, rng);
+    const Tensor ref = referenceConv(x, w, &b, p);
+    const double macs = (double)ref.size() * ws[1] * ws[2] * ws[3];
+    const int iters = std::max(2, (int)(2e8 / macs));
+
+    std::cout << name << "  auto=" << algoName(selectConvAlgo(xs, ws, p)) << std::endl;
+    for (ConvAlgo algo : {ConvAlgo::Im2colGemm, ConvAlgo::Direct, ConvAlgo::Winograd}) {
+        if (!algoApplies(algo, ws, p, xs[1])) continue;
+        p.algo = algo;
+        const float err = maxDiff(conv2d(x, w, &b, p), ref);
+        const double us = timeUs([&] { Tensor y = conv2d(x, w, &b, p); }, iters);
+        std::cout << "  " << algoName(algo) << ": " << us << " us  " << macs * 2e-3 / us << " GFLOP/s  max err "
+                  << err << std::endl;
+    }
+}
+
+void runPool(const char* name, const std::vector<int>& xs, const Pool2dParams& p, std::mt19937& rng) {
+    Tensor x(xs);
+    randomize(x, rng);
+    const float errMax = maxDiff(maxPool2d(x, p), referencePool(x, p, true));
+    const float errAvg = maxDiff(avgPool2d(x, p), referencePool(x, p, false));
+    const double tMax = timeUs([&] { Tensor y = maxPool2d(x, p); }, 20);
+    const double tAvg = timeUs([&] { Tensor y = avgPool2d(x, p); }, 20);
+    std::cout << name << "  max: " << tMax << " us (err " << errMax << ")  avg: " << tAvg << " us (err " << errAvg
+              << ")" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "SIMD: " << simd::isaName() << std::endl;
+    std::mt19937 rng(3);
+
+    Conv2dParams stem;
+    stem.strideH = stem.strideW = 2;
+    stem.padH = stem.padW = 1;
+    stem.activation = Activation::ReLU;
+    runConv("stem 3x3/2 3->32 @224", {1, 3, 224, 224}, {32, 3, 3, 3}, stem, rng);
+
+    Conv2dParams same;
+    same.padH = same.padW = 1;
+    same.activation = Activation::ReLU;
+    runConv("3x3 32->32 @112", {1, 32, 112, 112}, {32, 32, 3, 3}, same, rng);
+    runConv("3x3 64->64 @56", {1, 64, 56, 56}, {64, 64, 3, 3}, same, rng);
+    runConv("3x3 128->128 @28", {1, 128, 28, 28}, {128, 128, 3, 3}, same, rng);
+    runConv("3x3 128->128 @14", {1, 128, 14, 14}, {128, 128, 3, 3}, same, rng);
+    runConv("3x3 256->256 @7 (odd size)", {1, 256, 7, 7}, {256, 256, 3, 3}, same, rng);
+
+    Conv2dParams dw = same;
+    dw.groups = 64;
+    runConv("dw 3x3 64 @56", {1, 64, 56, 56}, {64, 1, 3, 3}, dw, rng);
+    dw.strideH = dw.strideW = 2;
+    dw.activation = Activation::LReLU;
+    dw.alpha = 0.1f;
+    runConv("dw 3x3/2 64 @56", {1, 64, 56, 56}, {64, 1, 3, 3}, dw, rng);
+
+    Conv2dParams pw;
+    runConv("1x1 64->128 @56", {1, 64, 56, 56}, {128, 64, 1, 1}, pw, rng);
+
+    Conv2dParams dil = same;
+    dil.padH = dil.padW = 2;
+    dil.dilationH = dil.dilationW = 2;
+    dil.groups = 2;
+    runConv("3x3 dil2 groups2 32->32 @33 batch2", {2, 32, 33, 33}, {32, 16, 3, 3}, dil, rng);
+
+    Conv2dParams k5;
+    k5.strideH = 1;
+    k5.strideW = 2;
+    k5.padH = 2;
+    k5.padW = 1;
+    runConv("5x5 s(1,2) 8->16 @45", {1, 8, 45, 45}, {16, 8, 5, 5}, k5, rng);
+
+    Pool2dParams p2;
+    runPool("pool 2x2/2 @112x64", {1, 64, 112, 112}, p2, rng);
+    Pool2dParams p3;
+    p3.kernelH = p3.kernelW = 3;
+    p3.strideH = p3.strideW = 1;
+    p3.padH = p3.padW = 1;
+    runPool("pool 3x3/1 pad1 @56x64", {1, 64, 56, 56}, p3, rng);
+    p3.strideH = p3.strideW = 2;
+    p3.countIncludePad = true;
+    runPool("pool 3x3/2 pad1 incl-pad @57x64", {1, 64, 57, 57}, p3, rng);
+
+    Tensor g({2, 256, 7, 7});
+    randomize(g, rng);
+    Tensor gap = globalAvgPool(g);
+    float err = 0.0f;
+    for (int c = 0; c < 2 * 256; ++c) {
+        double sum = 0.0;
+        for (int i = 0; i < 49; ++i) sum += g.data()[c * 49 + i];
+        err = std::max(err, std::fabs(gap.data()[c] - (float)(sum / 49)));
+    }
+    std::cout << "globalAvgPool [2,256,7,7]  max err " << err << std::endl;
+    return 0;
+}
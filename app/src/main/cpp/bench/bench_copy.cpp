@@ -0,0 +1,102 @@
+// Host benchmark: the strided copy engine (strided::pack into a reused buffer, and
+// toContiguous() with its allocation) against the per-element index loop makeContiguous used
+// to run, with a plain memcpy of the same bytes as the bandwidth ceiling. Every packed result
+// is compared element by element with the index loop.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_copy
+
+#include "simd.hpp"
+#include "strided_copy.hpp"
+#include "tensor.hpp"
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+double timeUs(const std::function<void()>& fn, int iters) {
+    double best = 1e30;
+    for (int i = 0; i < iters; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return best;
+}
+
+// The old makeContiguousCpu: rebuild every element's offset from its linear index
+void indexLoop(const Tensor& t, float* dst) {
+    const std::vector<int>& shape = t.getShape();
+    const std::vector<int>& strides = t.getStrides();
+    const float* src = t.data();
+    for (int i = 0; i < t.size(); ++i) {
+        int rem = i, offset = 0;
+        for (int d = (int)shape.size() - 1; d >= 0; --d) {
+            offset += (rem % shape[d]) * strides[d];
+            rem /= shape[d];
+        }
+        dst[i] = src[offset];
+    }
+}
+
+void run(const char* name, const Tensor& view) {
+    const int n = view.size();
+    std::vector<float> ref(n), copy(n);
+    indexLoop(view, ref.data());
+    Tensor packed = view.toContiguous();
+    const bool exact = std::memcmp(packed.data(), ref.data(), n * sizeof(float)) == 0;
+
+    const double tIndex = timeUs([&] { indexLoop(view, copy.data()); }, 3);
+    const double tPack = timeUs([&] { strided::pack(view.data(), view.getShape(), view.getStrides(), copy.data()); }, 20);
+    const double tContig = timeUs([&] { Tensor t = view.toContiguous(); }, 20);
+    const double tMemcpy = timeUs([&] { std::memcpy(copy.data(), ref.data(), n * sizeof(float)); }, 20);
+    const double gb = 2.0 * n * sizeof(float) * 1e-3; // read + write, in GB per us
+    std::cout << name << "\n  index loop: " << tIndex << " us  pack: " << tPack << " us (" << gb / tPack
+              << " GB/s)  toContiguous: " << tContig << " us  memcpy: " << tMemcpy << " us (" << gb / tMemcpy
+              << " GB/s)  speedup: " << tIndex / tPack << "x  " << (exact ? "EXACT" : "MISMATCH") << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "SIMD: " << simd::isaName() << std::endl;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    Tensor x({4, 3, 512, 512});
+    for (int i = 0; i < x.size(); ++i) x.data()[i] = dist(rng);
+    Tensor nhwc = x.view();
+    nhwc.transpose({0, 2, 3, 1});
+    run("NCHW -> NHWC [4,3,512,512]", nhwc);
+
+    Tensor packedNhwc = nhwc.toContiguous();
+    Tensor nchw = packedNhwc.view();
+    nchw.transpose({0, 3, 1, 2});
+    run("NHWC -> NCHW [4,512,512,3]", nchw);
+
+    Tensor f({1, 64, 128, 128});
+    for (int i = 0; i < f.size(); ++i) f.data()[i] = dist(rng);
+    Tensor fNhwc = f.view();
+    fNhwc.transpose({0, 2, 3, 1});
+    run("NCHW -> NHWC [1,64,128,128]", fNhwc);
+
+    Tensor m({2048, 2048});
+    for (int i = 0; i < m.size(); ++i) m.data()[i] = dist(rng);
+    Tensor mT = m.view();
+    mT.transpose({1, 0});
+    run("2-D transpose [2048,2048]", mT);
+
+    Tensor heads = f.view();
+    heads.reshape({1, 64, 16384});
+    heads.transpose({0, 2, 1});
+    run("channels-last matrix [1,64,16384] -> [1,16384,64]", heads);
+
+    run("narrow crop [4,3,512,500]", x.narrow(3, 6, 500));
+    run("stepped slice [4,3,512,256]", x.slice(3, 0, 512, 2));
+    run("broadcast [4,3,512,512] <- [1,3,1,512]", x.narrow(0, 0, 1).narrow(2, 0, 1).broadcast({4, 3, 512, 512}));
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Host benchmark: SIMD row-major YOLO decode vs. the per-anchor column scan used by
+// OnnxInferenceEngine.detect() (stride-numAnchors reads for every class score).
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_decode
+
+#include "yolo_decoder.hpp"
+#include "simd.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+void referenceDecode(const std::vector<float>& output, int numClasses, int numAnchors, float conf,
+                     const LetterboxInfo& lb, DetectionCandidates& out) {
+    out.clear();
+    for (int a = 0; a < numAnchors; ++a) {
+        float cx = output[a];
+        float cy = output[numAnchors + a];
+        float w = output[2 * numAnchors + a];
+        float h = output[3 * numAnchors + a];
+
+        float maxScore = 0.0f;
+        int classId = -1;
+        for (int c = 0; c < numClasses; ++c) {
+            float score = output[(size_t)(4 + c) * numAnchors + a];
+            if (score > maxScore) {
+                maxScore = score;
+                classId = c;
+            }
+        }
+        if (maxScore < conf) continue;
+
+        out.push((cx - w / 2 - lb.padX) / lb.scale, (cy - h / 2 - lb.padY) / lb.scale,
+                 (cx + w / 2 - lb.padX) / lb.scale, (cy + h / 2 - lb.padY) / lb.scale, maxScore, classId);
+    }
+}
+
+template <typename F>
+double timeUs(F&& fn, int iters) {
+    fn();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iters;
+}
+
+} // namespace
+
+int main() {
+    const int numAnchors = 8400;
+    const int iters = 200;
+    const int classCounts[] = {1, 51, 80, 200};
+    const float thresholds[] = {0.25f, 0.05f};
+
+    std::cout << "ISA: " << simd::isaName() << "\n";
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> box(0.0f, 640.0f);
+    // Sigmoid-like score distribution: mostly near zero with a sparse tail
+    std::exponential_distribution<float> score(25.0f);
+
+    LetterboxInfo lb = computeLetterbox(1280, 720, 640, 640);
+    DetectionCandidates ref, fast;
+
+    for (int numClasses : classCounts) {
+        std::vector<float> output((size_t)(4 + numClasses) * numAnchors);
+        for (int i = 0; i < 4 * numAnchors; ++i) output[i] = box(rng);
+        for (size_t i = (size_t)4 * numAnchors; i < output.size(); ++i) output[i] = std::min(1.0f, score(rng));
+
+        for (float conf : thresholds) {
+            double refUs = timeUs([&] { referenceDecode(output, numClasses, numAnchors, conf, lb, ref); }, iters);
+            double fastUs = timeUs([&] { decodeYolo(output.data(), numClasses, numAnchors, conf, lb, fast); }, iters);
+
+            bool match = ref.size() == fast.size();
+            for (size_t i = 0; match && i < ref.size(); ++i) {
+                match = ref.classId[i] == fast.classId[i] && ref.score[i] == fast.score[i] &&
+                        std::fabs(ref.x1[i] - fast.x1[i]) < 1e-3f && std::fabs(ref.y2[i] - fast.y2[i]) < 1e-3f;
+            }
+
+            std::cout << "classes=" << numClasses << " conf=" << conf
+                      << "  candidates=" << fast.size()
+                      << "  reference: " << refUs << " us"
+                      << "  simd: " << fastUs << " us"
+                      << "  speedup: " << refUs / fastUs << "x"
+                      << "  " << (match ? "MATCH" : "MISMATCH") << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Host benchmark: fused TensorExpr chains vs. the same ops as separate Tensor passes on the
+// [4, 3, 512, 512] workload from main.cpp. Results must match exactly (same ops, same order).
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_expr
+
+#include "tensor.hpp"
+#include "tensor_expr.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+
+namespace {
+
+double timeUs(const std::function<void()>& fn, int iters) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iters;
+}
+
+float maxDiff(const Tensor& a, const Tensor& b) {
+    float worst = 0.0f;
+    for (int i = 0; i < a.size(); ++i) {
+        float d = std::fabs(a.data()[i] - b.data()[i]);
+        if (std::isnan(a.data()[i]) != std::isnan(b.data()[i])) d = INFINITY;
+        if (!std::isnan(d)) worst = std::max(worst, d);
+    }
+    return worst;
+}
+
+void run(const char* name, int ops, const Tensor& input,
+         const std::function<void(Tensor&)>& unfused, const std::function<void(Tensor&)>& fused) {
+    const int iters = 10;
+    Tensor a = input.clone();
+    Tensor b = input.clone();
+    unfused(a);
+    fused(b);
+    const float diff = maxDiff(a, b);
+
+    double tUnfused = timeUs([&] { Tensor t = input.clone(); unfused(t); }, iters);
+    double tFused = timeUs([&] { Tensor t = input.clone(); fused(t); }, iters);
+    double tCopy = timeUs([&] { Tensor t = input.clone(); }, iters);
+    tUnfused -= tCopy;
+    tFused -= tCopy;
+
+    std::cout << name << " (" << ops << " ops)  separate: " << tUnfused << " us  fused: " << tFused
+              << " us  speedup: " << tUnfused / tFused << "x  " << (diff == 0.0f ? "MATCH" : "MISMATCH")
+              << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "SIMD: " << simd::isaName() << std::endl;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(0.1f, 2.0f);
+
+    Tensor input({4, 3, 512, 512});
+    Tensor other({4, 3, 512, 512});
+    for (int i = 0; i < input.size(); ++i) {
+        input.data()[i] = dist(rng) - 1.0f;
+        other.data()[i] = dist(rng);
+    }
+    Tensor bias({3});
+    bias.data()[0] = 0.1f;
+    bias.data()[1] = -0.2f;
+    bias.data()[2] = 0.3f;
+    Tensor row({512});
+    for (int i = 0; i < 512; ++i) row.data()[i] = dist(rng);
+
+    run("scale+bias+relu", 3, input,
+        [&](Tensor& t) { t.multiplyScalar(2.0f); t.addBias(bias); t.ReLU(); },
+        [&](Tensor& t) { t.expr().mul(2.0f).addBias(bias).relu().eval(); });
+
+    run("normalize+sigmoid", 3, input,
+        [&](Tensor& t) { t.subtractScalar(0.5f); t.divideScalar(0.25f); t.sigmoid(); },
+        [&](Tensor& t) { t.expr().sub(0.5f).div(0.25f).sigmoid().eval(); });
+
+    run("main.cpp chain", 8, input,
+        [&](Tensor& t) {
+            t.addTensor(other); t.addScalar(1.5f); t.subtractTensor(other); t.multiplyTensor(other);
+            t.divideTensor(other); t.negate(); t.ReLU(); t.square();
+        },
+        [&](Tensor& t) {
+            t.expr().add(other).add(1.5f).sub(other).mul(other).div(other).neg().relu().square().eval();
+        });
+
+    Tensor rowBroadcast = row.broadcast({4, 3, 512, 512}).toContiguous();
+    run("broadcast row add+mul", 2, input,
+        [&](Tensor& t) { t.addTensor(rowBroadcast); t.multiplyScalar(0.5f); },
+        [&](Tensor& t) { t.expr().add(row).mul(0.5f).eval(); });
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Host benchmark: packed SGEMM vs. a naive triple loop (sgemmReference) in GFLOP/s on square
+// and skinny shapes: fully-connected heads (M = 1), im2col convs (small K, huge N) and the
+// reverse. Also checks Tensor::matmul on transposed views and batched operands.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_gemm
+
+#include "gemm.hpp"
+#include "simd.hpp"
+#include "tensor.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+double timeUs(const std::function<void()>& fn, int iters) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iters;
+}
+
+void randomize(float* p, size_t n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (size_t i = 0; i < n; ++i) p[i] = dist(rng);
+}
+
+// Max error relative to the largest reference magnitude
+float relError(const float* a, const float* ref, size_t n) {
+    float worst = 0.0f, scale = 1e-30f;
+    for (size_t i = 0; i < n; ++i) {
+        worst = std::max(worst, std::fabs(a[i] - ref[i]));
+        scale = std::max(scale, std::fabs(ref[i]));
+    }
+    return worst / scale;
+}
+
+void runShape(const char* name, int M, int N, int K, bool transA, bool transB, std::mt19937& rng) {
+    std::vector<float> A((size_t)M * K), B((size_t)K * N), C((size_t)M * N), R((size_t)M * N);
+    randomize(A.data(), A.size(), rng);
+    randomize(B.data(), B.size(), rng);
+    const int lda = transA ? M : K, ldb = transB ? K : N;
+
+    const double flops = 2.0 * M * N * K;
+    const int iters = std::max(1, (int)(4e9 / flops));
+    const double tNaive = timeUs([&] { sgemmReference(transA, transB, M, N, K, A.data(), lda, B.data(), ldb,
+                                                      R.data(), N); }, std::max(1, iters / 20));
+    const double tPacked = timeUs([&] { sgemm(transA, transB, M, N, K, A.data(), lda, B.data(), ldb, C.data(), N); },
+                                  iters);
+    std::cout << name << " [" << M << "x" << K << "] x [" << K << "x" << N << "]" << (transA ? " A^T" : "")
+              << (transB ? " B^T" : "") << "  naive: " << flops * 1e-3 / tNaive << " GFLOP/s  sgemm: "
+              << flops * 1e-3 / tPacked << " GFLOP/s  (" << tNaive / tPacked << "x)  rel err "
+              << relError(C.data(), R.data(), C.size()) << std::endl;
+}
+
+void checkMatmul(std::mt19937& rng) {
+    // Batched [3, 40, 70] x shared [70, 50], with the right side stored transposed
+    Tensor a({3, 40, 70});
+    Tensor bt({50, 70});
+    randomize(a.data(), a.size(), rng);
+    randomize(bt.data(), bt.size(), rng);
+    Tensor b = bt.view();
+    b.transpose({1, 0});
+    Tensor c = a.matmul(b);
+
+    float worst = 0.0f;
+    std::vector<float> ref(40 * 50);
+    for (int i = 0; i < 3; ++i) {
+        sgemmReference(false, true, 40, 50, 70, a.data() + i * 40 * 70, 70, bt.data(), 70, ref.data(), 50);
+        worst = std::max(worst, relError(c.data() + i * 40 * 50, ref.data(), ref.size()));
+    }
+
+    // Strided (sliced) left operand that is neither row- nor column-major gets packed
+    Tensor big({2, 40, 140});
+    randomize(big.data(), big.size(), rng);
+    Tensor sliced = big.slice(2, 0, 140, 2); // [2, 40, 70], column stride 2
+    Tensor d = sliced.matmul(b);
+    Tensor packed = sliced.clone();
+    for (int i = 0; i < 2; ++i) {
+        sgemmReference(false, true, 40, 50, 70, packed.data() + i * 40 * 70, 70, bt.data(), 70, ref.data(), 50);
+        worst = std::max(worst, relError(d.data() + i * 40 * 50, ref.data(), ref.size()));
+    }
+    std::cout << "matmul batched/transposed/strided  rel err " << worst << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "SIMD: " << simd::isaName() << "  threads: " << ThreadPool::getInstance().getThreadCount()
+              << std::endl;
+    std::mt19937 rng(5);
+
+    for (int n : {64, 128, 256, 512, 1024}) runShape("square", n, n, n, false, false, rng);
+    runShape("square", 500, 500, 500, true, false, rng);
+    runShape("square", 500, 500, 500, false, true, rng);
+    runShape("fc (M = 1)", 1, 1000, 1280, false, true, rng);
+    runShape("fc batch 8", 8, 1000, 1280, false, true, rng);
+    runShape("im2col stem", 32, 12544, 27, false, false, rng);
+    runShape("im2col 3x3x64", 64, 3136, 576, false, false, rng);
+    runShape("tall-skinny", 4096, 16, 256, false, false, rng);
+    runShape("odd", 127, 333, 97, false, false, rng);
+
+    checkMatmul(rng);
+    return 0;
+}
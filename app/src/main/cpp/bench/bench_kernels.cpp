@@ -0,0 +1,149 @@
+// Host benchmark + accuracy check for the SIMD elementwise kernels (kernels.hpp) against the
+// scalar libm reference (kernels::ref / plain loops).
+//
+// Accuracy: every 16th float bit pattern in each function's range is compared with the
+// double-precision libm result rounded to float, reporting the max ULP distance.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_kernels
+
+#include "kernels.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Maps float bit patterns onto a monotonic integer line so ULP distance is a subtraction
+int64_t ordered(float f) {
+    int32_t i;
+    std::memcpy(&i, &f, sizeof(i));
+    return i < 0 ? (int64_t)INT32_MIN - i : i;
+}
+
+float fromBits(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+uint32_t toBits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+struct Accuracy {
+    int64_t maxUlp = 0;
+    float worstX = 0.0f;
+    size_t samples = 0;
+};
+
+// Sweeps [lo, hi] (same sign) every `step` bit patterns through the kernel in batches
+Accuracy sweep(float lo, float hi, const std::function<void(float*, int)>& kernel,
+               const std::function<double(double)>& reference, uint32_t step = 16) {
+    Accuracy acc;
+    std::vector<float> xs, ys;
+    auto flush = [&] {
+        ys = xs;
+        kernel(ys.data(), (int)ys.size());
+        for (size_t i = 0; i < xs.size(); ++i) {
+            float ref = (float)reference((double)xs[i]);
+            int64_t ulp = std::llabs(ordered(ys[i]) - ordered(ref));
+            if (std::isnan(ref) && std::isnan(ys[i])) ulp = 0;
+            if (ulp > acc.maxUlp) {
+                acc.maxUlp = ulp;
+                acc.worstX = xs[i];
+            }
+        }
+        acc.samples += xs.size();
+        xs.clear();
+    };
+
+    uint32_t a = toBits(lo), b = toBits(hi);
+    if (a > b) std::swap(a, b);
+    for (uint64_t u = a; u <= b; u += step) {
+        xs.push_back(fromBits((uint32_t)u));
+        if (xs.size() == 1 << 16) flush();
+    }
+    flush();
+    return acc;
+}
+
+void reportAccuracy(const char* name, const char* range, const Accuracy& a) {
+    std::cout << name << " " << range << "  max ULP: " << a.maxUlp << " (x = " << a.worstX << ", "
+              << a.samples << " samples)" << std::endl;
+}
+
+double timeUs(const std::function<void(float*, int)>& kernel, const std::vector<float>& input, int iters) {
+    std::vector<float> buf(input.size());
+    double best = 1e30;
+    for (int it = 0; it < iters; ++it) {
+        std::copy(input.begin(), input.end(), buf.begin());
+        auto start = std::chrono::high_resolution_clock::now();
+        kernel(buf.data(), (int)buf.size());
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return best;
+}
+
+void compare(const char* name, const std::vector<float>& input,
+             const std::function<void(float*, int)>& reference, const std::function<void(float*, int)>& simdKernel) {
+    double tRef = timeUs(reference, input, 5);
+    double tSimd = timeUs(simdKernel, input, 5);
+    std::cout << name << "  scalar: " << tRef << " us  simd: " << tSimd << " us  speedup: " << tRef / tSimd << "x"
+              << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "SIMD: " << simd::isaName() << " (width " << simd::kWidth << ")" << std::endl;
+
+    std::cout << "\n--- accuracy vs double libm ---" << std::endl;
+    auto dexp = [](double x) { return std::exp(x); };
+    reportAccuracy("exp", "[-87.3, 0]", sweep(-0.0f, -87.3f, kernels::exp, dexp));
+    reportAccuracy("exp", "[0, 88.7]", sweep(0.0f, 88.7f, kernels::exp, dexp));
+    reportAccuracy("exp", "[-103.9, -87.3] (denormal results)", sweep(-87.3f, -103.9f, kernels::exp, dexp));
+    reportAccuracy("log", "(0, FLT_MAX]", sweep(fromBits(1), 3.4028235e38f, kernels::log,
+                                                 [](double x) { return std::log(x); }));
+    auto dtanh = [](double x) { return std::tanh(x); };
+    reportAccuracy("tanh", "[-20, 0]", sweep(-0.0f, -20.0f, kernels::tanh, dtanh));
+    reportAccuracy("tanh", "[0, 20]", sweep(0.0f, 20.0f, kernels::tanh, dtanh));
+    auto dsig = [](double x) { return 1.0 / (1.0 + std::exp(-x)); };
+    reportAccuracy("sigmoid", "[-87, 0]", sweep(-0.0f, -87.0f, kernels::sigmoid, dsig));
+    reportAccuracy("sigmoid", "[0, 20]", sweep(0.0f, 20.0f, kernels::sigmoid, dsig));
+
+    // Reference libm float kernels for comparison of the same metric
+    reportAccuracy("ref expf", "[-87.3, 0]", sweep(-87.3f, -0.0f, kernels::ref::exp, dexp));
+
+    std::cout << "\n--- throughput, 3 M floats (one [4, 3, 512, 512] tensor / 4) ---" << std::endl;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-8.0f, 8.0f);
+    std::vector<float> input(3 * 1024 * 1024);
+    for (float& v : input) v = dist(rng);
+    std::vector<float> positive(input.size());
+    for (size_t i = 0; i < input.size(); ++i) positive[i] = std::fabs(input[i]) + 1e-3f;
+    std::vector<float> other(input.size(), 1.5f);
+
+    compare("exp    ", input, kernels::ref::exp, kernels::exp);
+    compare("log    ", positive, kernels::ref::log, kernels::log);
+    compare("tanh   ", input, kernels::ref::tanh, kernels::tanh);
+    compare("sigmoid", input, kernels::ref::sigmoid, kernels::sigmoid);
+    compare("elu    ", input, [](float* x, int n) { kernels::ref::elu(x, n, 1.0f); },
+            [](float* x, int n) { kernels::elu(x, n, 1.0f); });
+    compare("relu   ", input, [](float* x, int n) { for (int i = 0; i < n; ++i) x[i] = fmaxf(x[i], 0.0f); },
+            kernels::relu);
+    compare("div    ", input, [&](float* x, int n) { for (int i = 0; i < n; ++i) x[i] /= other[i]; },
+            [&](float* x, int n) { kernels::div(x, other.data(), n); });
+    compare("sqrt   ", positive, [](float* x, int n) { for (int i = 0; i < n; ++i) x[i] = sqrtf(x[i]); },
+            kernels::sqrt);
+    return 0;
+}
@@ -0,0 +1,223 @@
+// Host benchmark: memory formats (NCHW, NHWC, NCHWc4, NCHWc8). Times the conversion kernels,
+// per-channel bias, conv2d / pooling in each format and the letterbox writing straight into
+// each format. Every result is converted back to NCHW and compared with the NCHW path.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_layout
+
+#include "layers.hpp"
+#include "preprocess.hpp"
+#include "simd.hpp"
+#include "tensor_expr.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+const MemoryFormat kFormats[] = {MemoryFormat::NCHW, MemoryFormat::NHWC, MemoryFormat::NCHWc4, MemoryFormat::NCHWc8};
+
+double timeUs(const std::function<void()>& fn, int iters) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iters;
+}
+
+void randomize(Tensor& t, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (int i = 0; i < t.size(); ++i) t.data()[i] = dist(rng);
+}
+
+// Max abs difference after bringing `a` back to NCHW
+float maxDiff(const Tensor& a, const Tensor& nchw) {
+    const Tensor back = a.toMemoryFormat(MemoryFormat::NCHW);
+    if (back.getShape() != nchw.getShape()) return INFINITY;
+    float worst = 0.0f;
+    for (int i = 0; i < back.size(); ++i) worst = std::max(worst, std::fabs(back.data()[i] - nchw.data()[i]));
+    return worst;
+}
+
+void runConversions(const std::vector<int>& shape, std::mt19937& rng) {
+    Tensor x(shape);
+    randomize(x, rng);
+    const double bytes = 2.0 * sizeof(float) * x.size();
+    std::cout << "convert [" << shape[0] << ", " << shape[1] << ", " << shape[2] << ", " << shape[3] << "]" << std::endl;
+    for (MemoryFormat f : kFormats) {
+        if (f == MemoryFormat::NCHW) continue;
+        Tensor y = x.toMemoryFormat(f);
+        const double tTo = timeUs([&] { Tensor t = x.toMemoryFormat(f); }, 20);
+        const double tBack = timeUs([&] { Tensor t = y.toMemoryFormat(MemoryFormat::NCHW); }, 20);
+        std::cout << "  NCHW -> " << std::setw(6) << memoryFormatName(f) << ": " << tTo << " us ("
+                  << bytes * 1e-3 / tTo << " GB/s)  back: " << tBack << " us  round trip "
+                  << (maxDiff(y, x) == 0.0f ? "EXACT" : "MISMATCH") << std::endl;
+    }
+    Tensor c4 = x.toMemoryFormat(MemoryFormat::NCHWc4);
+    std::cout << "  NCHWc4 -> NCHWc8 -> NHWC round trip "
+              << (maxDiff(c4.toMemoryFormat(MemoryFormat::NCHWc8).toMemoryFormat(MemoryFormat::NHWC), x) == 0.0f
+                      ? "EXACT" : "MISMATCH") << std::endl;
+}
+
+void runBias(const std::vector<int>& shape, std::mt19937& rng) {
+    Tensor x(shape), bias({shape[1]}), scale({shape[1]});
+    randomize(x, rng);
+    randomize(bias, rng);
+    randomize(scale, rng);
+    Tensor ref = x.clone();
+    ref.multiplyBias(scale);
+    ref.addBias(bias);
+    ref.ReLU();
+
+    std::cout << "mulBias+addBias+relu / channelAffine+relu [" << shape[0] << ", " << shape[1] << ", " << shape[2] << ", " << shape[3] << "]"
+              << std::endl;
+    for (MemoryFormat f : kFormats) {
+        const Tensor src = x.toMemoryFormat(f);
+        Tensor a = src.clone();
+        a.multiplyBias(scale);
+        a.addBias(bias);
+        a.ReLU();
+        Tensor e = src.clone();
+        e.expr().mulBias(scale).addBias(bias).relu().eval();
+        Tensor f2 = src.clone();
+        f2.channelAffine(scale, bias);
+        f2.ReLU();
+        const double tOps = timeUs([&] {
+            Tensor t = src.clone();
+            t.multiplyBias(scale);
+            t.addBias(bias);
+            t.ReLU();
+        }, 20);
+        const double tExpr = timeUs([&] {
+            Tensor t = src.clone();
+            t.expr().mulBias(scale).addBias(bias).relu().eval();
+        }, 20);
+        const double tAffine = timeUs([&] {
+            Tensor t = src.clone();
+            t.channelAffine(scale, bias);
+            t.ReLU();
+        }, 20);
+        std::cout << "  " << std::setw(6) << memoryFormatName(f) << "  ops: " << tOps << " us  expr: " << tExpr
+                  << " us  channelAffine: " << tAffine << " us  max err "
+                  << std::max({maxDiff(a, ref), maxDiff(e, ref), maxDiff(f2, ref)}) << std::endl;
+    }
+}
+
+void runConv(const char* name, const std::vector<int>& xs, const std::vector<int>& ws, const Conv2dParams& p,
+             std::mt19937& rng) {
+    Tensor x(xs), w(ws), b({ws[0]});
+    randomize(x, rng);
+    randomize(w, rng);
+    randomize(b, rng);
+    const Tensor ref = conv2d(x, w, &b, p);
+    const double macs = (double)ref.size() * ws[1] * ws[2] * ws[3];
+    const int iters = std::max(2, (int)(2e8 / macs));
+
+    std::cout << name << std::endl;
+    for (MemoryFormat f : kFormats) {
+        const Tensor src = x.toMemoryFormat(f);
+        const Tensor y = conv2d(src, w, &b, p);
+        const double us = timeUs([&] { Tensor t = conv2d(src, w, &b, p); }, iters);
+        std::cout << "  " << std::setw(6) << memoryFormatName(f) << ": " << us << " us  " << macs * 2e-3 / us
+                  << " GFLOP/s  max err " << maxDiff(y, ref)
+                  << (y.getMemoryFormat() == f ? "" : "  (WRONG OUTPUT FORMAT)") << std::endl;
+    }
+}
+
+void runPool(const char* name, const std::vector<int>& xs, const Pool2dParams& p, std::mt19937& rng) {
+    Tensor x(xs);
+    randomize(x, rng);
+    const Tensor refMax = maxPool2d(x, p), refAvg = avgPool2d(x, p), refGap = globalAvgPool(x);
+    std::cout << name << std::endl;
+    for (MemoryFormat f : kFormats) {
+        const Tensor src = x.toMemoryFormat(f);
+        const float err = std::max({maxDiff(maxPool2d(src, p), refMax), maxDiff(avgPool2d(src, p), refAvg),
+                                    maxDiff(globalAvgPool(src), refGap)});
+        const double tMax = timeUs([&] { Tensor t = maxPool2d(src, p); }, 20);
+        const double tAvg = timeUs([&] { Tensor t = avgPool2d(src, p); }, 20);
+        const double tGap = timeUs([&] { Tensor t = globalAvgPool(src); }, 20);
+        std::cout << "  " << std::setw(6) << memoryFormatName(f) << "  max: " << tMax << " us  avg: " << tAvg
+                  << " us  global: " << tGap << " us  max err " << err << std::endl;
+    }
+}
+
+void runLetterbox(std::mt19937& rng) {
+    const int w = 1280, h = 720, size = 640;
+    std::vector<uint8_t> rgba((size_t)w * h * 4);
+    for (uint8_t& v : rgba) v = (uint8_t)(rng() & 0xFF);
+    Tensor ref({1, 3, size, size});
+    letterboxNormalize(rgba.data(), w, h, w * 4, PixelFormat::RGBA8888, ref);
+
+    std::cout << "letterbox 1280x720 -> 640x640" << std::endl;
+    for (MemoryFormat f : kFormats) {
+        Tensor direct = Tensor::withMemoryFormat({1, 3, size, size}, f);
+        letterboxNormalize(rgba.data(), w, h, w * 4, PixelFormat::RGBA8888, direct);
+        const double tDirect = timeUs([&] {
+            letterboxNormalize(rgba.data(), w, h, w * 4, PixelFormat::RGBA8888, direct);
+        }, 20);
+        // The alternative: NCHW letterbox followed by a conversion pass
+        Tensor planar({1, 3, size, size});
+        const double tTwoPass = timeUs([&] {
+            letterboxNormalize(rgba.data(), w, h, w * 4, PixelFormat::RGBA8888, planar);
+            Tensor t = planar.toMemoryFormat(f);
+        }, 20);
+        std::cout << "  " << std::setw(6) << memoryFormatName(f) << "  direct: " << tDirect
+                  << " us  NCHW + convert: " << tTwoPass << " us  max err " << maxDiff(direct, ref) << std::endl;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "SIMD: " << simd::isaName() << std::endl;
+    std::mt19937 rng(17);
+
+    runConversions({1, 64, 112, 112}, rng);
+    runConversions({2, 3, 224, 224}, rng);
+    runBias({1, 64, 112, 112}, rng);
+    runBias({1, 3, 224, 224}, rng);
+
+    Conv2dParams stem;
+    stem.strideH = stem.strideW = 2;
+    stem.padH = stem.padW = 1;
+    stem.activation = Activation::ReLU;
+    runConv("stem 3x3/2 3->32 @224", {1, 3, 224, 224}, {32, 3, 3, 3}, stem, rng);
+
+    Conv2dParams same;
+    same.padH = same.padW = 1;
+    same.activation = Activation::ReLU;
+    runConv("3x3 32->32 @112", {1, 32, 112, 112}, {32, 32, 3, 3}, same, rng);
+    runConv("3x3 64->64 @56", {1, 64, 56, 56}, {64, 64, 3, 3}, same, rng);
+    runConv("3x3 128->128 @14", {1, 128, 14, 14}, {128, 128, 3, 3}, same, rng);
+    runConv("3x3 20->36 @30 (ragged blocks)", {2, 20, 30, 30}, {36, 20, 3, 3}, same, rng);
+
+    Conv2dParams dw = same;
+    dw.groups = 64;
+    runConv("dw 3x3 64 @56", {1, 64, 56, 56}, {64, 1, 3, 3}, dw, rng);
+    dw.strideH = dw.strideW = 2;
+    dw.activation = Activation::LReLU;
+    dw.alpha = 0.1f;
+    runConv("dw 3x3/2 64 @56", {1, 64, 56, 56}, {64, 1, 3, 3}, dw, rng);
+
+    Conv2dParams pw;
+    runConv("1x1 64->128 @56", {1, 64, 56, 56}, {128, 64, 1, 1}, pw, rng);
+
+    Conv2dParams grouped = same;
+    grouped.padH = grouped.padW = 2;
+    grouped.dilationH = grouped.dilationW = 2;
+    grouped.groups = 2;
+    runConv("3x3 dil2 groups2 32->32 @33", {1, 32, 33, 33}, {32, 16, 3, 3}, grouped, rng);
+
+    Pool2dParams p3;
+    p3.kernelH = p3.kernelW = 3;
+    p3.strideH = p3.strideW = 2;
+    p3.padH = p3.padW = 1;
+    runPool("pool 3x3/2 pad1 @57x64", {1, 64, 57, 57}, p3, rng);
+
+    runLetterbox(rng);
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Host benchmark: cost of a log call on the producer thread with the asynchronous Logger
+// against the old synchronous route (ostringstream + mutex + std::endl on every record), for
+// LOG_INFO from 1 and 4 threads and for a small Tensor construct/destroy (which logs CREATE,
+// ALLOC, DEALLOC and DESTROY). Also reports written / dropped counts under LogOverflow::Drop
+// and Block, and the Tensor cost with logging off at runtime: build a second time with
+// CMAKE_CXX_FLAGS=-DTSR_LOG_MIN_LEVEL=5 (every LOG_* compiled out) for the no-logging reference.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_logger
+
+#include "logger.hpp"
+#include "tensor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* kLogPath = "bench_logger.log";
+const char* kSyncPath = "bench_logger_sync.log";
+
+// Nanoseconds per call of fn(i), i in [0, count), run on `threads` threads at once
+double nsPerCall(const std::function<void(int)>& fn, int count, int threads) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < count; ++i) fn(i);
+        });
+    }
+    for (auto& w : workers) w.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / count;
+}
+
+// What every Logger call used to do on the calling thread
+struct SyncLogger {
+    std::ofstream file{kSyncPath, std::ios::app};
+    std::mutex mutex;
+
+    void info(const std::string& message, const std::string& component) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ostringstream oss;
+        oss << message << " [Component: " << component << "]";
+        file << std::chrono::system_clock::now().time_since_epoch().count() << " [INFO] " << oss.str() << std::endl;
+    }
+};
+
+void runAsync(const char* name, LogOverflow overflow, int threads, int count) {
+    LoggerOptions options;
+    options.overflow = overflow;
+    Logger& logger = Logger::getInstance();
+    logger.initialize(kLogPath, LogLevel::INFO, false, options);
+    const uint64_t writtenBefore = logger.getWrittenCount(), droppedBefore = logger.getDroppedCount();
+    const double ns = nsPerCall([](int) { LOG_INFO("frame processed"); }, count, threads);
+    logger.close();
+    std::cout << "  async " << name << ": " << ns << " ns/call  written " << logger.getWrittenCount() - writtenBefore
+              << "  dropped " << logger.getDroppedCount() - droppedBefore << std::endl;
+}
+
+} // namespace
+
+int main() {
+    const int count = 100000;
+    for (int threads : {1, 4}) {
+        std::cout << "LOG_INFO x " << count << " on " << threads << " thread(s)" << std::endl;
+        {
+            SyncLogger sync;
+            const double ns = nsPerCall([&](int) { sync.info("frame processed", "main"); }, count, threads);
+            std::cout << "  synchronous: " << ns << " ns/call" << std::endl;
+        }
+        runAsync("drop", LogOverflow::Drop, threads, count);
+        runAsync("block", LogOverflow::Block, threads, count);
+    }
+
+    std::cout << "Tensor({16}) construct + destroy x " << count << std::endl;
+    Logger& logger = Logger::getInstance();
+    for (LogOverflow overflow : {LogOverflow::Drop, LogOverflow::Block}) {
+        LoggerOptions options;
+        options.overflow = overflow;
+        logger.initialize(kLogPath, LogLevel::INFO, false, options);
+        const double ns = nsPerCall([](int) { Tensor t({16}); }, count, 1);
+        logger.close();
+        std::cout << "  " << (overflow == LogOverflow::Drop ? "drop" : "block") << ": " << ns << " ns" << std::endl;
+    }
+
+    std::cout << "Tensor({16}) construct + destroy x " << count << ", logging off (TSR_LOG_MIN_LEVEL "
+              << TSR_LOG_MIN_LEVEL << ")" << std::endl;
+    double best = 1e30;
+    for (int rep = 0; rep < 5; ++rep) best = std::min(best, nsPerCall([](int) { Tensor t({16}); }, count, 1));
+    std::cout << "  logger not initialized: " << best << " ns" << std::endl;
+    logger.initialize(kLogPath, LogLevel::CRITICAL, false);
+    best = 1e30;
+    for (int rep = 0; rep < 5; ++rep) best = std::min(best, nsPerCall([](int) { Tensor t({16}); }, count, 1));
+    logger.close();
+    std::cout << "  level CRITICAL: " << best << " ns" << std::endl;
+
+    std::remove(kLogPath);
+    std::remove(kSyncPath);
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Host benchmark: cost of Histogram::record / TSR_LATENCY_SCOPE from 1 and 4 threads sharing
+// one histogram, and the accuracy of its percentiles against the exact (sorted) ones for a
+// long-tailed, frame-latency-like distribution.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_metrics
+
+#include "metrics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Nanoseconds per call of fn(i), i in [0, count), run on `threads` threads at once
+double nsPerCall(const std::function<void(int)>& fn, int count, int threads) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < count; ++i) fn(i);
+        });
+    }
+    for (auto& w : workers) w.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / count;
+}
+
+void scoped() {
+    TSR_LATENCY_SCOPE("bench.scope");
+}
+
+} // namespace
+
+int main() {
+    const int count = 1000000;
+    Histogram& shared = Metrics::getInstance().histogram("bench.record");
+    for (int threads : {1, 4}) {
+        const double record = nsPerCall([&](int i) { shared.record(1000 + (i & 4095)); }, count, threads);
+        const double scope = nsPerCall([](int) { scoped(); }, count, threads);
+        std::cout << threads << " thread(s): record " << record << " ns  TSR_LATENCY_SCOPE " << scope << " ns"
+                  << std::endl;
+    }
+
+    // Frame times around 30 ms with a lognormal tail
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> dist(std::log(30e6), 0.35);
+    Histogram frames;
+    std::vector<int64_t> exact(200000);
+    for (auto& v : exact) {
+        v = (int64_t)dist(rng);
+        frames.record(v);
+    }
+    std::sort(exact.begin(), exact.end());
+    const LatencySummary s = frames.summarize();
+    auto at = [&](double q) { return exact[std::max<size_t>(1, (size_t)std::ceil(q * exact.size())) - 1]; };
+    const double qs[] = {0.5, 0.9, 0.99, 0.999};
+    const int64_t got[] = {s.p50, s.p90, s.p99, s.p999};
+    const char* names[] = {"p50", "p90", "p99", "p99.9"};
+    for (int i = 0; i < 4; ++i) {
+        std::cout << names[i] << ": exact " << at(qs[i]) * 1e-6 << " ms  histogram " << got[i] * 1e-6
+                  << " ms  rel err " << (double)(got[i] - at(qs[i])) / at(qs[i]) << std::endl;
+    }
+    std::cout << "max: exact " << exact.back() * 1e-6 << " ms  histogram " << s.max * 1e-6 << " ms" << std::endl;
+    return 0;
+}
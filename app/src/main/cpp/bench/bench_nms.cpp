@@ -0,0 +1,123 @@
+// Host benchmark: native NMS modes vs. the greedy O(n^2) AoS algorithm in
+// OnnxInferenceEngine.nms() (sort boxed rows, class-agnostic pairwise IoU).
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_nms
+
+#include "nms.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Row = std::array<float, 7>; // x1, y1, x2, y2, conf, classId, original index
+
+float iou(const Row& a, const Row& b) {
+    float interArea = std::max(0.0f, std::min(a[2], b[2]) - std::max(a[0], b[0])) *
+                      std::max(0.0f, std::min(a[3], b[3]) - std::max(a[1], b[1]));
+    float unionArea = (a[2] - a[0]) * (a[3] - a[1]) + (b[2] - b[0]) * (b[3] - b[1]) - interArea;
+    return unionArea <= 0.0f ? 0.0f : interArea / unionArea;
+}
+
+void referenceNms(std::vector<Row> detections, float threshold, std::vector<int>& keep) {
+    keep.clear();
+    std::stable_sort(detections.begin(), detections.end(), [](const Row& a, const Row& b) { return a[4] > b[4]; });
+    std::vector<bool> suppressed(detections.size());
+    for (size_t i = 0; i < detections.size(); ++i) {
+        if (suppressed[i]) continue;
+        keep.push_back((int)detections[i][6]);
+        for (size_t j = i + 1; j < detections.size(); ++j) {
+            if (!suppressed[j] && iou(detections[i], detections[j]) >= threshold) suppressed[j] = true;
+        }
+    }
+}
+
+// Scene of n / perObject signs, each surrounded by jittered duplicate anchors.
+// perObject = 40 is a cluttered low-threshold frame, 4 a scattered one.
+DetectionCandidates makeCandidates(int n, int perObject, std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(0.0f, 1800.0f), size(20.0f, 140.0f), unit(0.0f, 1.0f);
+    std::normal_distribution<float> jitter(0.0f, 6.0f);
+    const int objects = std::max(1, n / perObject);
+    std::vector<std::array<float, 4>> centres(objects);
+    for (auto& c : centres) c = {pos(rng), pos(rng) * 0.6f, size(rng), (float)(rng() % 51)};
+
+    DetectionCandidates out;
+    out.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const auto& c = centres[rng() % objects];
+        float cx = c[0] + jitter(rng), cy = c[1] + jitter(rng), s = c[2] * (1.0f + 0.05f * jitter(rng) / 6.0f);
+        int cls = unit(rng) < 0.9f ? (int)c[3] : (int)(rng() % 51);
+        out.push(cx - s / 2, cy - s / 2, cx + s / 2, cy + s / 2, 0.05f + 0.95f * unit(rng), cls);
+    }
+    return out;
+}
+
+template <typename F>
+double timeUs(F&& fn, int iters) {
+    fn();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iters;
+}
+
+} // namespace
+
+int main() {
+    const int counts[] = {1000, 5000, 10000};
+    std::mt19937 rng(3);
+    std::cout << "ISA: " << simd::isaName() << "\n";
+
+    for (int perObject : {40, 4})
+    for (int n : counts) {
+        DetectionCandidates boxes = makeCandidates(n, perObject, rng);
+        std::vector<Row> rows(n);
+        for (int i = 0; i < n; ++i) {
+            rows[i] = {boxes.x1[i], boxes.y1[i], boxes.x2[i], boxes.y2[i], boxes.score[i], (float)boxes.classId[i], (float)i};
+        }
+        const int iters = n >= 5000 ? 5 : 20;
+
+        std::vector<int> ref, keep;
+        double refUs = timeUs([&] { referenceNms(rows, 0.45f, ref); }, iters);
+
+        NmsConfig cfg;
+        cfg.maxDetections = n;
+        cfg.classAware = false;
+        cfg.gridMinCandidates = -1;
+        double allPairsUs = timeUs([&] { nonMaxSuppression(boxes, cfg, keep); }, iters);
+        bool allPairsMatch = keep == ref;
+
+        cfg.gridMinCandidates = 0;
+        double gridUs = timeUs([&] { nonMaxSuppression(boxes, cfg, keep); }, iters);
+        bool gridMatch = keep == ref;
+
+        // Batched per-class segments, all-pairs inside each class vs. grid inside each class
+        cfg.classAware = true;
+        cfg.gridMinCandidates = -1;
+        std::vector<int> perClass;
+        double classAwareUs = timeUs([&] { nonMaxSuppression(boxes, cfg, perClass); }, iters);
+        cfg.gridMinCandidates = 0;
+        nonMaxSuppression(boxes, cfg, keep);
+        bool classAwareMatch = keep == perClass;
+
+        NmsConfig soft;
+        soft.method = NmsMethod::SoftGaussian;
+        soft.scoreThreshold = 0.05f;
+        soft.maxDetections = 300;
+        DetectionCandidates softBoxes = boxes;
+        double softUs = timeUs([&] { softBoxes.score = boxes.score; nonMaxSuppression(softBoxes, soft, keep); }, iters);
+
+        std::cout << "n=" << n << " perObject=" << perObject << "  kept=" << ref.size()
+                  << "  reference: " << refUs << " us"
+                  << "  simd all-pairs: " << allPairsUs << " us (" << (allPairsMatch ? "MATCH" : "MISMATCH") << ")"
+                  << "  grid: " << gridUs << " us (" << (gridMatch ? "MATCH" : "MISMATCH") << ")"
+                  << "  class-aware: " << classAwareUs << " us (kept " << perClass.size()
+                  << ", grid " << (classAwareMatch ? "MATCH" : "MISMATCH") << ")"
+                  << "  soft-gaussian top-300: " << softUs << " us\n";
+    }
+    return 0;
+}
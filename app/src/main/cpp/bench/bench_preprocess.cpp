@@ -0,0 +1,102 @@
+// Host benchmark: fused native letterbox vs. a reference that mirrors the Kotlin
+// OnnxInferenceEngine.preprocess() path (scaled bitmap -> grey canvas -> per-pixel planarize).
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_preprocess
+
+#include "preprocess.hpp"
+#include "simd.hpp"
+#include "tensor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Reference: three full-size intermediate buffers, exactly like the Bitmap/Canvas/IntArray chain.
+void referencePreprocess(const std::vector<uint8_t>& rgba, int srcW, int srcH, std::vector<float>& out, int size) {
+    LetterboxInfo info = computeLetterbox(srcW, srcH, size, size);
+
+    std::vector<uint8_t> resized((size_t)info.newW * info.newH * 4);
+    for (int y = 0; y < info.newH; ++y) {
+        float sy = std::max(0.0f, (y + 0.5f) * srcH / info.newH - 0.5f);
+        int y0 = std::min((int)sy, srcH - 1), y1 = std::min(y0 + 1, srcH - 1);
+        float wy = sy - y0;
+        for (int x = 0; x < info.newW; ++x) {
+            float sx = std::max(0.0f, (x + 0.5f) * srcW / info.newW - 0.5f);
+            int x0 = std::min((int)sx, srcW - 1), x1 = std::min(x0 + 1, srcW - 1);
+            float wx = sx - x0;
+            for (int c = 0; c < 4; ++c) {
+                float a = rgba[((size_t)y0 * srcW + x0) * 4 + c], b = rgba[((size_t)y0 * srcW + x1) * 4 + c];
+                float d = rgba[((size_t)y1 * srcW + x0) * 4 + c], e = rgba[((size_t)y1 * srcW + x1) * 4 + c];
+                float top = a + wx * (b - a), bot = d + wx * (e - d);
+                resized[((size_t)y * info.newW + x) * 4 + c] = (uint8_t)std::lround(top + wy * (bot - top));
+            }
+        }
+    }
+
+    std::vector<uint8_t> canvas((size_t)size * size * 4, 114);
+    for (int y = 0; y < info.newH; ++y) {
+        std::copy(resized.begin() + (size_t)y * info.newW * 4, resized.begin() + (size_t)(y + 1) * info.newW * 4,
+                  canvas.begin() + ((size_t)(y + info.padY) * size + info.padX) * 4);
+    }
+
+    out.resize((size_t)3 * size * size);
+    const size_t plane = (size_t)size * size;
+    for (size_t i = 0; i < plane; ++i) {
+        out[i] = canvas[i * 4 + 0] / 255.0f;
+        out[plane + i] = canvas[i * 4 + 1] / 255.0f;
+        out[2 * plane + i] = canvas[i * 4 + 2] / 255.0f;
+    }
+}
+
+template <typename F>
+double timeUs(F&& fn, int iters) {
+    fn(); // warm caches and scratch buffers
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iters;
+}
+
+} // namespace
+
+int main() {
+    const int size = 640;
+    const int iters = 50;
+    const int sources[][2] = {{640, 480}, {1280, 720}, {1920, 1080}, {480, 640}};
+
+    std::cout << "ISA: " << simd::isaName() << "\n";
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    Tensor input({1, 3, size, size});
+    std::vector<float> ref;
+
+    for (const auto& s : sources) {
+        int w = s[0], h = s[1];
+        std::vector<uint8_t> rgba((size_t)w * h * 4);
+        for (auto& b : rgba) b = (uint8_t)dist(rng);
+
+        double refUs = timeUs([&] { referencePreprocess(rgba, w, h, ref, size); }, iters);
+        double nativeUs = timeUs([&] {
+            letterboxNormalize(rgba.data(), w, h, w * 4, PixelFormat::RGBA8888, input);
+        }, iters);
+
+        float maxErr = 0.0f;
+        for (size_t i = 0; i < ref.size(); ++i) {
+            maxErr = std::max(maxErr, std::fabs(ref[i] - input.data()[i]));
+        }
+
+        std::cout << w << "x" << h << " -> " << size << "x" << size
+                  << "  reference: " << refUs << " us"
+                  << "  native: " << nativeUs << " us"
+                  << "  speedup: " << refUs / nativeUs << "x"
+                  << "  max |diff|: " << maxErr << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+// Host benchmark: Tensor axis reductions against the scalar loops they replace (the per-anchor
+// class argmax of a YOLO head, a double-precision softmax like the Kotlin classifier's, plain
+// float accumulation), with the max error / mismatches against the scalar results.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_reduce
+
+#include "simd.hpp"
+#include "tensor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+double timeUs(const std::function<void()>& fn, int iters) {
+    double best = 1e30;
+    for (int i = 0; i < iters; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return best;
+}
+
+void report(const char* name, double tScalar, double tTensor, const std::string& check) {
+    std::cout << name << "\n  scalar: " << tScalar << " us  tensor: " << tTensor << " us  speedup: "
+              << tScalar / tTensor << "x  " << check << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "SIMD: " << simd::isaName() << std::endl;
+    std::mt19937 rng(9);
+    std::normal_distribution<float> dist(0.0f, 4.0f);
+
+    // YOLOv8 head: best class per anchor over axis 1 of [1, 4 + C, anchors]
+    const int classes = 43, anchors = 8400;
+    Tensor head({1, classes, anchors});
+    for (int i = 0; i < head.size(); ++i) head.data()[i] = dist(rng);
+    std::vector<float> bestClass(anchors);
+    auto scalarArgmax = [&] {
+        for (int a = 0; a < anchors; ++a) {
+            int best = 0;
+            for (int c = 1; c < classes; ++c) {
+                if (head.data()[c * anchors + a] > head.data()[best * anchors + a]) best = c;
+            }
+            bestClass[a] = (float)best;
+        }
+    };
+    scalarArgmax();
+    Tensor am = head.argmax(1);
+    int mismatches = 0;
+    for (int a = 0; a < anchors; ++a) mismatches += am.data()[a] != bestClass[a];
+    report("argmax [1,43,8400] axis 1", timeUs(scalarArgmax, 20), timeUs([&] { Tensor t = head.argmax(1); }, 20),
+           std::to_string(mismatches) + " mismatches");
+
+    // Classifier logits: softmax of [64, 43] rows through doubles versus Tensor::softmax
+    Tensor logits({64, classes});
+    for (int i = 0; i < logits.size(); ++i) logits.data()[i] = dist(rng);
+    std::vector<float> probs(logits.size());
+    auto scalarSoftmax = [&] {
+        for (int r = 0; r < 64; ++r) {
+            const float* x = logits.data() + r * classes;
+            float m = x[0];
+            for (int c = 1; c < classes; ++c) m = std::max(m, x[c]);
+            std::vector<float> e(classes);
+            float sum = 0.0f;
+            for (int c = 0; c < classes; ++c) sum += e[c] = (float)std::exp((double)(x[c] - m));
+            for (int c = 0; c < classes; ++c) probs[r * classes + c] = e[c] / sum;
+        }
+    };
+    scalarSoftmax();
+    Tensor sm = logits.softmax(-1);
+    double err = 0.0;
+    for (int i = 0; i < sm.size(); ++i) err = std::max(err, (double)std::fabs(sm.data()[i] - probs[i]));
+    report("softmax [64,43] axis -1", timeUs(scalarSoftmax, 50), timeUs([&] { Tensor t = logits.softmax(-1); }, 50),
+           "max abs err " + std::to_string(err));
+
+    // Channel softmax of a feature map (inner > 1 path)
+    Tensor map({1, 32, 80, 80});
+    for (int i = 0; i < map.size(); ++i) map.data()[i] = dist(rng);
+    const int C = 32, HW = 6400;
+    std::vector<float> mapRef(map.size());
+    auto scalarChannelSoftmax = [&] {
+        for (int p = 0; p < HW; ++p) {
+            float m = map.data()[p];
+            for (int c = 1; c < C; ++c) m = std::max(m, map.data()[c * HW + p]);
+            float sum = 0.0f;
+            for (int c = 0; c < C; ++c) sum += mapRef[c * HW + p] = std::exp(map.data()[c * HW + p] - m);
+            for (int c = 0; c < C; ++c) mapRef[c * HW + p] /= sum;
+        }
+    };
+    scalarChannelSoftmax();
+    Tensor cs = map.softmax(1);
+    err = 0.0;
+    for (int i = 0; i < cs.size(); ++i) err = std::max(err, (double)std::fabs(cs.data()[i] - mapRef[i]));
+    report("softmax [1,32,80,80] axis 1", timeUs(scalarChannelSoftmax, 20), timeUs([&] { Tensor t = map.softmax(1); }, 20),
+           "max abs err " + std::to_string(err));
+
+    // Global sum of 4M floats: naive float accumulation versus pairwise and Kahan
+    Tensor flat({1 << 22});
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int i = 0; i < flat.size(); ++i) flat.data()[i] = unit(rng);
+    double exact = 0.0;
+    for (int i = 0; i < flat.size(); ++i) exact += flat.data()[i];
+    float naive = 0.0f;
+    auto scalarSum = [&] {
+        naive = 0.0f;
+        for (int i = 0; i < flat.size(); ++i) naive += flat.data()[i];
+    };
+    scalarSum();
+    const float pairwise = flat.sum(0).data()[0];
+    const float kahan = flat.sum(0, false, reduce::Summation::Kahan).data()[0];
+    report("sum [4194304] pairwise", timeUs(scalarSum, 10), timeUs([&] { Tensor t = flat.sum(0); }, 10),
+           "rel err naive " + std::to_string(std::fabs(naive - exact) / exact) + " pairwise " +
+           std::to_string(std::fabs(pairwise - exact) / exact) + " kahan " + std::to_string(std::fabs(kahan - exact) / exact));
+    report("sum [4194304] kahan", timeUs(scalarSum, 10),
+           timeUs([&] { Tensor t = flat.sum(0, false, reduce::Summation::Kahan); }, 10), "");
+
+    Tensor values, indices;
+    head.topK(5, 1, values, indices);
+    const double tArgmax = timeUs([&] { Tensor t = head.argmax(1); }, 20);
+    const double tTopK = timeUs([&] { head.topK(5, 1, values, indices); }, 20);
+    std::cout << "topK 5 [1,43,8400] axis 1\n  topK: " << tTopK << " us  (argmax: " << tArgmax << " us)  top-1 "
+              << (std::equal(bestClass.begin(), bestClass.end(), indices.data()) ? "matches argmax" : "DIFFERS") << std::endl;
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Host benchmark: ThreadPool scaling for elementwise Tensor ops on the [4, 3, 512, 512]
+// workload from main.cpp, from 1 thread up to hardware_concurrency(). Every thread count
+// must reproduce the single-threaded result exactly (chunks only change who runs a range).
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_threads
+
+#include "tensor.hpp"
+#include "tensor_expr.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace {
+
+double timeUs(const std::function<void()>& fn, int iters) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; ++i) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iters;
+}
+
+bool sameBits(const Tensor& a, const Tensor& b) {
+    return std::memcmp(a.data(), b.data(), sizeof(float) * a.size()) == 0;
+}
+
+struct Case {
+    const char* name;
+    std::function<void(Tensor&)> op;
+    Tensor reference;
+};
+
+} // namespace
+
+int main() {
+    const int maxThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "hardware_concurrency: " << maxThreads << std::endl;
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+    Tensor input({4, 3, 512, 512});
+    Tensor other({4, 3, 512, 512});
+    for (int i = 0; i < input.size(); ++i) {
+        input.data()[i] = dist(rng);
+        other.data()[i] = dist(rng);
+    }
+    Tensor bias({3});
+    bias.data()[0] = 0.1f;
+    bias.data()[1] = -0.2f;
+    bias.data()[2] = 0.3f;
+
+    std::vector<Case> cases;
+    cases.push_back({"addTensor", [&](Tensor& t) { t.addTensor(other); }, Tensor()});
+    cases.push_back({"sigmoid", [&](Tensor& t) { t.sigmoid(); }, Tensor()});
+    cases.push_back({"addBias", [&](Tensor& t) { t.addBias(bias); }, Tensor()});
+    cases.push_back({"expr mul+bias+tanh", [&](Tensor& t) { t.expr().mul(2.0f).addBias(bias).tanh().eval(); },
+                     Tensor()});
+
+    ThreadPool::getInstance().configure(1);
+    for (Case& c : cases) {
+        c.reference = input.clone();
+        c.op(c.reference);
+    }
+
+    const int iters = 10;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool::getInstance().configure(threads);
+        std::cout << "threads: " << threads << std::endl;
+        Tensor work = input.clone();
+        const double tCopy = timeUs([&] { std::memcpy(work.data(), input.data(), sizeof(float) * input.size()); },
+                                    iters);
+        for (Case& c : cases) {
+            std::memcpy(work.data(), input.data(), sizeof(float) * input.size());
+            c.op(work);
+            const bool match = sameBits(work, c.reference);
+            const double t = timeUs([&] {
+                std::memcpy(work.data(), input.data(), sizeof(float) * input.size());
+                c.op(work);
+            }, iters) - tCopy;
+            std::cout << "  " << c.name << ": " << t << " us  " << (match ? "MATCH" : "MISMATCH") << std::endl;
+        }
+        if (threads < maxThreads && threads * 2 > maxThreads) threads = maxThreads / 2;
+    }
+    return 0;
+}
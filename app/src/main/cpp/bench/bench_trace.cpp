@@ -0,0 +1,90 @@
+// Host benchmark: cost of TSR_TRACE_SCOPE with recording off (what production builds pay) and
+// on, from 1 and 4 threads, and of exporting the spans. Then traces a few frames of decode +
+// NMS on a synthetic YOLOv8 head and writes them to bench_trace.json for chrome://tracing or
+// ui.perfetto.dev.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target bench_trace
+
+#include "nms.hpp"
+#include "trace.hpp"
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Nanoseconds per call of fn(), `count` calls on each of `threads` threads at once
+double nsPerCall(const std::function<void()>& fn, int count, int threads) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < count; ++i) fn();
+        });
+    }
+    for (auto& w : workers) w.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / count;
+}
+
+volatile int sink = 0;
+
+void tracedWork() {
+    TSR_TRACE_SCOPE("span");
+    sink = sink + 1;
+}
+
+void untracedWork() {
+    sink = sink + 1;
+}
+
+} // namespace
+
+int main() {
+    const int count = 1000000;
+    for (int threads : {1, 4}) {
+        std::cout << "scope x " << count << " on " << threads << " thread(s)" << std::endl;
+        const double base = nsPerCall(untracedWork, count, threads);
+        const double off = nsPerCall(tracedWork, count, threads);
+        trace::start();
+        const double on = nsPerCall(tracedWork, count, threads);
+        trace::stop();
+        auto start = std::chrono::high_resolution_clock::now();
+        const size_t bytes = trace::exportChromeJson().size();
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "  no scope: " << base << " ns  recording off: " << off << " ns  recording on: " << on
+                  << " ns  export: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms ("
+                  << bytes / (1 << 20) << " MB)" << std::endl;
+    }
+
+    // Sample capture: decode + NMS over a [1, 4 + 43, 8400] head with a few confident anchors
+    const int classes = 43, anchors = 8400;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<float> head((size_t)(4 + classes) * anchors);
+    for (int a = 0; a < anchors; ++a) {
+        head[a] = 640.0f * unit(rng);
+        head[anchors + a] = 640.0f * unit(rng);
+        head[2 * anchors + a] = 20.0f + 60.0f * unit(rng);
+        head[3 * anchors + a] = 20.0f + 60.0f * unit(rng);
+        for (int c = 0; c < classes; ++c) head[(size_t)(4 + c) * anchors + a] = unit(rng) < 0.02f ? unit(rng) : 0.0f;
+    }
+    LetterboxInfo letterbox;
+    NmsConfig config;
+    DetectionCandidates candidates;
+    std::vector<int> keep;
+
+    trace::start();
+    for (int frame = 0; frame < 10; ++frame) {
+        TSR_TRACE_SCOPE("frame");
+        decodeYolo(head.data(), classes, anchors, 0.25f, letterbox, candidates);
+        nonMaxSuppression(candidates, config, keep);
+    }
+    trace::stop();
+    std::cout << "10 frames of decode + NMS -> bench_trace.json: "
+              << (trace::writeChromeJson("bench_trace.json") ? "written" : "FAILED") << std::endl;
+    return 0;
+}
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Compare two tsr_bench JSON files case by case.
+
+usage: compare_bench.py BASELINE.json CANDIDATE.json [--threshold 0.10]
+
+Prints the median time of every case present in both files and the change. Exits 1 when any
+case is slower by more than the threshold (relative, default 10%) and the slowdown is larger
+than both runs' standard deviations, so noisy cases do not fail a run on their own.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data, {(r["name"], r["shape"]): r for r in data["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("candidate")
+    parser.add_argument("--threshold", type=float, default=0.10)
+    args = parser.parse_args()
+
+    base_meta, base = load(args.baseline)
+    cand_meta, cand = load(args.candidate)
+    for key in ("isa", "native_arch", "threads"):
+        if base_meta.get(key) != cand_meta.get(key):
+            print(f"warning: {key} differs ({base_meta.get(key)} vs {cand_meta.get(key)})")
+
+    regressions = 0
+    print(f"{'case':<22} {'shape':<20} {'base us':>10} {'new us':>10} {'change':>8}")
+    for key, b in base.items():
+        c = cand.get(key)
+        if c is None:
+            continue
+        change = c["median_us"] / b["median_us"] - 1.0 if b["median_us"] > 0 else 0.0
+        noise = max(b["stddev_us"], c["stddev_us"])
+        regressed = change > args.threshold and c["median_us"] - b["median_us"] > noise
+        regressions += regressed
+        print(f"{key[0]:<22} {key[1]:<20} {b['median_us']:>10.2f} {c['median_us']:>10.2f} "
+              f"{change * 100:>+7.1f}%{'  REGRESSION' if regressed else ''}")
+
+    missing = len(set(base) - set(cand))
+    if missing:
+        print(f"{missing} baseline case(s) not in the candidate (--filter run?)")
+    print(f"{regressions} regression(s) over {args.threshold * 100:.0f}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,164 @@
+#ifndef TRAFFIC_SIGN_DETECTION_BENCH_HARNESS_HPP
+#define TRAFFIC_SIGN_DETECTION_BENCH_HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Minimal benchmark runner for tsr_bench. Every case is warmed up, then timed `reps` times;
+// each repetition runs the case enough times back to back (at least ~200 us) that timer
+// resolution does not matter, and reports the per-call time. Results are printed as a table
+// and written as JSON for compare_bench.py.
+//
+// Flags: --json PATH (default tsr_bench.json), --filter SUBSTRING, --reps N (default 20),
+//        --warmup N (default 3), --threads N (ThreadPool size, caller included)
+namespace bench {
+
+struct Options {
+    std::string jsonPath = "tsr_bench.json";
+    std::string filter;
+    int reps = 20;
+    int warmup = 3;
+    int threads = 0; // 0 = leave the pool as configured
+};
+
+inline Options parseOptions(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--json") == 0 && hasValue) o.jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--filter") == 0 && hasValue) o.filter = argv[++i];
+        else if (std::strcmp(argv[i], "--reps") == 0 && hasValue) o.reps = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue) o.warmup = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) o.threads = std::atoi(argv[++i]);
+        else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--json PATH] [--filter SUBSTRING] [--reps N] [--warmup N] [--threads N]" << std::endl;
+            std::exit(2);
+        }
+    }
+    return o;
+}
+
+struct Result {
+    std::string name;
+    std::string shape;
+    int reps = 0;
+    int iters = 0; // calls per repetition
+    double minUs = 0.0;
+    double medianUs = 0.0;
+    double meanUs = 0.0;
+    double stddevUs = 0.0;
+    double gbps = 0.0;   // bytes / median time, 0 when not meaningful
+    double gflops = 0.0; // flops / median time, 0 when not meaningful
+};
+
+class Harness {
+public:
+    explicit Harness(const Options& options) : options(options) {}
+
+    // Times fn(). `bytes` and `flops` are per call (0 = not reported). `setup`, when given,
+    // runs untimed before every repetition, e.g. to restore an input that fn() overwrites.
+    void run(const std::string& name, const std::string& shape, double bytes, double flops,
+             const std::function<void()>& fn, const std::function<void()>& setup = nullptr) {
+        if (!options.filter.empty() && (name + " " + shape).find(options.filter) == std::string::npos) return;
+
+        for (int i = 0; i < options.warmup; ++i) {
+            if (setup) setup();
+            fn();
+        }
+        // Calls per repetition so that one repetition takes ~200 us
+        if (setup) setup();
+        const double once = std::max(timeUs(fn, 1), 0.01);
+        const int iters = std::max(1, std::min(100000, (int)(200.0 / once)));
+
+        std::vector<double> samples(options.reps);
+        for (double& s : samples) {
+            if (setup) setup();
+            s = timeUs(fn, iters) / iters;
+        }
+        std::sort(samples.begin(), samples.end());
+
+        Result r;
+        r.name = name;
+        r.shape = shape;
+        r.reps = options.reps;
+        r.iters = iters;
+        r.minUs = samples.front();
+        r.medianUs = samples.size() % 2 == 1 ? samples[samples.size() / 2]
+                                              : 0.5 * (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]);
+        double sum = 0.0;
+        for (double s : samples) sum += s;
+        r.meanUs = sum / samples.size();
+        double var = 0.0;
+        for (double s : samples) var += (s - r.meanUs) * (s - r.meanUs);
+        r.stddevUs = samples.size() > 1 ? std::sqrt(var / (samples.size() - 1)) : 0.0;
+        r.gbps = bytes > 0.0 ? bytes / (r.medianUs * 1e3) : 0.0;
+        r.gflops = flops > 0.0 ? flops / (r.medianUs * 1e3) : 0.0;
+        results.push_back(r);
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-22s %-20s %10.2f %10.2f %8.2f %8.2f %8.2f", name.c_str(), shape.c_str(),
+                      r.minUs, r.medianUs, r.stddevUs, r.gbps, r.gflops);
+        std::cout << line << std::endl;
+    }
+
+    void printHeader() const {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-22s %-20s %10s %10s %8s %8s %8s", "case", "shape", "min us", "median us",
+                      "stddev", "GB/s", "GFLOP/s");
+        std::cout << line << std::endl;
+    }
+
+    // Writes the JSON file; returns the process exit code
+    int finish(const std::string& isa, int threads) const {
+        std::ofstream out(options.jsonPath, std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Failed to write " << options.jsonPath << std::endl;
+            return 1;
+        }
+#ifdef TSR_NATIVE_ARCH
+        const bool nativeArch = true; // -march=native: numbers only compare with builds for the same host
+#else
+        const bool nativeArch = false;
+#endif
+        out << "{\n  \"isa\": \"" << isa << "\",\n  \"native_arch\": " << (nativeArch ? "true" : "false")
+            << ",\n  \"threads\": " << threads << ",\n  \"reps\": " << options.reps << ",\n  \"results\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            char buf[512];
+            std::snprintf(buf, sizeof(buf),
+                          "%s\n    {\"name\": \"%s\", \"shape\": \"%s\", \"reps\": %d, \"iters\": %d, \"min_us\": %.3f, "
+                          "\"median_us\": %.3f, \"mean_us\": %.3f, \"stddev_us\": %.3f, \"gbps\": %.3f, \"gflops\": %.3f}",
+                          i > 0 ? "," : "", r.name.c_str(), r.shape.c_str(), r.reps, r.iters, r.minUs, r.medianUs,
+                          r.meanUs, r.stddevUs, r.gbps, r.gflops);
+            out << buf;
+        }
+        out << "\n  ]\n}\n";
+        std::cout << results.size() << " results written to " << options.jsonPath << std::endl;
+        return 0;
+    }
+
+private:
+    static double timeUs(const std::function<void()>& fn, int iters) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iters; ++i) fn();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count();
+    }
+
+    Options options;
+    std::vector<Result> results;
+};
+
+} // namespace bench
+
+#endif //TRAFFIC_SIGN_DETECTION_BENCH_HARNESS_HPP
@@ -0,0 +1,245 @@
+// Benchmark sweep over the native core: Tensor elementwise / broadcast / bias / layout / copy
+// ops, FP16 / INT8 conversions and INT8 kernels, matmul, reductions, conv and pooling layers,
+// preprocessing, YOLO decode and NMS, each across a few shapes typical of the detector (640x640
+// input, 80/40/20 feature maps) and the cascade classifiers. See harness.hpp for the method and
+// flags; compare two JSON outputs with bench/compare_bench.py.
+//
+// Built by the host CMake build (see CMakeLists.txt): cmake --build build --target tsr_bench
+
+#include "harness.hpp"
+#include "layers.hpp"
+#include "nms.hpp"
+#include "preprocess.hpp"
+#include "simd.hpp"
+#include "tensor.hpp"
+#include "tensor_expr.hpp"
+#include "thread_pool.hpp"
+#include <random>
+
+namespace {
+
+std::mt19937 rng(42);
+
+std::string shapeName(const std::vector<int>& shape) {
+    std::string s;
+    for (size_t i = 0; i < shape.size(); ++i) s += (i > 0 ? "x" : "") + std::to_string(shape[i]);
+    return s;
+}
+
+double elements(const std::vector<int>& shape) {
+    double n = 1.0;
+    for (int d : shape) n *= d;
+    return n;
+}
+
+Tensor randomTensor(const std::vector<int>& shape, float lo = 0.5f, float hi = 2.0f) {
+    std::uniform_real_distribution<float> dist(lo, hi);
+    Tensor t(shape);
+    for (int i = 0; i < t.size(); ++i) t.data()[i] = dist(rng);
+    return t;
+}
+
+// In-place ops get a fresh copy of the input before every repetition
+void elementwise(bench::Harness& h, const std::vector<int>& shape) {
+    const std::string s = shapeName(shape);
+    const double n = elements(shape), f = sizeof(float);
+    const Tensor source = randomTensor(shape);
+    const Tensor other = randomTensor(shape);
+    const Tensor bias = randomTensor({shape[1]});
+    const Tensor channel = randomTensor({shape[1], 1, 1});
+    Tensor x;
+    auto reset = [&] { x = source.clone(); };
+
+    h.run("fill", s, n * f, 0.0, [&] { x.fill(1.0f); }, reset);
+    h.run("addScalar", s, 2 * n * f, n, [&] { x.addScalar(1.0f); }, reset);
+    h.run("multiplyScalar", s, 2 * n * f, n, [&] { x.multiplyScalar(1.0f); }, reset);
+    h.run("addTensor", s, 3 * n * f, n, [&] { x.addTensor(other); }, reset);
+    h.run("multiplyTensor", s, 3 * n * f, n, [&] { x.multiplyTensor(other); }, reset);
+    h.run("divideTensor", s, 3 * n * f, n, [&] { x.divideTensor(other); }, reset);
+    h.run("multiplyTensor bcast", s, 2 * n * f, n, [&] { x.multiplyTensor(channel); }, reset);
+    h.run("Tensor::add", s, 3 * n * f, n, [&] { Tensor r = Tensor::add(source, other); });
+    h.run("addBias", s, 2 * n * f, n, [&] { x.addBias(bias); }, reset);
+    h.run("channelAffine", s, 2 * n * f, 2 * n, [&] { x.channelAffine(bias, bias); }, reset);
+    h.run("ReLU", s, 2 * n * f, n, [&] { x.ReLU(); }, reset);
+    h.run("sigmoid", s, 2 * n * f, 0.0, [&] { x.sigmoid(); }, reset);
+    h.run("exp", s, 2 * n * f, 0.0, [&] { x.exp(); }, reset);
+    h.run("expr mul+bias+relu", s, 2 * n * f, 3 * n,
+          [&] { x.expr().mul(1.0f).addBias(bias).relu().eval(); }, reset);
+}
+
+void layoutAndCopy(bench::Harness& h, const std::vector<int>& shape) {
+    const std::string s = shapeName(shape);
+    const double bytes = 2 * elements(shape) * sizeof(float);
+    const Tensor x = randomTensor(shape);
+    const Tensor nhwc = x.toMemoryFormat(MemoryFormat::NHWC);
+
+    h.run("clone", s, bytes, 0.0, [&] { Tensor r = x.clone(); });
+    h.run("transpose copy", s, bytes, 0.0, [&] {
+        Tensor v = x.clone();
+        v.transpose({0, 2, 3, 1});
+        v.makeContiguous();
+    });
+    h.run("toMemoryFormat NHWC", s, bytes, 0.0, [&] { Tensor r = x.toMemoryFormat(MemoryFormat::NHWC); });
+    h.run("toMemoryFormat NCHW", s, bytes, 0.0, [&] { Tensor r = nhwc.toMemoryFormat(MemoryFormat::NCHW); });
+    h.run("toMemoryFormat c8", s, bytes, 0.0, [&] { Tensor r = x.toMemoryFormat(MemoryFormat::NCHWc8); });
+}
+
+// FP32 <-> FP16 / INT8 conversions and the INT8 kernels against their FP32 counterparts above
+void quantized(bench::Harness& h, const std::vector<int>& shape) {
+    const std::string s = shapeName(shape);
+    const double n = elements(shape), f = sizeof(float);
+    const Tensor x = randomTensor(shape, -2.0f, 2.0f);
+    const Tensor bias = randomTensor({shape[1]}, -0.5f, 0.5f);
+    const Tensor half = x.toDType(DType::FP16);
+    const Tensor source = x.toDType(DType::INT8);
+    const Tensor perChannel = x.toDType(DType::INT8, x.calibrate(1));
+    const Tensor other = randomTensor(shape, -2.0f, 2.0f).toDType(DType::INT8);
+    Tensor q;
+    auto reset = [&] { q = source.clone(); };
+
+    h.run("toDType FP16", s, n * (f + 2), 0.0, [&] { Tensor r = x.toDType(DType::FP16); });
+    h.run("toDType FP32 from FP16", s, n * (2 + f), 0.0, [&] { Tensor r = half.toDType(DType::FP32); });
+    h.run("quantize", s, n * (f + 1), 2 * n, [&] { Tensor r = x.toDType(DType::INT8, source.getQuantParams()); });
+    h.run("quantize per-channel", s, n * (f + 1), 2 * n, [&] { Tensor r = x.toDType(DType::INT8, perChannel.getQuantParams()); });
+    h.run("dequantize", s, n * (1 + f), 2 * n, [&] { Tensor r = source.toDType(DType::FP32); });
+    h.run("calibrate", s, n * f, 0.0, [&] { QuantParams p = x.calibrate(); });
+    h.run("addTensor INT8", s, 3 * n, 4 * n, [&] { q.addTensor(other); }, reset);
+    h.run("addBias INT8", s, 2 * n, n, [&] { q.addBias(bias); }, reset);
+    h.run("ReLU INT8", s, 2 * n, n, [&] { q.ReLU(); }, reset);
+}
+
+void matmul(bench::Harness& h, int m, int n, int k) {
+    const Tensor a = randomTensor({m, k});
+    const Tensor b = randomTensor({k, n});
+    h.run("matmul", std::to_string(m) + "x" + std::to_string(n) + "x" + std::to_string(k),
+          ((double)m * k + (double)k * n + (double)m * n) * sizeof(float), 2.0 * m * n * k,
+          [&] { Tensor c = a.matmul(b); });
+}
+
+void reductions(bench::Harness& h, const std::vector<int>& shape, int axis) {
+    const std::string s = shapeName(shape) + " axis " + std::to_string(axis);
+    const double n = elements(shape), bytes = n * sizeof(float);
+    const Tensor x = randomTensor(shape, -4.0f, 4.0f);
+    Tensor values, indices;
+
+    h.run("sum", s, bytes, n, [&] { Tensor r = x.sum(axis); });
+    h.run("max", s, bytes, n, [&] { Tensor r = x.max(axis); });
+    h.run("argmax", s, bytes, n, [&] { Tensor r = x.argmax(axis); });
+    h.run("softmax", s, 2 * bytes, 0.0, [&] { Tensor r = x.softmax(axis); });
+    h.run("topK 5", s, bytes, 0.0, [&] { x.topK(5, axis, values, indices); });
+}
+
+void conv(bench::Harness& h, const char* name, const std::vector<int>& input, const std::vector<int>& weight,
+          int stride, int pad, int groups) {
+    const Tensor x = randomTensor(input, -1.0f, 1.0f);
+    const Tensor w = randomTensor(weight, -0.1f, 0.1f);
+    const Tensor b = randomTensor({weight[0]}, -0.1f, 0.1f);
+    Conv2dParams p;
+    p.strideH = p.strideW = stride;
+    p.padH = p.padW = pad;
+    p.groups = groups;
+    p.activation = Activation::ReLU;
+    const int outH = convOutputSize(input[2], weight[2], stride, pad);
+    const int outW = convOutputSize(input[3], weight[3], stride, pad);
+    const double flops = 2.0 * input[0] * weight[0] * outH * outW * weight[1] * weight[2] * weight[3];
+    const double bytes = (elements(input) + elements(weight) + (double)input[0] * weight[0] * outH * outW) * sizeof(float);
+    h.run(name, shapeName(input) + " k" + std::to_string(weight[2]) + " s" + std::to_string(stride), bytes, flops,
+          [&] { Tensor y = conv2d(x, w, &b, p); });
+}
+
+void pooling(bench::Harness& h, const std::vector<int>& shape) {
+    const std::string s = shapeName(shape);
+    const Tensor x = randomTensor(shape);
+    Pool2dParams p;
+    h.run("maxPool2d 2x2", s, 1.25 * elements(shape) * sizeof(float), 0.0, [&] { Tensor y = maxPool2d(x, p); });
+    h.run("globalAvgPool", s, elements(shape) * sizeof(float), elements(shape), [&] { Tensor y = globalAvgPool(x); });
+}
+
+void preprocess(bench::Harness& h, int srcW, int srcH) {
+    const std::string s = std::to_string(srcW) + "x" + std::to_string(srcH) + " -> 640";
+    std::vector<uint8_t> rgba((size_t)srcW * srcH * 4);
+    for (auto& v : rgba) v = (uint8_t)(rng() & 255);
+    Tensor input({1, 3, 640, 640});
+    h.run("letterboxNormalize", s, rgba.size() + 3.0 * 640 * 640 * sizeof(float), 0.0,
+          [&] { letterboxNormalize(rgba.data(), srcW, srcH, srcW * 4, PixelFormat::RGBA8888, input); });
+
+    std::vector<uint8_t> yPlane((size_t)srcW * srcH), uvPlane((size_t)srcW * srcH / 2);
+    for (auto& v : yPlane) v = (uint8_t)(rng() & 255);
+    for (auto& v : uvPlane) v = (uint8_t)(rng() & 255);
+    Yuv420Frame frame;
+    frame.y = yPlane.data();
+    frame.u = uvPlane.data();
+    frame.v = uvPlane.data() + 1;
+    frame.width = srcW;
+    frame.height = srcH;
+    frame.yRowStride = srcW;
+    frame.uvRowStride = srcW;
+    frame.uvPixelStride = 2; // NV12
+    std::vector<uint8_t> out((size_t)srcW * srcH * 4);
+    h.run("yuv420ToRgba rot90", std::to_string(srcW) + "x" + std::to_string(srcH), 5.5 * srcW * srcH, 0.0,
+          [&] { yuv420ToRgba(frame, 90, out.data(), srcH * 4); });
+}
+
+// YOLOv8 head [1, 4 + classes, anchors] with ~1% of anchors above the threshold
+void decodeAndNms(bench::Harness& h, int classes, int anchors) {
+    const std::string s = std::to_string(4 + classes) + "x" + std::to_string(anchors);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<float> head((size_t)(4 + classes) * anchors, 0.0f);
+    for (int a = 0; a < anchors; ++a) {
+        head[a] = 640.0f * unit(rng);
+        head[anchors + a] = 640.0f * unit(rng);
+        head[2 * anchors + a] = 20.0f + 80.0f * unit(rng);
+        head[3 * anchors + a] = 20.0f + 80.0f * unit(rng);
+        for (int c = 0; c < classes; ++c) head[(size_t)(4 + c) * anchors + a] = 0.2f * unit(rng);
+        if (unit(rng) < 0.01f) head[(size_t)(4 + rng() % classes) * anchors + a] = 0.3f + 0.7f * unit(rng);
+    }
+    LetterboxInfo letterbox;
+    DetectionCandidates candidates;
+    h.run("decodeYolo", s, head.size() * sizeof(float), 0.0,
+          [&] { decodeYolo(head.data(), classes, anchors, 0.25f, letterbox, candidates); });
+
+    // NMS over a decode at a threshold just under the background peak: ~1-2k overlapping boxes
+    decodeYolo(head.data(), classes, anchors, 0.199f, letterbox, candidates);
+    const DetectionCandidates source = candidates;
+    NmsConfig config;
+    std::vector<int> keep;
+    h.run("nonMaxSuppression", std::to_string(source.size()) + " boxes", 0.0, 0.0,
+          [&] { nonMaxSuppression(candidates, config, keep); }, [&] { candidates = source; });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const bench::Options options = bench::parseOptions(argc, argv);
+    if (options.threads > 0) ThreadPool::getInstance().configure(options.threads);
+    const int threads = ThreadPool::getInstance().getThreadCount();
+    std::cout << "SIMD: " << simd::isaName() << "  threads: " << threads << std::endl;
+
+    bench::Harness h(options);
+    h.printHeader();
+    for (const std::vector<int>& shape : std::vector<std::vector<int>>{{1, 3, 640, 640}, {1, 32, 160, 160}, {1, 64, 80, 80}, {1, 256, 20, 20}}) {
+        elementwise(h, shape);
+    }
+    for (const std::vector<int>& shape : std::vector<std::vector<int>>{{1, 3, 640, 640}, {1, 64, 80, 80}}) {
+        layoutAndCopy(h, shape);
+    }
+    for (const std::vector<int>& shape : std::vector<std::vector<int>>{{1, 3, 640, 640}, {1, 64, 80, 80}}) {
+        quantized(h, shape);
+    }
+    for (int size : {64, 256, 512}) matmul(h, size, size, size);
+    matmul(h, 6400, 64, 576); // im2col GEMM of a 3x3x64 conv on 80x80
+    reductions(h, {1, 47, 8400}, 1);
+    reductions(h, {64, 43}, 1);
+    reductions(h, {1, 32, 80, 80}, 1);
+    conv(h, "conv2d", {1, 3, 224, 224}, {16, 3, 3, 3}, 2, 1, 1);
+    conv(h, "conv2d", {1, 64, 80, 80}, {64, 64, 3, 3}, 1, 1, 1);
+    conv(h, "conv2d 1x1", {1, 64, 80, 80}, {128, 64, 1, 1}, 1, 0, 1);
+    conv(h, "conv2d depthwise", {1, 96, 56, 56}, {96, 1, 3, 3}, 1, 1, 96);
+    pooling(h, {1, 64, 80, 80});
+    pooling(h, {1, 576, 7, 7});
+    preprocess(h, 1280, 720);
+    preprocess(h, 1920, 1080);
+    decodeAndNms(h, 43, 8400);
+    decodeAndNms(h, 80, 8400);
+    return h.finish(simd::isaName(), threads);
+}
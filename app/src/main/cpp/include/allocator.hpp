@@ -0,0 +1,140 @@
+#ifndef TRAFFIC_SIGN_DETECTION_ALLOCATOR_HPP
+#define TRAFFIC_SIGN_DETECTION_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+struct AllocatorStats {
+    size_t hits = 0;           // requests served from memory the allocator already held
+    size_t misses = 0;         // requests that had to go to the system allocator
+    size_t bytesInUse = 0;     // handed out and not yet returned (arena: bytes bumped since reset)
+    size_t highWaterBytes = 0; // peak bytesInUse
+    size_t reservedBytes = 0;  // obtained from the system and currently held
+};
+
+// Backing memory for tensor Storage. Blocks are 64-byte aligned so SIMD loads never split a
+// cache line at the start of a buffer. An allocator must outlive every Storage it served.
+class Allocator {
+public:
+    virtual ~Allocator() = default;
+    virtual float* allocate(size_t n) = 0;
+    virtual void deallocate(float* p, size_t n) = 0;
+    virtual AllocatorStats stats() const = 0;
+    virtual const char* name() const = 0;
+};
+
+// Straight to the system allocator on every call; the process-wide default.
+class HeapAllocator : public Allocator {
+public:
+    float* allocate(size_t n) override;
+    void deallocate(float* p, size_t n) override;
+    AllocatorStats stats() const override;
+    const char* name() const override { return "heap"; }
+
+private:
+    mutable std::mutex mtx;
+    AllocatorStats counters;
+};
+
+// Power-of-two size buckets with per-bucket free lists. Freed blocks are kept for reuse, so once
+// every tensor shape of a frame has been seen, later frames are served entirely from the lists.
+// Thread-safe.
+class PoolAllocator : public Allocator {
+public:
+    PoolAllocator() = default;
+    ~PoolAllocator() override;
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    float* allocate(size_t n) override;
+    void deallocate(float* p, size_t n) override;
+    AllocatorStats stats() const override;
+    const char* name() const override { return "pool"; }
+
+    // Returns every cached (free) block to the system
+    void trim();
+
+private:
+    static constexpr int kNumBuckets = 40;
+
+    mutable std::mutex mtx;
+    std::vector<float*> freeLists[kNumBuckets];
+    AllocatorStats counters;
+};
+
+// Per-frame bump allocator: allocate() advances a pointer, deallocate() only counts, and reset()
+// rewinds everything in one shot once the frame's tensors are gone. A frame that outgrows the
+// current chunk chains another one; the next reset() folds them into a single chunk of the total
+// size, so the steady state is one chunk and no system calls. Not thread-safe: one arena per
+// thread (typically the camera/inference thread).
+class ArenaAllocator : public Allocator {
+public:
+    explicit ArenaAllocator(size_t initialBytes = 0);
+    ~ArenaAllocator() override;
+    ArenaAllocator(const ArenaAllocator&) = delete;
+    ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+    float* allocate(size_t n) override;
+    void deallocate(float* p, size_t n) override;
+    AllocatorStats stats() const override;
+    const char* name() const override { return "arena"; }
+
+    // Every tensor allocated since the last reset must already be destroyed
+    void reset();
+
+private:
+    struct Chunk {
+        char* base;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t used = 0; // bytes bumped in chunks.back()
+    size_t liveBlocks = 0;
+    AllocatorStats counters;
+
+    void addChunk(size_t bytes);
+};
+
+// Allocator used by Storage::allocate on the calling thread: the innermost AllocatorScope, else
+// the process default
+Allocator& currentAllocator();
+
+// Process default for threads outside any AllocatorScope (null restores the HeapAllocator), e.g.
+// a PoolAllocator for the tensors that outlive a frame. Install it once at startup; it must
+// outlive every tensor it serves.
+void setDefaultAllocator(Allocator* allocator);
+
+// Routes this thread's tensor allocations to `allocator` for the scope's lifetime:
+//   ArenaAllocator arena;
+//   { AllocatorScope scope(arena); runFrame(); }
+//   arena.reset();
+class AllocatorScope {
+public:
+    explicit AllocatorScope(Allocator& allocator);
+    ~AllocatorScope();
+    AllocatorScope(const AllocatorScope&) = delete;
+    AllocatorScope& operator=(const AllocatorScope&) = delete;
+
+private:
+    Allocator* previous;
+};
+
+// One frame on this thread: tensors allocated in the scope come from `arena`, which is reset
+// when the scope ends, so every tensor of the frame must be gone by then:
+//   static thread_local ArenaAllocator arena;
+//   { FrameAllocatorScope frame(arena); Tensor x = ...; runFrame(x); }
+class FrameAllocatorScope {
+public:
+    explicit FrameAllocatorScope(ArenaAllocator& arena) : arena(arena), scope(arena) {}
+    ~FrameAllocatorScope() { arena.reset(); }
+    FrameAllocatorScope(const FrameAllocatorScope&) = delete;
+    FrameAllocatorScope& operator=(const FrameAllocatorScope&) = delete;
+
+private:
+    ArenaAllocator& arena;
+    AllocatorScope scope;
+};
+
+#endif //TRAFFIC_SIGN_DETECTION_ALLOCATOR_HPP
@@ -0,0 +1,29 @@
+#ifndef TRAFFIC_SIGN_DETECTION_GEMM_HPP
+#define TRAFFIC_SIGN_DETECTION_GEMM_HPP
+
+// Activation applied in a GEMM/conv epilogue, while the output tile is still in registers
+enum class Activation { None, ReLU, LReLU };
+
+struct GemmEpilogue {
+    const float* rowBias = nullptr; // added to every element of row m (e.g. conv output channel)
+    const float* colBias = nullptr; // added to every element of column n (e.g. NHWC conv output channel)
+    Activation activation = Activation::None;
+    float alpha = 0.01f; // LReLU slope
+};
+
+// Row-major single-precision GEMM: C[M x N] = op(A)[M x K] * op(B)[K x N], where op(X) is X
+// or X^T (transA/transB; a transposed A is stored K x M with leading dimension lda). C is
+// overwritten; bias and activation from `epilogue` are applied on the way out.
+//
+// Large products go through the packed path: B is packed into KC x NR column panels and A
+// into MC x KC row panels (zero-padded, so the MR x NR register-tiled micro-kernel never
+// needs an edge case) and the MC x NC macro-tiles are split across the ThreadPool. Small
+// products skip packing and run the micro-kernel straight on the operands.
+void sgemm(bool transA, bool transB, int M, int N, int K, const float* A, int lda, const float* B, int ldb,
+           float* C, int ldc, const GemmEpilogue& epilogue = GemmEpilogue());
+
+// Plain triple loop with the same contract, the ground truth for bench_gemm.
+void sgemmReference(bool transA, bool transB, int M, int N, int K, const float* A, int lda, const float* B,
+                    int ldb, float* C, int ldc, const GemmEpilogue& epilogue = GemmEpilogue());
+
+#endif //TRAFFIC_SIGN_DETECTION_GEMM_HPP
@@ -0,0 +1,52 @@
+#ifndef TRAFFIC_SIGN_DETECTION_KERNELS_HPP
+#define TRAFFIC_SIGN_DETECTION_KERNELS_HPP
+
+// In-place elementwise kernels over n contiguous floats, used by the Tensor *Cpu ops and the
+// fused TensorExpr blocks. The vector body runs on simd.hpp (NEON / AVX2 / SSE2 picked at
+// compile time); the ragged tail is padded out to one full vector so every element goes
+// through the same instructions and results never depend on an element's position.
+//
+// Arithmetic and sqrt are exact (IEEE single). exp/log/tanh/sigmoid/elu use the polynomial
+// approximations in simd_math.hpp (error bounds documented there). Defining
+// TSR_REFERENCE_KERNELS, or building without any SIMD backend, routes everything to the
+// libm-based kernels::ref versions instead.
+namespace kernels {
+
+void addScalar(float* x, int n, float s);
+void subScalar(float* x, int n, float s);
+void mulScalar(float* x, int n, float s);
+void divScalar(float* x, int n, float s);
+
+void add(float* x, const float* y, int n);
+void sub(float* x, const float* y, int n);
+void mul(float* x, const float* y, int n);
+void div(float* x, const float* y, int n);
+
+// x * scale + shift, per element (affine) or with one scale/shift pair (affineScalar). Rounds
+// once where the backend has FMA (AVX2+FMA, NEON), twice otherwise.
+void affineScalar(float* x, int n, float scale, float shift);
+void affine(float* x, const float* scale, const float* shift, int n);
+
+void negate(float* x, int n);
+void relu(float* x, int n);
+void lrelu(float* x, int n, float alpha);
+void elu(float* x, int n, float alpha);
+void sigmoid(float* x, int n);
+void tanh(float* x, int n);
+void square(float* x, int n);
+void sqrt(float* x, int n);
+void exp(float* x, int n);
+void log(float* x, int n);
+
+// Scalar libm reference: the fallback path and the ground truth for bench_kernels
+namespace ref {
+void elu(float* x, int n, float alpha);
+void sigmoid(float* x, int n);
+void tanh(float* x, int n);
+void exp(float* x, int n);
+void log(float* x, int n);
+} // namespace ref
+
+} // namespace kernels
+
+#endif //TRAFFIC_SIGN_DETECTION_KERNELS_HPP
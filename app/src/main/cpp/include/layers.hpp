@@ -0,0 +1,72 @@
+#ifndef TRAFFIC_SIGN_DETECTION_LAYERS_HPP
+#define TRAFFIC_SIGN_DETECTION_LAYERS_HPP
+
+#include <vector>
+#include "gemm.hpp"
+#include "tensor.hpp"
+
+// CPU layer operators (convolution and pooling) for running small CNNs, such as the cascade
+// classifiers, without an ONNX Runtime session. Inputs may be any CPU view; non-contiguous
+// ones are packed first. Every op returns a new contiguous tensor in the input's memory
+// format (NCHW, NHWC or NCHWc4/c8) and splits its work across the ThreadPool.
+
+enum class ConvAlgo {
+    Auto,       // pick by shape, see selectConvAlgo()
+    Im2colGemm, // any shape: input patches unrolled tile by tile into a blocked GEMM
+    Direct,     // 1x1/stride-1/no-pad convs (GEMM straight on the input) and depthwise convs
+    Winograd    // F(2x2, 3x3): 3x3, stride 1, dilation 1, groups 1
+};
+
+struct Conv2dParams {
+    int strideH = 1;
+    int strideW = 1;
+    int padH = 0;
+    int padW = 0;
+    int dilationH = 1;
+    int dilationW = 1;
+    int groups = 1;
+    Activation activation = Activation::None;
+    float alpha = 0.01f; // LReLU slope
+    ConvAlgo algo = ConvAlgo::Auto;
+};
+
+// Output spatial size of a convolution/pooling window along one axis.
+int convOutputSize(int in, int kernel, int stride, int pad, int dilation = 1);
+
+// The path conv2d() takes for these shapes when params.algo is Auto.
+ConvAlgo selectConvAlgo(const std::vector<int>& inputShape, const std::vector<int>& weightShape,
+                        const Conv2dParams& params);
+
+// input [N, Cin, H, W], weight [Cout, Cin / groups, kH, kW], optional bias [Cout].
+// Bias and params.activation are fused into the output write: the result matches conv2d
+// without them followed by addBias(bias) and ReLU()/LReLU(), up to float summation order.
+//
+// The input may be in any memory format (weights stay NCHW); params.algo only applies to
+// NCHW inputs. NHWC runs depthwise convs per pixel and everything else as an im2col GEMM
+// over pixel rows; blocked inputs run depthwise and groups == 1 convs as direct kernels
+// with one SIMD vector per pixel block. Other shapes round-trip through NCHW.
+Tensor conv2d(const Tensor& input, const Tensor& weight, const Tensor* bias = nullptr,
+              const Conv2dParams& params = Conv2dParams());
+
+// Depthwise conv: weight [C * multiplier, 1, kH, kW]; output channel c reads input channel
+// c / multiplier. Same as conv2d with groups = C.
+Tensor depthwiseConv2d(const Tensor& input, const Tensor& weight, const Tensor* bias = nullptr,
+                       const Conv2dParams& params = Conv2dParams());
+
+struct Pool2dParams {
+    int kernelH = 2;
+    int kernelW = 2;
+    int strideH = 0; // 0 = kernelH
+    int strideW = 0; // 0 = kernelW
+    int padH = 0;    // at most half the kernel, so every window sees at least one input
+    int padW = 0;
+    bool countIncludePad = false; // AvgPool divisor: full kernel area vs. in-bounds inputs only
+};
+
+Tensor maxPool2d(const Tensor& input, const Pool2dParams& params);
+Tensor avgPool2d(const Tensor& input, const Pool2dParams& params);
+
+// Mean over each H x W plane: [N, C, H, W] -> [N, C, 1, 1]
+Tensor globalAvgPool(const Tensor& input);
+
+#endif //TRAFFIC_SIGN_DETECTION_LAYERS_HPP
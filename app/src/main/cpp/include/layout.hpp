@@ -0,0 +1,59 @@
+#ifndef TRAFFIC_SIGN_DETECTION_LAYOUT_HPP
+#define TRAFFIC_SIGN_DETECTION_LAYOUT_HPP
+
+#include <vector>
+#include "tensor.hpp"
+
+// Conversion kernels between the image memory formats (tensor.hpp) over packed buffers of N
+// images with C channels and HW pixels each, and per-channel helpers that work in any format.
+// Conversions are cache-tiled transposes split across the ThreadPool; blocked destinations
+// get zeroed padding lanes.
+namespace layout {
+
+void nchwToNhwc(const float* src, float* dst, int N, int C, int HW);
+void nhwcToNchw(const float* src, float* dst, int N, int C, int HW);
+void nchwToBlocked(const float* src, float* dst, int N, int C, int HW, int block);
+void blockedToNchw(const float* src, float* dst, int N, int C, int HW, int block);
+void nhwcToBlocked(const float* src, float* dst, int N, int C, int HW, int block);
+void blockedToNhwc(const float* src, float* dst, int N, int C, int HW, int block);
+
+// Per-channel values (stride apart in `values`) laid out like one pixel of `format`: C lanes,
+// or ceil(C / block) whole blocks with the padding lanes set to `pad`.
+std::vector<float> channelLanes(const float* values, int stride, int C, MemoryFormat format, float pad);
+
+enum class ChannelOp { Add, Mul };
+
+// A per-channel vector (bias, scale) expanded once to the repeating element pattern of a
+// packed image tensor, so applying it to any flat range is plain vectorized elementwise work:
+// one scalar per H*W run in NCHW, a tiled lane pattern in NHWC and blocked formats. Any packed
+// tensor with a channel axis fits too: [outer, C, inner] is NCHW with plane = inner, and a
+// channel-last [outer, C] is NHWC.
+class ChannelPattern {
+public:
+    ChannelPattern(const float* values, int stride, MemoryFormat format, int channels, int plane, float pad);
+
+    // x[i] op= value of channel(begin + i), for elements [begin, begin + n) of the tensor
+    void apply(float* x, long begin, int n, ChannelOp op) const;
+
+    // x[i] = x[i] * scale + shift of channel(begin + i), this pattern holding the scales and
+    // `shift` built over the same tensor
+    void applyAffine(float* x, long begin, int n, const ChannelPattern& shift) const;
+
+private:
+    MemoryFormat format;
+    int channels;
+    int plane;  // H * W
+    int period; // elements before the lane pattern repeats: C (NHWC) or block (blocked)
+    int span;   // pattern elements available from any phase
+    std::vector<float> lanes;   // one value per channel lane
+    std::vector<float> pattern; // per lane group: `span + period` elements of repeated lanes
+
+    // Splits [begin, begin + n) into runs of one value: perChannel(i, c, len) in NCHW, else
+    // perSpan(i, patternOffset, len) for `len` elements of `pattern`
+    template <typename PerChannel, typename PerSpan>
+    void forRuns(long begin, int n, PerChannel perChannel, PerSpan perSpan) const;
+};
+
+} // namespace layout
+
+#endif //TRAFFIC_SIGN_DETECTION_LAYOUT_HPP
@@ -13,6 +13,10 @@
 #include <chrono>
 #include <sstream>
 #include <vector>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <thread>
 
 enum class LogLevel {
     DEBUG = 0,
@@ -22,6 +26,24 @@ enum class LogLevel {
     CRITICAL = 4
 };
 
+// What a producer does when the record queue is full
+enum class LogOverflow {
+    Drop,  // discard the record and count it (getDroppedCount); never waits
+    Block  // wait for the writer thread to make room
+};
+
+// Asynchronous backend settings, fixed by initialize()
+struct LoggerOptions {
+    size_t queueCapacity = 4096;                  // records in flight, rounded up to a power of two
+    LogOverflow overflow = LogOverflow::Drop;
+    std::chrono::milliseconds flushInterval{250}; // the writer flushes at least this often while busy
+    LogLevel flushLevel = LogLevel::ERROR;        // records at or above this wake the writer and are flushed at once
+    bool reportMemoryLeaks = false;               // close() logs tracked memory still live (MemoryTracker::reportLeaks)
+};
+
+// Log calls only format their text into a fixed-size slot of a bounded lock-free MPSC ring and
+// return; a background writer thread drains the ring in batches, adds timestamps and writes
+// them to the file (and console). Calls before initialize() or after close() are no-ops.
 class Logger {
 public:
     // Singleton pattern
@@ -30,7 +52,8 @@ public:
     // Initialize logger with file path and log level
     void initialize(const std::string& logFilePath = "traffic_sign_app.log",
                     LogLevel level = LogLevel::INFO,
-                    bool consoleOutput = true);
+                    bool consoleOutput = true,
+                    const LoggerOptions& options = LoggerOptions());
 
     // Logging methods
     void debug(const std::string& message, const std::string& component = "");
@@ -72,50 +95,100 @@ public:
     // Set log level at runtime
     void setLogLevel(LogLevel level);
 
-    // Flush logs
+    // Whether a record at `level` would be queued; what the LOG_* macros test first
+    bool isEnabled(LogLevel level) const {
+        return (int)level >= currentLevel.load(std::memory_order_relaxed) &&
+               running.load(std::memory_order_relaxed);
+    }
+
+    // Blocks until every record logged before the call is written and flushed
     void flush();
 
-    // Close logger
+    // Drains the queue, stops the writer thread and closes the file
     void close();
 
+    uint64_t getWrittenCount() const;
+    uint64_t getDroppedCount() const; // records lost to a full queue under LogOverflow::Drop
+
 private:
     Logger() = default;
-    ~Logger() = default;
+    ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
+    struct Record;
+    struct Ring; // bounded MPSC queue of Records (logger.cpp)
+
     void log(LogLevel level, const std::string& message, const std::string& component = "");
+    // A queue slot to format into, or null when filtered out, stopped or dropped; publish() hands it to the writer
+    Record* claim(LogLevel level, const char* tag);
+    void publish(Record* record);
+    void writerLoop();
     std::string getCurrentTimestamp();
     std::string logLevelToString(LogLevel level);
-    std::string formatShape(const std::vector<int>& shape);
 
-    std::ofstream logFile;
-    LogLevel currentLevel;
-    bool consoleOutput;
-    std::mutex logMutex;
-    bool initialized;
+    std::ofstream logFile; // owned by the writer thread while it runs
+    std::atomic<int> currentLevel{(int)LogLevel::INFO};
+    bool consoleOutput = true;
+    LoggerOptions options;
+
+    std::unique_ptr<Ring> ring;
+    std::thread writer;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+
+    std::mutex wakeMutex;            // guards the three fields below
+    std::condition_variable wake;    // the writer sleeps here between batches
+    std::condition_variable drained; // flush() waits here
+    uint64_t flushRequested = 0;
+    uint64_t flushCompleted = 0;
+    bool stopRequested = false;
 };
 
+// Compile-time floor (0 = DEBUG ... 4 = CRITICAL, 5 = off): the macros below compile calls
+// under it to nothing. At or above it they test Logger::isEnabled before evaluating any
+// argument, so a filtered call costs two relaxed loads and builds no strings.
+#ifndef TSR_LOG_MIN_LEVEL
+#define TSR_LOG_MIN_LEVEL 0
+#endif
+
+#define TSR_LOG_IF(level, call) \
+    do { \
+        if ((int)(level) >= TSR_LOG_MIN_LEVEL && Logger::getInstance().isEnabled(level)) { \
+            call; \
+        } \
+    } while (0)
+
 // Convenience macros for easy logging
-#define LOG_DEBUG(msg) Logger::getInstance().debug(msg, __FUNCTION__)
-#define LOG_INFO(msg) Logger::getInstance().info(msg, __FUNCTION__)
-#define LOG_WARNING(msg) Logger::getInstance().warning(msg, __FUNCTION__)
-#define LOG_ERROR(msg) Logger::getInstance().error(msg, __FUNCTION__)
-#define LOG_CRITICAL(msg) Logger::getInstance().critical(msg, __FUNCTION__)
+#define LOG_DEBUG(msg) TSR_LOG_IF(LogLevel::DEBUG, Logger::getInstance().debug(msg, __FUNCTION__))
+#define LOG_INFO(msg) TSR_LOG_IF(LogLevel::INFO, Logger::getInstance().info(msg, __FUNCTION__))
+#define LOG_WARNING(msg) TSR_LOG_IF(LogLevel::WARNING, Logger::getInstance().warning(msg, __FUNCTION__))
+#define LOG_ERROR(msg) TSR_LOG_IF(LogLevel::ERROR, Logger::getInstance().error(msg, __FUNCTION__))
+#define LOG_CRITICAL(msg) TSR_LOG_IF(LogLevel::CRITICAL, Logger::getInstance().critical(msg, __FUNCTION__))
 
+// Successful operations log at INFO, failures at ERROR
 #define LOG_TENSOR_OP(op, device, shape, success, error) \
-    Logger::getInstance().logTensorOperation(op, device, shape, success, error)
+    do { \
+        const bool tsrLogOk = (success); \
+        TSR_LOG_IF(tsrLogOk ? LogLevel::INFO : LogLevel::ERROR, \
+                   Logger::getInstance().logTensorOperation(op, device, shape, tsrLogOk, error)); \
+    } while (0)
 
 #define LOG_CUDA_OP(op, kernel, blockSize, gridSize, success, error) \
-    Logger::getInstance().logCudaOperation(op, kernel, blockSize, gridSize, success, error)
+    do { \
+        const bool tsrLogOk = (success); \
+        TSR_LOG_IF(tsrLogOk ? LogLevel::INFO : LogLevel::ERROR, \
+                   Logger::getInstance().logCudaOperation(op, kernel, blockSize, gridSize, tsrLogOk, error)); \
+    } while (0)
 
 #define LOG_PERFORMANCE(op, device, time_us, info) \
-    Logger::getInstance().logPerformance(op, device, time_us, info)
+    TSR_LOG_IF(LogLevel::INFO, Logger::getInstance().logPerformance(op, device, time_us, info))
 
 #define LOG_MEMORY_ALLOC(device, size, purpose) \
-    Logger::getInstance().logMemoryAllocation(device, size, purpose)
+    TSR_LOG_IF(LogLevel::INFO, Logger::getInstance().logMemoryAllocation(device, size, purpose))
 
 #define LOG_MEMORY_DEALLOC(device, size, purpose) \
-    Logger::getInstance().logMemoryDeallocation(device, size, purpose)
+    TSR_LOG_IF(LogLevel::INFO, Logger::getInstance().logMemoryDeallocation(device, size, purpose))
 
 #endif //TRAFFIC_SIGN_DETECTION_TEMP_LOGGER_HPP
@@ -0,0 +1,123 @@
+#ifndef TRAFFIC_SIGN_DETECTION_MEMORY_TRACKER_HPP
+#define TRAFFIC_SIGN_DETECTION_MEMORY_TRACKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class Device { CPU, GPU };
+
+// What an allocation is for. New tensor buffers take the calling thread's current tag
+// (MemoryTagScope), Activation by default.
+enum class MemoryTag { Activation, Weights, Preproc, Gradient, Scratch };
+
+constexpr int kDeviceCount = 2;
+constexpr int kMemoryTagCount = 5;
+
+const char* deviceName(Device device);
+const char* memoryTagName(MemoryTag tag);
+
+struct MemoryUsage {
+    int64_t liveBytes = 0;
+    int64_t peakBytes = 0;       // highest liveBytes since start (or resetPeaks())
+    int64_t liveAllocations = 0;
+    uint64_t allocations = 0;    // total since start
+};
+
+struct MemorySnapshot {
+    MemoryUsage total;
+    MemoryUsage device[kDeviceCount];
+    MemoryUsage tag[kMemoryTagCount];
+
+    // "memory live=12.0MB peak=30.5MB allocs=10/4123" plus one line per device and tag in use
+    std::string toText() const;
+};
+
+// Process-wide accounting of tensor memory: live bytes, peak bytes and allocation counts per
+// device and per tag. Storage (host buffers) and the CUDA paths report every allocation and
+// free here, and the tracker emits the LOG_MEMORY_* records with the real device and tag.
+// Updates are a few relaxed atomic adds; never locks.
+class MemoryTracker {
+public:
+    static MemoryTracker& getInstance();
+
+    void recordAlloc(Device device, MemoryTag tag, size_t bytes);
+    void recordFree(Device device, MemoryTag tag, size_t bytes);
+
+    MemorySnapshot snapshot() const;
+    void resetPeaks(); // peaks restart from the current live bytes
+
+    // Logs every device and tag that still holds memory (WARNING), or a single INFO line when
+    // nothing is live. Called by Logger::close() when LoggerOptions::reportMemoryLeaks is set.
+    // Returns the live bytes.
+    int64_t reportLeaks() const;
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+private:
+    friend class MemoryProbe;
+
+    struct Cell {
+        std::atomic<int64_t> liveBytes{0};
+        std::atomic<int64_t> peakBytes{0};
+        std::atomic<int64_t> liveAllocations{0};
+        std::atomic<uint64_t> allocations{0};
+
+        void add(int64_t bytes);
+        void remove(int64_t bytes);
+        MemoryUsage load() const;
+    };
+
+    MemoryTracker() = default;
+
+    static constexpr int kProbeSlots = 32;
+
+    Cell total;
+    Cell devices[kDeviceCount];
+    Cell tags[kMemoryTagCount];
+    std::atomic<uint32_t> claimedProbes{0};         // bit i set while slot i belongs to a live MemoryProbe
+    std::atomic<uint32_t> activeProbes{0};          // bit i set once slot i is seeded and recording
+    std::atomic<int64_t> probePeaks[kProbeSlots]{}; // total peak since each probe began
+};
+
+// Thread's tag for new allocations
+MemoryTag currentMemoryTag();
+
+// Tags this thread's allocations for the scope's lifetime:
+//   { MemoryTagScope scope(MemoryTag::Weights); loadModel(); }
+class MemoryTagScope {
+public:
+    explicit MemoryTagScope(MemoryTag tag);
+    ~MemoryTagScope();
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag previous;
+};
+
+// High-water mark of total tracked memory (all threads, all devices) over a scope, e.g. a
+// frame. With a name, the peak is published as the "memory.<name>.peak" gauge when the probe
+// ends; with a budget, exceeding it logs a warning. Each probe owns one of 32 window slots, so
+// probes may nest, overlap in any order and live on different threads; beyond 32 live probes
+// the extra ones report the tracker's overall peak instead (an upper bound).
+class MemoryProbe {
+public:
+    explicit MemoryProbe(const char* name = nullptr, int64_t budgetBytes = 0);
+    ~MemoryProbe();
+    MemoryProbe(const MemoryProbe&) = delete;
+    MemoryProbe& operator=(const MemoryProbe&) = delete;
+
+    int64_t peakBytes() const;   // highest total live bytes since the probe began
+    int64_t peakGrowth() const;  // peakBytes() minus the live bytes at the start
+
+private:
+    const char* name;
+    int64_t budget;
+    int64_t startBytes;
+    int slot; // index into MemoryTracker::probePeaks, -1 when all slots were taken
+};
+
+#endif //TRAFFIC_SIGN_DETECTION_MEMORY_TRACKER_HPP
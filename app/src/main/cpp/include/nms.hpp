@@ -0,0 +1,32 @@
+#ifndef TRAFFIC_SIGN_DETECTION_NMS_HPP
+#define TRAFFIC_SIGN_DETECTION_NMS_HPP
+
+#include <vector>
+#include "yolo_decoder.hpp"
+
+enum class NmsMethod {
+    Hard = 0,         // classic greedy suppression at iouThreshold
+    SoftLinear = 1,   // score *= (1 - IoU) once IoU >= iouThreshold
+    SoftGaussian = 2  // score *= exp(-IoU^2 / softSigma)
+};
+
+struct NmsConfig {
+    float iouThreshold = 0.45f;
+    // Only boxes of the same class suppress each other (batched NMS). Off = class-agnostic.
+    bool classAware = true;
+    NmsMethod method = NmsMethod::Hard;
+    float softSigma = 0.5f;
+    // Soft-NMS drops boxes whose decayed score falls below this.
+    float scoreThreshold = 0.001f;
+    // Hard NMS switches from the vectorized all-pairs scan to the spatial grid above this many
+    // candidates. 0 forces the grid, a negative value disables it.
+    int gridMinCandidates = 4096;
+    int maxDetections = 300;
+};
+
+// Suppresses overlapping candidates and writes the surviving indices into `keep`, ordered by
+// descending score. Soft-NMS rewrites `boxes.score` with the decayed scores.
+// Returns keep.size().
+size_t nonMaxSuppression(DetectionCandidates& boxes, const NmsConfig& config, std::vector<int>& keep);
+
+#endif //TRAFFIC_SIGN_DETECTION_NMS_HPP
@@ -0,0 +1,58 @@
+#ifndef TRAFFIC_SIGN_DETECTION_PREPROCESS_HPP
+#define TRAFFIC_SIGN_DETECTION_PREPROCESS_HPP
+
+#include <cstdint>
+#include "tensor.hpp"
+
+// Byte order of a 4-byte-per-pixel source frame as it sits in memory.
+// Android ARGB_8888 bitmaps (copyPixelsToBuffer) are RGBA; the packed ints
+// returned by Bitmap.getPixels are BGRA on little-endian devices.
+enum class PixelFormat { RGBA8888 = 0, BGRA8888 = 1 };
+
+// Geometry of the YOLO letterbox: the source is scaled by `scale` to newW x newH
+// and pasted at (padX, padY) on a dstW x dstH grey canvas.
+struct LetterboxInfo {
+    int dstW = 0;
+    int dstH = 0;
+    int newW = 0;
+    int newH = 0;
+    int padX = 0;
+    int padY = 0;
+    float scale = 1.0f;
+};
+
+constexpr float kLetterboxPadValue = 114.0f / 255.0f;
+
+// Same rounding as OnnxInferenceEngine.preprocess() so box coordinates map back identically.
+LetterboxInfo computeLetterbox(int srcW, int srcH, int dstW, int dstH);
+
+// Fused bilinear resize + letterbox pad + /255 normalize + layout change in a single pass.
+// For NCHW `dst` receives three planes of dstW*dstH floats (R, G, B); NHWC / NCHWc4 / NCHWc8
+// get dstW*dstH interleaved pixels of 3 / 4 / 8 floats (R, G, B, then zeroed padding lanes),
+// so the frame lands directly in the layout the conv kernels run on. `srcRowStride` is in bytes.
+void letterboxNormalize(const uint8_t* src, int srcW, int srcH, int srcRowStride, PixelFormat fmt,
+                        float* dst, const LetterboxInfo& info, MemoryFormat layout = MemoryFormat::NCHW);
+
+// Tensor overload: `dst` must be a contiguous CPU tensor of logical shape [1, 3, H, W] in any
+// memory format (e.g. Tensor::withMemoryFormat({1, 3, H, W}, MemoryFormat::NCHWc8)).
+LetterboxInfo letterboxNormalize(const uint8_t* src, int srcW, int srcH, int srcRowStride, PixelFormat fmt,
+                                 Tensor& dst);
+
+// One camera frame in Android YUV_420_888 layout (ImageProxy / Image planes).
+// Chroma planes are subsampled 2x2; uvPixelStride is 1 for planar I420 and 2 for NV12/NV21.
+struct Yuv420Frame {
+    const uint8_t* y = nullptr;
+    const uint8_t* u = nullptr;
+    const uint8_t* v = nullptr;
+    int width = 0;
+    int height = 0;
+    int yRowStride = 0;
+    int uvRowStride = 0;
+    int uvPixelStride = 1;
+};
+
+// Full-range BT.601 (JFIF) YUV -> RGBA8888 with clockwise rotation by 0/90/180/270 degrees.
+// `dst` holds the rotated image (height x width for 90/270) with dstRowStride bytes per row.
+void yuv420ToRgba(const Yuv420Frame& frame, int rotationDegrees, uint8_t* dst, int dstRowStride);
+
+#endif //TRAFFIC_SIGN_DETECTION_PREPROCESS_HPP
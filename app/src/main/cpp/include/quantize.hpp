@@ -0,0 +1,55 @@
+#ifndef TRAFFIC_SIGN_DETECTION_QUANTIZE_HPP
+#define TRAFFIC_SIGN_DETECTION_QUANTIZE_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Element type of a tensor's storage. FP16 is IEEE binary16 (converted in hardware through
+// F16C / arm64 NEON where available); INT8 is affine-quantized with QuantParams.
+enum class DType { FP32, FP16, INT8 };
+
+int dtypeSize(DType dtype); // bytes per element
+const char* dtypeName(DType dtype);
+
+// Affine INT8 quantization: q = clamp(round(x / scale) + zeroPoint, -128, 127) and
+// x ~= scale * (q - zeroPoint). Per-tensor with one pair, or per-channel along `axis` with one
+// pair per index of that dimension (e.g. axis 1 of an NCHW activation, axis 0 of conv weights).
+struct QuantParams {
+    std::vector<float> scale;
+    std::vector<int> zeroPoint;
+    int axis = -1; // -1 = per-tensor
+
+    static QuantParams perTensor(float scale, int zeroPoint = 0);
+    static QuantParams perChannel(std::vector<float> scale, std::vector<int> zeroPoint, int axis);
+
+    bool empty() const { return scale.empty(); }
+    bool isPerChannel() const { return axis >= 0; }
+    int channels() const { return (int)scale.size(); }
+};
+
+// Kernels over n contiguous elements. Vector bodies run on simd.hpp (int8 / half lanes widened
+// to float), the ragged tail is padded out to one full vector like kernels.hpp.
+namespace quant {
+
+// Smallest asymmetric scale/zero point whose range covers [minVal, maxVal] and 0 (so zero
+// padding and ReLU outputs are exact)
+void chooseParams(float minVal, float maxVal, float& scale, int& zeroPoint);
+// Widens [minVal, maxVal] to cover x[0, n)
+void minMax(const float* x, int n, float& minVal, float& maxVal);
+
+void quantize(const float* x, int8_t* q, int n, float scale, int zeroPoint);
+void dequantize(const int8_t* q, float* x, int n, float scale, int zeroPoint);
+void toHalf(const float* x, uint16_t* h, int n);
+void fromHalf(const uint16_t* h, float* x, int n);
+
+// a = requantize(scaleA * (a - zeroA) + scaleB * (b - zeroB)) into (scaleOut, zeroOut)
+void add(int8_t* a, const int8_t* b, int n, float scaleA, int zeroA, float scaleB, int zeroB,
+         float scaleOut, int zeroOut);
+// Saturating x += offset, e.g. a bias already divided by the scale
+void addOffset(int8_t* x, int n, int offset);
+// max(x, zeroPoint): ReLU in the quantized domain
+void relu(int8_t* x, int n, int zeroPoint);
+
+} // namespace quant
+
+#endif //TRAFFIC_SIGN_DETECTION_QUANTIZE_HPP
@@ -0,0 +1,37 @@
+#ifndef TRAFFIC_SIGN_DETECTION_REDUCE_HPP
+#define TRAFFIC_SIGN_DETECTION_REDUCE_HPP
+
+// Axis reductions behind Tensor::sum/max/argmax/softmax/... A packed row-major tensor reduced
+// along one axis is seen as [outer, n, inner]: n elements are reduced for each of the
+// outer * inner output positions, and `inner` is the contiguous run after the axis.
+//   - inner == 1 (the last axis, e.g. class logits per row) reduces contiguous rows with
+//     vector accumulators,
+//   - inner > 1 (e.g. channels of an NCHW map, classes of a [1, 4 + C, anchors] head)
+//     accumulates whole rows of `inner` into an output row with the elementwise kernels,
+//     in column blocks that stay in L1.
+// Independent rows / column blocks are split across the ThreadPool. Indices (argmax, topK)
+// are stored as floats, exact below 2^24. NaN inputs give unspecified results.
+namespace reduce {
+
+// Float summation order. Pairwise (the default) sums blocks of 256 with vector accumulators
+// and combines them pairwise: O(log n) error growth at full speed. Kahan carries a
+// compensation term per lane / per output element: error independent of n, about 2x slower.
+enum class Summation { Pairwise, Kahan };
+
+// dst [outer, inner]
+void sum(const float* x, int outer, int n, int inner, float* dst, Summation mode = Summation::Pairwise);
+void max(const float* x, int outer, int n, int inner, float* dst);
+void argmax(const float* x, int outer, int n, int inner, float* dst); // first index of the maximum
+void logSumExp(const float* x, int outer, int n, int inner, float* dst); // max + log(sum(exp(x - max)))
+
+// In place over every [n] slice: exp(x - max) / sum and x - logSumExp
+void softmax(float* x, int outer, int n, int inner);
+void logSoftmax(float* x, int outer, int n, int inner);
+
+// The k largest of every slice in descending order (ties: lower index first), values and
+// indices each [outer, k, inner]
+void topK(const float* x, int outer, int n, int inner, int k, float* values, float* indices);
+
+} // namespace reduce
+
+#endif //TRAFFIC_SIGN_DETECTION_REDUCE_HPP
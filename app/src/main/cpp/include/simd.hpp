@@ -0,0 +1,432 @@
+#ifndef TRAFFIC_SIGN_DETECTION_SIMD_HPP
+#define TRAFFIC_SIGN_DETECTION_SIMD_HPP
+
+// Thin compile-time dispatched float vector wrapper.
+// arm64/armv7 builds get NEON, x86 host builds get AVX2 when compiled with -mavx2
+// (SSE2 otherwise), and anything else falls back to a 1-wide scalar "vector".
+// loadInt8/storeInt8 and loadHalf/storeHalf move kWidth narrow elements in and out of a float
+// vector for the quantized kernels; half conversions use F16C / arm64 NEON when available.
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TSR_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TSR_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define TSR_SIMD_NEON 1
+#else
+#include <cmath>
+#define TSR_SIMD_SCALAR 1
+#endif
+
+namespace simd {
+
+// Scalar IEEE binary16 <-> binary32, round to nearest even (the fallback for backends without
+// hardware conversion). arm64 converts natively through __fp16.
+#if defined(__aarch64__)
+inline float halfToFloat(uint16_t h) {
+    __fp16 v;
+    std::memcpy(&v, &h, sizeof(h));
+    return (float)v;
+}
+inline uint16_t floatToHalf(float f) {
+    const __fp16 v = (__fp16)f;
+    uint16_t h;
+    std::memcpy(&h, &v, sizeof(h));
+    return h;
+}
+#else
+inline float halfToFloat(uint16_t h) {
+    const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    uint32_t bits;
+    if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13); // inf / nan
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else { // subnormal: renormalize
+        int e = 113;
+        while ((mantissa & 0x400) == 0) {
+            mantissa <<= 1;
+            --e;
+        }
+        bits = sign | ((uint32_t)e << 23) | ((mantissa & 0x3ff) << 13);
+    }
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+inline uint16_t floatToHalf(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    const uint32_t abs = bits & 0x7fffffff;
+    if (abs >= 0x7f800000) return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0); // inf / nan
+    if (abs >= 0x477ff000) return sign | 0x7c00;                                   // rounds past 65504
+    if (abs < 0x38800000) { // half subnormal or zero
+        if (abs < 0x33000000) return sign;
+        const uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+        const int shift = 126 - (int)(abs >> 23); // 14..24
+        const uint32_t halfMantissa = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+        return sign | (uint16_t)(halfMantissa + (rest > halfway || (rest == halfway && (halfMantissa & 1))));
+    }
+    const uint32_t rounded = abs - 0x38000000 + 0xfff + ((abs >> 13) & 1); // rebias, round to nearest even
+    return sign | (uint16_t)(rounded >> 13);
+}
+#endif
+
+#if defined(TSR_SIMD_AVX2)
+
+using VecF = __m256;
+constexpr int kWidth = 8;
+inline const char* isaName() { return "AVX2"; }
+
+inline VecF load(const float* p) { return _mm256_loadu_ps(p); }
+inline void store(float* p, VecF v) { _mm256_storeu_ps(p, v); }
+inline VecF set1(float v) { return _mm256_set1_ps(v); }
+inline VecF add(VecF a, VecF b) { return _mm256_add_ps(a, b); }
+inline VecF sub(VecF a, VecF b) { return _mm256_sub_ps(a, b); }
+inline VecF mul(VecF a, VecF b) { return _mm256_mul_ps(a, b); }
+inline VecF max(VecF a, VecF b) { return _mm256_max_ps(a, b); }
+inline VecF min(VecF a, VecF b) { return _mm256_min_ps(a, b); }
+#if defined(__FMA__)
+inline VecF mulAdd(VecF a, VecF b, VecF c) { return _mm256_fmadd_ps(a, b, c); } // a * b + c
+#else
+inline VecF mulAdd(VecF a, VecF b, VecF c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+
+using MaskF = __m256;
+inline MaskF cmpGt(VecF a, VecF b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+inline MaskF cmpGe(VecF a, VecF b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+inline VecF select(MaskF m, VecF a, VecF b) { return _mm256_blendv_ps(b, a, m); } // m ? a : b
+inline bool anyTrue(MaskF m) { return _mm256_movemask_ps(m) != 0; }
+inline MaskF cmpEq(VecF a, VecF b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+inline MaskF maskAnd(MaskF a, MaskF b) { return _mm256_and_ps(a, b); }
+inline MaskF maskOr(MaskF a, MaskF b) { return _mm256_or_ps(a, b); }
+inline MaskF cmpLt(VecF a, VecF b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+
+inline VecF div(VecF a, VecF b) { return _mm256_div_ps(a, b); }
+inline VecF sqrt(VecF a) { return _mm256_sqrt_ps(a); }
+inline VecF abs(VecF a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+inline VecF roundNearest(VecF a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+// 2^n for integral n in [-126, 127]
+inline VecF pow2i(VecF n) {
+    __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+}
+// x = mantissa * 2^exponent with mantissa in [0.5, 1), for positive normal x
+inline VecF frexpMantissa(VecF x) {
+    __m256i bits = _mm256_castps_si256(x);
+    bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f000000));
+    return _mm256_castsi256_ps(bits);
+}
+inline VecF frexpExponent(VecF x) {
+    __m256i e = _mm256_srli_epi32(_mm256_castps_si256(x), 23);
+    return _mm256_cvtepi32_ps(_mm256_sub_epi32(e, _mm256_set1_epi32(126)));
+}
+// dst[c * dstLd + r] = src[r * srcLd + c] for one kWidth x kWidth block
+inline void transposeBlock(const float* src, int srcLd, float* dst, int dstLd) {
+    __m256 r[8], t[8];
+    for (int i = 0; i < 8; ++i) r[i] = _mm256_loadu_ps(src + (size_t)i * srcLd);
+    for (int i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+        r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+        r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+        r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+        r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (int i = 0; i < 4; ++i) {
+        _mm256_storeu_ps(dst + (size_t)i * dstLd, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+        _mm256_storeu_ps(dst + (size_t)(i + 4) * dstLd, _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+    }
+}
+
+// Rounds to nearest even and saturates to [-128, 127]
+inline VecF loadInt8(const int8_t* p) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)p)));
+}
+inline void storeInt8(int8_t* p, VecF v) {
+    const __m256i i = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-128.0f)), _mm256_set1_ps(127.0f)));
+    const __m128i s16 = _mm_packs_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1));
+    _mm_storel_epi64((__m128i*)p, _mm_packs_epi16(s16, s16));
+}
+#if defined(__F16C__)
+inline VecF loadHalf(const uint16_t* p) { return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)p)); }
+inline void storeHalf(uint16_t* p, VecF v) {
+    _mm_storeu_si128((__m128i*)p, _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+}
+#else
+inline VecF loadHalf(const uint16_t* p) {
+    alignas(32) float f[8];
+    for (int i = 0; i < 8; ++i) f[i] = halfToFloat(p[i]);
+    return _mm256_load_ps(f);
+}
+inline void storeHalf(uint16_t* p, VecF v) {
+    alignas(32) float f[8];
+    _mm256_store_ps(f, v);
+    for (int i = 0; i < 8; ++i) p[i] = floatToHalf(f[i]);
+}
+#endif
+
+#elif defined(TSR_SIMD_SSE2)
+
+using VecF = __m128;
+constexpr int kWidth = 4;
+inline const char* isaName() { return "SSE2"; }
+
+inline VecF load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, VecF v) { _mm_storeu_ps(p, v); }
+inline VecF set1(float v) { return _mm_set1_ps(v); }
+inline VecF add(VecF a, VecF b) { return _mm_add_ps(a, b); }
+inline VecF sub(VecF a, VecF b) { return _mm_sub_ps(a, b); }
+inline VecF mul(VecF a, VecF b) { return _mm_mul_ps(a, b); }
+inline VecF max(VecF a, VecF b) { return _mm_max_ps(a, b); }
+inline VecF min(VecF a, VecF b) { return _mm_min_ps(a, b); }
+inline VecF mulAdd(VecF a, VecF b, VecF c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+using MaskF = __m128;
+inline MaskF cmpGt(VecF a, VecF b) { return _mm_cmpgt_ps(a, b); }
+inline MaskF cmpGe(VecF a, VecF b) { return _mm_cmpge_ps(a, b); }
+inline VecF select(MaskF m, VecF a, VecF b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+inline bool anyTrue(MaskF m) { return _mm_movemask_ps(m) != 0; }
+inline MaskF cmpEq(VecF a, VecF b) { return _mm_cmpeq_ps(a, b); }
+inline MaskF maskAnd(MaskF a, MaskF b) { return _mm_and_ps(a, b); }
+inline MaskF maskOr(MaskF a, MaskF b) { return _mm_or_ps(a, b); }
+inline MaskF cmpLt(VecF a, VecF b) { return _mm_cmplt_ps(a, b); }
+
+inline VecF div(VecF a, VecF b) { return _mm_div_ps(a, b); }
+inline VecF sqrt(VecF a) { return _mm_sqrt_ps(a); }
+inline VecF abs(VecF a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+// SSE2 has no round instruction; cvtps rounds to nearest-even under the default MXCSR mode
+inline VecF roundNearest(VecF a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+inline VecF pow2i(VecF n) {
+    __m128i e = _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127));
+    return _mm_castsi128_ps(_mm_slli_epi32(e, 23));
+}
+inline VecF frexpMantissa(VecF x) {
+    __m128i bits = _mm_castps_si128(x);
+    bits = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f000000));
+    return _mm_castsi128_ps(bits);
+}
+inline VecF frexpExponent(VecF x) {
+    __m128i e = _mm_srli_epi32(_mm_castps_si128(x), 23);
+    return _mm_cvtepi32_ps(_mm_sub_epi32(e, _mm_set1_epi32(126)));
+}
+inline void transposeBlock(const float* src, int srcLd, float* dst, int dstLd) {
+    __m128 r0 = _mm_loadu_ps(src), r1 = _mm_loadu_ps(src + srcLd);
+    __m128 r2 = _mm_loadu_ps(src + 2 * (size_t)srcLd), r3 = _mm_loadu_ps(src + 3 * (size_t)srcLd);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst, r0);
+    _mm_storeu_ps(dst + dstLd, r1);
+    _mm_storeu_ps(dst + 2 * (size_t)dstLd, r2);
+    _mm_storeu_ps(dst + 3 * (size_t)dstLd, r3);
+}
+
+inline VecF loadInt8(const int8_t* p) {
+    int32_t word;
+    std::memcpy(&word, p, sizeof(word));
+    __m128i x = _mm_cvtsi32_si128(word);
+    x = _mm_unpacklo_epi8(x, x);
+    x = _mm_unpacklo_epi16(x, x);
+    return _mm_cvtepi32_ps(_mm_srai_epi32(x, 24)); // sign-extend the top byte of each lane
+}
+inline void storeInt8(int8_t* p, VecF v) {
+    const __m128i i = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-128.0f)), _mm_set1_ps(127.0f)));
+    const __m128i s16 = _mm_packs_epi32(i, i);
+    const int32_t word = _mm_cvtsi128_si32(_mm_packs_epi16(s16, s16));
+    std::memcpy(p, &word, sizeof(word));
+}
+inline VecF loadHalf(const uint16_t* p) {
+    return _mm_setr_ps(halfToFloat(p[0]), halfToFloat(p[1]), halfToFloat(p[2]), halfToFloat(p[3]));
+}
+inline void storeHalf(uint16_t* p, VecF v) {
+    alignas(16) float f[4];
+    _mm_store_ps(f, v);
+    for (int i = 0; i < 4; ++i) p[i] = floatToHalf(f[i]);
+}
+
+#elif defined(TSR_SIMD_NEON)
+
+using VecF = float32x4_t;
+constexpr int kWidth = 4;
+inline const char* isaName() { return "NEON"; }
+
+inline VecF load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, VecF v) { vst1q_f32(p, v); }
+inline VecF set1(float v) { return vdupq_n_f32(v); }
+inline VecF add(VecF a, VecF b) { return vaddq_f32(a, b); }
+inline VecF sub(VecF a, VecF b) { return vsubq_f32(a, b); }
+inline VecF mul(VecF a, VecF b) { return vmulq_f32(a, b); }
+inline VecF max(VecF a, VecF b) { return vmaxq_f32(a, b); }
+inline VecF min(VecF a, VecF b) { return vminq_f32(a, b); }
+inline VecF mulAdd(VecF a, VecF b, VecF c) { return vmlaq_f32(c, a, b); }
+
+using MaskF = uint32x4_t;
+inline MaskF cmpGt(VecF a, VecF b) { return vcgtq_f32(a, b); }
+inline MaskF cmpGe(VecF a, VecF b) { return vcgeq_f32(a, b); }
+inline VecF select(MaskF m, VecF a, VecF b) { return vbslq_f32(m, a, b); }
+#if defined(__aarch64__)
+inline bool anyTrue(MaskF m) { return vmaxvq_u32(m) != 0; }
+#else
+inline bool anyTrue(MaskF m) {
+    uint32x2_t r = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+    return (vget_lane_u32(r, 0) | vget_lane_u32(r, 1)) != 0;
+}
+#endif
+inline MaskF cmpEq(VecF a, VecF b) { return vceqq_f32(a, b); }
+inline MaskF maskAnd(MaskF a, MaskF b) { return vandq_u32(a, b); }
+inline MaskF maskOr(MaskF a, MaskF b) { return vorrq_u32(a, b); }
+inline MaskF cmpLt(VecF a, VecF b) { return vcltq_f32(a, b); }
+
+inline VecF abs(VecF a) { return vabsq_f32(a); }
+#if defined(__aarch64__)
+inline VecF div(VecF a, VecF b) { return vdivq_f32(a, b); }
+inline VecF sqrt(VecF a) { return vsqrtq_f32(a); }
+inline VecF roundNearest(VecF a) { return vrndnq_f32(a); }
+#else
+// armv7 has no vector divide/sqrt/round: reciprocal estimates refined by two Newton steps
+// (within ~1 ULP, not correctly rounded) and round-half-away via truncation.
+inline VecF div(VecF a, VecF b) {
+    float32x4_t r = vrecpeq_f32(b);
+    r = vmulq_f32(r, vrecpsq_f32(b, r));
+    r = vmulq_f32(r, vrecpsq_f32(b, r));
+    return vmulq_f32(a, r);
+}
+inline VecF sqrt(VecF a) {
+    float32x4_t r = vrsqrteq_f32(a);
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(a, r), r));
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(a, r), r));
+    return vbslq_f32(vceqq_f32(a, vdupq_n_f32(0.0f)), a, vmulq_f32(a, r));
+}
+inline VecF roundNearest(VecF a) {
+    float32x4_t half = vbslq_f32(vcltq_f32(a, vdupq_n_f32(0.0f)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+    return vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(a, half)));
+}
+#endif
+inline VecF pow2i(VecF n) {
+    int32x4_t e = vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127));
+    return vreinterpretq_f32_s32(vshlq_n_s32(e, 23));
+}
+inline VecF frexpMantissa(VecF x) {
+    uint32x4_t bits = vreinterpretq_u32_f32(x);
+    bits = vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f000000));
+    return vreinterpretq_f32_u32(bits);
+}
+inline VecF frexpExponent(VecF x) {
+    int32x4_t e = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_f32(x), 23));
+    return vcvtq_f32_s32(vsubq_s32(e, vdupq_n_s32(126)));
+}
+inline void transposeBlock(const float* src, int srcLd, float* dst, int dstLd) {
+    const float32x4x2_t p01 = vtrnq_f32(vld1q_f32(src), vld1q_f32(src + srcLd));
+    const float32x4x2_t p23 = vtrnq_f32(vld1q_f32(src + 2 * (size_t)srcLd), vld1q_f32(src + 3 * (size_t)srcLd));
+    vst1q_f32(dst, vcombine_f32(vget_low_f32(p01.val[0]), vget_low_f32(p23.val[0])));
+    vst1q_f32(dst + dstLd, vcombine_f32(vget_low_f32(p01.val[1]), vget_low_f32(p23.val[1])));
+    vst1q_f32(dst + 2 * (size_t)dstLd, vcombine_f32(vget_high_f32(p01.val[0]), vget_high_f32(p23.val[0])));
+    vst1q_f32(dst + 3 * (size_t)dstLd, vcombine_f32(vget_high_f32(p01.val[1]), vget_high_f32(p23.val[1])));
+}
+
+// armv7 rounds half away from zero (see roundNearest), arm64 to nearest even
+inline VecF loadInt8(const int8_t* p) {
+    int32_t word;
+    std::memcpy(&word, p, sizeof(word));
+    const int16x8_t h = vmovl_s8(vreinterpret_s8_s32(vdup_n_s32(word)));
+    return vcvtq_f32_s32(vmovl_s16(vget_low_s16(h)));
+}
+inline void storeInt8(int8_t* p, VecF v) {
+    v = vminq_f32(vmaxq_f32(v, vdupq_n_f32(-128.0f)), vdupq_n_f32(127.0f));
+#if defined(__aarch64__)
+    const int32x4_t i = vcvtnq_s32_f32(v);
+#else
+    const int32x4_t i = vcvtq_s32_f32(roundNearest(v));
+#endif
+    const int16x4_t s16 = vqmovn_s32(i);
+    const int8x8_t s8 = vqmovn_s16(vcombine_s16(s16, s16));
+    const int32_t word = vget_lane_s32(vreinterpret_s32_s8(s8), 0);
+    std::memcpy(p, &word, sizeof(word));
+}
+#if defined(__aarch64__)
+inline VecF loadHalf(const uint16_t* p) { return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(p))); }
+inline void storeHalf(uint16_t* p, VecF v) { vst1_u16(p, vreinterpret_u16_f16(vcvt_f16_f32(v))); }
+#else
+inline VecF loadHalf(const uint16_t* p) {
+    const float f[4] = {halfToFloat(p[0]), halfToFloat(p[1]), halfToFloat(p[2]), halfToFloat(p[3])};
+    return vld1q_f32(f);
+}
+inline void storeHalf(uint16_t* p, VecF v) {
+    float f[4];
+    vst1q_f32(f, v);
+    for (int i = 0; i < 4; ++i) p[i] = floatToHalf(f[i]);
+}
+#endif
+
+#else
+
+using VecF = float;
+constexpr int kWidth = 1;
+inline const char* isaName() { return "scalar"; }
+
+inline VecF load(const float* p) { return *p; }
+inline void store(float* p, VecF v) { *p = v; }
+inline VecF set1(float v) { return v; }
+inline VecF add(VecF a, VecF b) { return a + b; }
+inline VecF sub(VecF a, VecF b) { return a - b; }
+inline VecF mul(VecF a, VecF b) { return a * b; }
+inline VecF max(VecF a, VecF b) { return a > b ? a : b; }
+inline VecF min(VecF a, VecF b) { return a < b ? a : b; }
+inline VecF mulAdd(VecF a, VecF b, VecF c) { return a * b + c; }
+
+using MaskF = bool;
+inline MaskF cmpGt(VecF a, VecF b) { return a > b; }
+inline MaskF cmpGe(VecF a, VecF b) { return a >= b; }
+inline VecF select(MaskF m, VecF a, VecF b) { return m ? a : b; }
+inline bool anyTrue(MaskF m) { return m; }
+inline MaskF cmpEq(VecF a, VecF b) { return a == b; }
+inline MaskF maskAnd(MaskF a, MaskF b) { return a && b; }
+inline MaskF maskOr(MaskF a, MaskF b) { return a || b; }
+inline MaskF cmpLt(VecF a, VecF b) { return a < b; }
+
+inline VecF div(VecF a, VecF b) { return a / b; }
+inline VecF sqrt(VecF a) { return std::sqrt(a); }
+inline VecF abs(VecF a) { return std::fabs(a); }
+inline VecF roundNearest(VecF a) { return std::nearbyint(a); }
+inline VecF pow2i(VecF n) { return std::ldexp(1.0f, (int)n); }
+inline VecF frexpMantissa(VecF x) {
+    int e;
+    return std::frexp(x, &e);
+}
+inline VecF frexpExponent(VecF x) {
+    int e;
+    std::frexp(x, &e);
+    return (float)e;
+}
+inline void transposeBlock(const float* src, int, float* dst, int) { *dst = *src; }
+inline VecF loadInt8(const int8_t* p) { return (float)*p; }
+inline void storeInt8(int8_t* p, VecF v) { *p = (int8_t)std::nearbyint(v < -128.0f ? -128.0f : (v > 127.0f ? 127.0f : v)); }
+inline VecF loadHalf(const uint16_t* p) { return halfToFloat(*p); }
+inline void storeHalf(uint16_t* p, VecF v) { *p = floatToHalf(v); }
+
+#endif
+
+// Fills [dst, dst + n) with val, vector body plus scalar tail.
+inline void fill(float* dst, int n, float val) {
+    VecF v = set1(val);
+    int i = 0;
+    for (; i + kWidth <= n; i += kWidth) store(dst + i, v);
+    for (; i < n; ++i) dst[i] = val;
+}
+
+} // namespace simd
+
+#endif //TRAFFIC_SIGN_DETECTION_SIMD_HPP
@@ -0,0 +1,102 @@
+#ifndef TRAFFIC_SIGN_DETECTION_SIMD_MATH_HPP
+#define TRAFFIC_SIGN_DETECTION_SIMD_MATH_HPP
+
+#include "simd.hpp"
+
+// Vectorized float transcendentals on simd::VecF (Cephes-style range reduction + minimax
+// polynomials). Error bounds are the maximum ULP distance from the correctly rounded result,
+// measured by bench/bench_kernels.cpp over every 16th float in the stated range; the AVX2+FMA
+// and SSE2 (no FMA) builds give the same numbers.
+namespace simd {
+
+// exp(x): at most 1 ULP on [-87.3, 88.7]. Overflows to +inf above ~88.72, underflows through
+// the denormals to 0 below ~-103.9, NaN in -> NaN out.
+inline VecF exp(VecF x) {
+    const VecF lo = set1(-104.0f), hi = set1(89.0f);
+    VecF xc = min(max(x, lo), hi);
+
+    // x = n * ln2 + r, |r| <= ln2 / 2, ln2 split in two for an exact n * ln2_hi
+    VecF n = roundNearest(mul(xc, set1(1.44269504088896341f)));
+    VecF r = sub(xc, mul(n, set1(0.693359375f)));
+    r = sub(r, mul(n, set1(-2.12194440e-4f)));
+
+    VecF p = set1(1.9875691500e-4f);
+    p = mulAdd(p, r, set1(1.3981999507e-3f));
+    p = mulAdd(p, r, set1(8.3334519073e-3f));
+    p = mulAdd(p, r, set1(4.1665795894e-2f));
+    p = mulAdd(p, r, set1(1.6666665459e-1f));
+    p = mulAdd(p, r, set1(5.0000001201e-1f));
+    VecF y = add(mulAdd(p, mul(r, r), r), set1(1.0f));
+
+    // Scale by 2^n in two halves so every factor stays a normal float (n spans [-150, 128])
+    VecF half = roundNearest(mul(n, set1(0.5f)));
+    y = mul(mul(y, pow2i(half)), pow2i(sub(n, half)));
+    return select(cmpEq(x, x), y, x);
+}
+
+// log(x): at most 1 ULP for x > 0 (denormals included). log(0) = -inf, log(+inf) = +inf,
+// negative or NaN -> NaN.
+inline VecF log(VecF x) {
+    // Lift denormals into the normal range so the exponent/mantissa split works
+    MaskF tiny = cmpLt(x, set1(1.17549435e-38f));
+    VecF xs = select(tiny, mul(x, set1(8388608.0f)), x); // 2^23
+    VecF e = sub(frexpExponent(xs), select(tiny, set1(23.0f), set1(0.0f)));
+    VecF m = frexpMantissa(xs);
+
+    // Centre the mantissa on 1: m in [sqrt(0.5), sqrt(2))
+    MaskF small = cmpLt(m, set1(0.707106781186547524f));
+    e = sub(e, select(small, set1(1.0f), set1(0.0f)));
+    m = sub(add(m, select(small, m, set1(0.0f))), set1(1.0f));
+
+    VecF z = mul(m, m);
+    VecF p = set1(7.0376836292e-2f);
+    p = mulAdd(p, m, set1(-1.1514610310e-1f));
+    p = mulAdd(p, m, set1(1.1676998740e-1f));
+    p = mulAdd(p, m, set1(-1.2420140846e-1f));
+    p = mulAdd(p, m, set1(1.4249322787e-1f));
+    p = mulAdd(p, m, set1(-1.6668057665e-1f));
+    p = mulAdd(p, m, set1(2.0000714765e-1f));
+    p = mulAdd(p, m, set1(-2.4999993993e-1f));
+    p = mulAdd(p, m, set1(3.3333331174e-1f));
+    VecF y = mul(mul(p, m), z);
+    y = mulAdd(e, set1(-2.12194440e-4f), y);
+    y = mulAdd(z, set1(-0.5f), y);
+    y = add(add(m, y), mul(e, set1(0.693359375f)));
+
+    const VecF zero = set1(0.0f);
+    const VecF inf = set1(__builtin_huge_valf());
+    y = select(cmpEq(x, zero), set1(-__builtin_huge_valf()), y);
+    y = select(cmpEq(x, inf), inf, y);
+    y = select(cmpLt(x, zero), set1(__builtin_nanf("")), y);
+    return select(cmpEq(x, x), y, x);
+}
+
+// tanh(x): at most 1 ULP on [-20, 20]. Odd polynomial below |x| = 0.625, 1 - 2 / (e^2|x| + 1)
+// above it, saturating to +-1.
+inline VecF tanh(VecF x) {
+    VecF ax = abs(x);
+
+    VecF z = mul(x, x);
+    VecF p = set1(-5.70498872745e-3f);
+    p = mulAdd(p, z, set1(2.06390887954e-2f));
+    p = mulAdd(p, z, set1(-5.37397155531e-2f));
+    p = mulAdd(p, z, set1(1.33314422036e-1f));
+    p = mulAdd(p, z, set1(-3.33332819422e-1f));
+    VecF small = mulAdd(mul(p, z), x, x);
+
+    VecF t = exp(add(ax, ax));
+    VecF large = sub(set1(1.0f), div(set1(2.0f), add(t, set1(1.0f))));
+    large = select(cmpLt(x, set1(0.0f)), sub(set1(0.0f), large), large);
+
+    return select(cmpLt(ax, set1(0.625f)), small, large);
+}
+
+// 1 / (1 + exp(-x)): at most 2 ULP on [-87, 20], exactly 0 / 1 once exp saturates.
+inline VecF sigmoid(VecF x) {
+    VecF e = exp(sub(set1(0.0f), x));
+    return div(set1(1.0f), add(set1(1.0f), e));
+}
+
+} // namespace simd
+
+#endif //TRAFFIC_SIGN_DETECTION_SIMD_MATH_HPP
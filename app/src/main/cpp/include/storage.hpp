@@ -0,0 +1,38 @@
+#ifndef TRAFFIC_SIGN_DETECTION_STORAGE_HPP
+#define TRAFFIC_SIGN_DETECTION_STORAGE_HPP
+
+#include <cstddef>
+#include <memory>
+#include "allocator.hpp"
+#include "memory_tracker.hpp"
+
+// Flat float buffer shared by a tensor and every view taken from it. Tensors hold it through a
+// std::shared_ptr, so slicing/transposing/broadcasting only copies shape and stride metadata and
+// the buffer is released with the last tensor that references it. Owned buffers are accounted in
+// MemoryTracker under the tag current at allocation.
+class Storage {
+public:
+    Storage() = default;
+    ~Storage();
+    Storage(const Storage&) = delete;
+    Storage& operator=(const Storage&) = delete;
+
+    // Owning buffer of n floats from `allocator` (the thread's current one if null), zero-filled
+    // unless the caller is about to overwrite all of it
+    static std::shared_ptr<Storage> allocate(size_t n, Allocator* allocator = nullptr, bool zeroed = true);
+    // Non-owning wrapper over caller memory (e.g. a JNI direct ByteBuffer) that must outlive it
+    static std::shared_ptr<Storage> wrap(float* data, size_t n);
+
+    float* data() { return ptr; }
+    const float* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool isExternal() const { return allocator == nullptr && ptr != nullptr; }
+
+private:
+    float* ptr = nullptr;
+    size_t count = 0;
+    Allocator* allocator = nullptr; // owner of ptr; null for wrapped memory
+    MemoryTag tag = MemoryTag::Activation;
+};
+
+#endif //TRAFFIC_SIGN_DETECTION_STORAGE_HPP
@@ -0,0 +1,54 @@
+#ifndef TRAFFIC_SIGN_DETECTION_STRIDED_COPY_HPP
+#define TRAFFIC_SIGN_DETECTION_STRIDED_COPY_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Copy engine behind makeContiguous/clone/toContiguous. A strided source is first reduced to
+// its simplest equivalent: size-1 dims dropped, neighbours that are contiguous in both source
+// and destination merged. What is left is run as one of
+//   - a flat copy (the source was packed after all),
+//   - row copies (stride-1 inner dim, e.g. slices and narrowed views),
+//   - batched 2-D transposes (some other dim has stride 1: NCHW <-> NHWC, matrix transpose),
+//     cache-blocked with simd::transposeBlock on whole register blocks,
+//   - a gather for everything else (stepped slices, broadcast dims).
+// Work above kDefaultGrainSize elements is split across the ThreadPool.
+//
+// binary() runs elementwise ops over the same kind of loop nest, with three stride sets (the
+// output and both inputs). Broadcast inputs carry stride 0 and are never expanded: the inner
+// row reads them as a scalar (channel / scalar-like operands) or as one reused row (row bias).
+//
+// unary() runs an in-place row kernel over a strided view (a narrowed or stepped slice) the same
+// way, so the results land in the view's storage instead of a packed copy.
+namespace strided {
+
+enum class BinaryOp { Add, Sub, Mul, Div };
+
+// dst[c * dstLd + r] = src[r * srcLd + c] for r < rows, c < cols
+void transpose2d(const float* src, int srcLd, float* dst, int dstLd, int rows, int cols);
+
+// Writes the tensor (shape, element strides) rooted at src into dst in row-major order. The
+// FP16 (raw half bits) and INT8 overloads take the same paths, with scalar transposes.
+void pack(const float* src, const std::vector<int>& shape, const std::vector<int>& strides, float* dst);
+void pack(const uint16_t* src, const std::vector<int>& shape, const std::vector<int>& strides, uint16_t* dst);
+void pack(const int8_t* src, const std::vector<int>& shape, const std::vector<int>& strides, int8_t* dst);
+
+// The inverse of pack(): writes row-major src through (shape, element strides) rooted at dst.
+// Elements must not repeat. Used to write INT8 results back into a strided view.
+void scatter(const int8_t* src, const std::vector<int>& shape, const std::vector<int>& strides, int8_t* dst);
+
+// out = a op b elementwise over `shape`, every side addressed through its own element strides
+// (0 along broadcast dims). out may be a itself (in-place) but must not otherwise overlap a or b.
+void binary(BinaryOp op, const std::vector<int>& shape, float* out, const std::vector<int>& outStrides,
+            const float* a, const std::vector<int>& aStrides, const float* b, const std::vector<int>& bStrides);
+
+// fn(row, n) over every element of the tensor (shape, element strides) rooted at x, in place.
+// Unit-stride rows are passed as they are, others are gathered into scratch and scattered back.
+// Elements must not repeat (no stride-0 dims with size > 1).
+void unary(const std::vector<int>& shape, float* x, const std::vector<int>& strides,
+           const std::function<void(float*, int)>& fn);
+
+} // namespace strided
+
+#endif //TRAFFIC_SIGN_DETECTION_STRIDED_COPY_HPP
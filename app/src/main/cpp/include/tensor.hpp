@@ -5,8 +5,24 @@
 #include <cassert>
 #include <numeric>
 #include <functional>
+#include <memory>
+#include "quantize.hpp"
+#include "reduce.hpp"
+#include "storage.hpp"
 
-enum class Device { CPU, GPU };
+// Physical element order of an image tensor. NCHW tensors carry the logical [N, C, H, W] shape
+// (and every non-image tensor is NCHW, "as shaped"); the others carry their physical shape and
+// the tag says where the channels are:
+//   NHWC    [N, H, W, C]                channels interleaved per pixel, like camera frames
+//   NCHWc4  [N, ceil(C / 4), H, W, 4]   channels in blocks of 4 / 8 innermost, so one pixel of
+//   NCHWc8  [N, ceil(C / 8), H, W, 8]   a block is one SIMD vector; lanes past C are padding
+enum class MemoryFormat { NCHW, NHWC, NCHWc4, NCHWc8 };
+
+int channelBlock(MemoryFormat format); // 4 / 8 for the blocked formats, 1 otherwise
+const char* memoryFormatName(MemoryFormat format);
+
+class TensorExpr;
+namespace strided { enum class BinaryOp; }
 
 class Tensor {
 public:
@@ -14,6 +30,65 @@ public:
     Tensor(const std::vector<int>& shape_, Device dev = Device::CPU);
     ~Tensor();
 
+    // No implicit copies: moves hand over storage (and GPU buffers), clone() is the explicit
+    // O(N) deep copy and the view functions below share storage.
+    Tensor(const Tensor&) = delete;
+    Tensor& operator=(const Tensor&) = delete;
+    Tensor(Tensor&& other) noexcept;
+    Tensor& operator=(Tensor&& other) noexcept;
+
+    // Packed copy with its own storage (and gradient buffer, if one exists)
+    Tensor clone() const;
+
+    // Non-owning CPU view over caller memory (e.g. a JNI direct ByteBuffer). The caller keeps
+    // `data` alive for the tensor's lifetime; views have no gradient buffer.
+    static Tensor fromBuffer(float* data, const std::vector<int>& shape_);
+    // CPU tensor with uninitialized contents, for outputs that are written in full
+    static Tensor empty(const std::vector<int>& shape_);
+
+    // O(1) CPU views over this tensor's storage: only shape/strides/offset change and writes
+    // through a view land in the source, including in-place ops on strided slices. Only a
+    // broadcast view (stride-0 dims) cannot hold one result per element: in-place ops, like
+    // makeContiguous/reshape/flatten on any non-contiguous view, give it its own packed copy,
+    // after which it no longer aliases its source.
+    Tensor view() const;
+    Tensor slice(int dim, int start, int end, int step = 1) const; // [start, end) every step
+    Tensor narrow(int dim, int start, int length) const;
+    Tensor select(int dim, int index) const; // drops `dim`
+    Tensor toContiguous() const; // view when already contiguous, packed copy otherwise
+
+    // Memory format (see MemoryFormat). view(), slice(), clone() and packed copies keep it;
+    // reshape/flatten/transpose/select/broadcast give plain NCHW ("as shaped") tensors.
+    // Zeroed CPU image tensor of logical shape [N, C, H, W] stored in `format`
+    static Tensor withMemoryFormat(const std::vector<int>& nchwShape, MemoryFormat format);
+    Tensor toMemoryFormat(MemoryFormat format) const; // view when already packed in `format`, converted copy otherwise
+    // Reinterprets the current shape as `format` without touching the data (e.g. an NHWC JNI
+    // buffer); blocked formats take the logical channel count, 0 meaning every lane is used.
+    void setMemoryFormat(MemoryFormat format, int channels = 0);
+    MemoryFormat getMemoryFormat() const;
+    int getChannels() const; // logical C of an image tensor in any format
+    std::vector<int> getLogicalShape() const; // [N, C, H, W] of an image tensor in any format
+
+    // Element type (see DType). FP16 / INT8 tensors are compact storage for activations and
+    // weights: views and clone() keep the dtype, toDType() converts, and addTensor / addBias /
+    // ReLU run INT8 kernels directly. Everything else, including data() and at(), needs FP32 and
+    // throws std::invalid_argument (after logging) on another dtype.
+    // Views of any dtype pack and convert correctly; per-channel params follow the channel axis
+    // through slice / select / transpose / broadcast (addBias: NCHW, per-tensor or axis 1).
+    // Zeroed CPU tensor of `dtype`; INT8 requires params (per-channel axis sized to match)
+    static Tensor withDType(const std::vector<int>& shape_, DType dtype, const QuantParams& params = QuantParams());
+    // Converted copy (view when already `dtype` with the same params). INT8 without params is
+    // calibrated per tensor from the data range.
+    Tensor toDType(DType dtype, const QuantParams& params = QuantParams()) const;
+    // Min/max INT8 params of this FP32 tensor, per tensor or per channel along `axis`
+    QuantParams calibrate(int axis = -1) const;
+    DType getDType() const;
+    const QuantParams& getQuantParams() const; // empty unless INT8
+    int8_t* dataInt8();
+    const int8_t* dataInt8() const;
+    uint16_t* dataHalf();
+    const uint16_t* dataHalf() const;
+
     float& at(int i);
     float& at(int i, int j);
     float& at(int i, int j, int k);
@@ -21,6 +96,17 @@ public:
 
     void edit(const std::vector<int>& index, float val);
 
+    // Raw access for native kernels (preprocessing, decode) that write straight into the buffer
+    float* data();
+    const float* data() const;
+    const std::vector<int>& getShape() const;
+    int size() const;
+    bool isContiguous() const;
+    int getOffset() const;
+    const std::vector<int>& getStrides() const;
+    bool sharesStorage() const;
+    Device getDevice() const;
+
     // Utility
     void fill(float val);
 
@@ -29,11 +115,15 @@ public:
 
     void transpose(const std::vector<int>& order);
 
-    Tensor broadcast(const std::vector<int>& newShape);
+    Tensor broadcast(const std::vector<int>& newShape) const; // stride-0 view, no copy
 
     void makeContiguous(); // for now our function will mutate the current tensor to be contiguous, if needed a function that returns a new contiguous tensor will be made
 
     // Arithmetic
+    // The *Tensor ops broadcast NumPy style on the CPU: `other` may have fewer dims or size-1
+    // dims (e.g. [C, 1, 1] against [N, C, H, W]) and is read through stride-0 dims in place.
+    // The result keeps this tensor's shape. NHWC / blocked tensors need an equal-shape operand
+    // in the same format; GPU tensors need equal shapes.
     void addTensor(const Tensor& other);
     void addScalar(float val);
     void addBias(const Tensor& bias);
@@ -45,11 +135,45 @@ public:
     void multiplyScalar(float val);
     void multiplyBias(const Tensor& bias);
 
+    // x * scale[c] + shift[c] for channel c along `axis`, in one pass (e.g. mean/std
+    // normalization with scale = 1 / std, shift = -mean / std). Tensors in NHWC / blocked
+    // formats take the logical channel axis 1.
+    void channelAffine(const Tensor& scale, const Tensor& shift, int axis = 1);
+
     void divideTensor(const Tensor& other);
     void divideScalar(float val);
 
+    // Out-of-place a op b into a new CPU tensor of the broadcast shape of a and b
+    static std::vector<int> broadcastShape(const std::vector<int>& a, const std::vector<int>& b);
+    static Tensor add(const Tensor& a, const Tensor& b);
+    static Tensor subtract(const Tensor& a, const Tensor& b);
+    static Tensor multiply(const Tensor& a, const Tensor& b);
+    static Tensor divide(const Tensor& a, const Tensor& b);
+
     void negate();
 
+    // Records chained elementwise ops and runs them as one fused pass on eval() (tensor_expr.hpp)
+    TensorExpr expr();
+
+    // Matrix product over the last two dims: [..., M, K] x [..., K, N] -> [..., M, N] (CPU).
+    // Batch dims must match, or one side is plain 2-D and shared across the other's batch.
+    // Transposed views (e.g. after transpose()) are read in place through sgemm's trans flags.
+    Tensor matmul(const Tensor& other) const;
+
+    // Reductions along `axis` (negative counts from the back) into new CPU tensors (reduce.hpp).
+    // The axis is dropped unless keepDims leaves it as size 1 (a 1-D tensor reduces to [1]).
+    // Indices are stored as floats. NHWC / blocked tensors reduce over their logical NCHW axes.
+    Tensor sum(int axis, bool keepDims = false, reduce::Summation mode = reduce::Summation::Pairwise) const;
+    Tensor mean(int axis, bool keepDims = false, reduce::Summation mode = reduce::Summation::Pairwise) const;
+    Tensor max(int axis, bool keepDims = false) const;
+    Tensor argmax(int axis, bool keepDims = false) const;
+    Tensor logSumExp(int axis, bool keepDims = false) const;
+    // The k largest along `axis` in descending order; values and indices get that axis resized to k
+    void topK(int k, int axis, Tensor& values, Tensor& indices) const;
+    // Max-shifted (overflow-free) softmax / log-softmax along `axis`, same shape
+    Tensor softmax(int axis) const;
+    Tensor logSoftmax(int axis) const;
+
     void ReLU();
     void sigmoid();
     void tanh();
@@ -62,7 +186,12 @@ public:
     void log();
 
     // Gradiant
-    void zeroGrad();
+    // Off by default: the gradient buffer is only allocated (zeroed) on the first grad() call,
+    // so inference tensors cost one buffer instead of two.
+    void setRequiresGrad(bool enabled);
+    bool requiresGrad() const;
+    float* grad();
+    void zeroGrad(); // no-op until a gradient buffer exists
 
     // testing util
     void printShape();
@@ -85,12 +214,27 @@ private:
     std::vector<int> strides;
 
     // CPU DATA
-    std::vector<float> cpuData;
-    std::vector<float> cpuGrad;
+    std::shared_ptr<Storage> storage;
+    int offset = 0; // element offset of index 0 into storage
+    std::vector<float> cpuGrad; // empty until grad() is first called
+    bool gradEnabled = false;
+
+    MemoryFormat format = MemoryFormat::NCHW;
+    int blockedChannels = 0; // logical C of a blocked tensor (the rest of the last block is padding)
+
+    DType dtype = DType::FP32;
+    std::shared_ptr<const QuantParams> quant; // INT8 only, shared with views and clones
 
     void computeStrides();
+    bool hasContiguousStrides() const;
+    bool isDense() const; // covers a gap-free block of storage in some dimension order
+    bool isImageShaped() const; // rank matches the format: 4 for NCHW/NHWC, 5 for blocked
+    int elementOffset(int n, int c, int h, int w) const; // logical image index -> data() offset
 
     void makeContiguousCpu();
+    bool repeatsElements() const; // stride-0 dims of size > 1 (broadcast views)
+    // kernel(x, n) over every element in place: flat when dense, strided through views otherwise
+    template <typename Kernel> void unaryCpu(Kernel kernel);
 
     void fillCpu(float val);
     void addTensorCpu(const Tensor& other);
@@ -103,10 +247,18 @@ private:
     void multiplyTensorCpu(const Tensor& other);
     void multiplyScalarCpu(float val);
     void multiplyBiasCpu(const Tensor& bias);
+    void channelAffineCpu(const Tensor* scale, const Tensor* shift, int axis); // null side = identity
 
     void divideTensorCpu(const Tensor& other);
     void divideScalarCpu(float val);
 
+    void binaryCpu(const Tensor& other, strided::BinaryOp op); // this = this op other, other broadcast to this shape
+    static Tensor binary(const Tensor& a, const Tensor& b, strided::BinaryOp op, const char* opName);
+
+    // Packed NCHW copy (or view) to reduce, with `axis` normalized and the [outer, n, inner] split
+    Tensor reductionInput(int& axis, int& outer, int& n, int& inner) const;
+    static std::vector<int> reducedShape(std::vector<int> shape, int axis, bool keepDims, int size = 1);
+
     void negateCpu();
 
     void ReLUCpu();
@@ -120,13 +272,23 @@ private:
     void expCpu();
     void logCpu();
 
+    const void* rawData() const; // first element of any dtype
+    // kernel(t) on this INT8 tensor packed: strided views run on a copy that is scattered back
+    template <typename Kernel> void int8Cpu(Kernel kernel);
+    void addTensorInt8(const Tensor& other);
+    void addBiasInt8(const Tensor& bias);
+    void ReLUInt8();
+
     void zeroGradCpu();
 
 #ifdef USE_CUDA
     float* gpuData = nullptr;
     float* gpuGrad = nullptr;
+    MemoryTag gpuTag = MemoryTag::Activation; // tag gpuData / gpuGrad were accounted under
 
     void freeGpuMemory();
+    void freeGpuGrad();
+    void cloneGpu(Tensor& dst) const;
 
     void makeContiguousGpu();
 
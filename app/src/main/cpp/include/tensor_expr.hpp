@@ -0,0 +1,73 @@
+#ifndef TRAFFIC_SIGN_DETECTION_TENSOR_EXPR_HPP
+#define TRAFFIC_SIGN_DETECTION_TENSOR_EXPR_HPP
+
+#include <vector>
+#include "tensor.hpp"
+
+enum class ExprOp {
+    AddScalar, SubScalar, MulScalar, DivScalar,
+    AddTensor, SubTensor, MulTensor, DivTensor,
+    AddBias, MulBias,
+    Negate, ReLU, LReLU, ELU, Sigmoid, Tanh,
+    Square, Sqrt, Exp, Log
+};
+
+// Records a chain of elementwise ops on a CPU tensor and runs them as one fused in-place pass:
+//   t.expr().mul(2.0f).addBias(bias).relu().eval();
+// eval() walks the tensor in L1-sized blocks and applies every recorded op to a block before
+// moving on, so each element is read and written once instead of once per op. Results match
+// the corresponding Tensor methods applied in sequence.
+//
+// Tensor operands are captured as views: same-shape or numpy-broadcastable to the target
+// (stride-0 dims are gathered per block). Bias operands are [C] vectors over the channels of
+// an image target in any memory format, like Tensor::addBias. Operand storage stays alive
+// until eval().
+class TensorExpr {
+public:
+    explicit TensorExpr(Tensor& target);
+
+    TensorExpr& add(float val);
+    TensorExpr& sub(float val);
+    TensorExpr& mul(float val);
+    TensorExpr& div(float val);
+
+    TensorExpr& add(const Tensor& other);
+    TensorExpr& sub(const Tensor& other);
+    TensorExpr& mul(const Tensor& other);
+    TensorExpr& div(const Tensor& other);
+
+    TensorExpr& addBias(const Tensor& bias);
+    TensorExpr& mulBias(const Tensor& bias);
+
+    TensorExpr& neg();
+    TensorExpr& relu();
+    TensorExpr& lrelu(float alpha);
+    TensorExpr& elu(float alpha);
+    TensorExpr& sigmoid();
+    TensorExpr& tanh();
+    TensorExpr& square();
+    TensorExpr& sqrt();
+    TensorExpr& exp();
+    TensorExpr& log();
+
+    // Runs the recorded chain over the target in place (through its strides when it is a view)
+    // and clears it
+    Tensor& eval();
+
+private:
+    struct Node {
+        ExprOp op;
+        float scalar;
+        int operand; // index into operands, -1 for scalar/unary ops
+    };
+
+    Tensor& target;
+    std::vector<Node> nodes;
+    std::vector<Tensor> operands;
+
+    TensorExpr& push(ExprOp op, float scalar = 0.0f, int operand = -1);
+    TensorExpr& pushTensor(ExprOp op, const Tensor& other);
+    TensorExpr& pushBias(ExprOp op, const Tensor& bias);
+};
+
+#endif //TRAFFIC_SIGN_DETECTION_TENSOR_EXPR_HPP
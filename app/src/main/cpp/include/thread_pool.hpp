@@ -0,0 +1,84 @@
+#ifndef TRAFFIC_SIGN_DETECTION_THREAD_POOL_HPP
+#define TRAFFIC_SIGN_DETECTION_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Ranges shorter than this many elements run on the calling thread: below ~128 KB of floats
+// the wake-up and hand-off cost more than the loop itself.
+constexpr int kDefaultGrainSize = 32768;
+
+// Process-wide work-stealing pool for splitting large tensor loops across cores.
+// parallelFor() cuts a range into chunks, deals them round-robin onto per-thread deques and
+// helps execute them on the calling thread; idle workers steal from the front of other
+// deques. Calls from inside a pool task run inline, so kernels can nest freely.
+class ThreadPool {
+public:
+    // Singleton pattern; starts hardware_concurrency() threads (caller included) on first use
+    static ThreadPool& getInstance();
+
+    // Restarts the workers; call it while no parallelFor is in flight (e.g. at startup).
+    // numThreads counts the calling thread (1 = everything inline). A non-empty `cpus` pins
+    // every worker to that CPU set, e.g. bigCoreIds() on big.LITTLE.
+    void configure(int numThreads, const std::vector<int>& cpus = {});
+    int getThreadCount() const;
+
+    // Runs fn(chunkBegin, chunkEnd) over [begin, end) in chunks of at least grainSize elements
+    // and blocks until all chunks are done. With grainSize >= 16, chunk sizes are multiples of
+    // 16 (one cache line of floats) so neighbouring chunks never share a line.
+    void parallelFor(int begin, int end, int grainSize, const std::function<void(int, int)>& fn);
+
+    // CPUs with the highest cpuinfo_max_freq (the big cluster); every online CPU when the
+    // cpufreq tree is unavailable.
+    static std::vector<int> bigCoreIds();
+    // Pins the calling thread to `cpus` (Linux/Android only). Returns false if unsupported.
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+    ThreadPool();
+
+    struct Job {
+        const std::function<void(int, int)>* fn;
+        int remaining;
+        std::mutex mtx;
+        std::condition_variable done;
+    };
+
+    struct Task {
+        Job* job;
+        int begin;
+        int end;
+    };
+
+    struct TaskQueue {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<TaskQueue>> queues; // one per worker, the last one for callers
+    std::vector<int> affinity;
+    std::atomic<int> queued{0};
+    std::atomic<unsigned> nextQueue{0};
+    std::mutex wakeMtx;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void start(int numThreads);
+    void stop();
+    void workerLoop(int index);
+    bool popTask(int self, Task& out);
+    static void runTask(const Task& task);
+};
+
+#endif //TRAFFIC_SIGN_DETECTION_THREAD_POOL_HPP
@@ -0,0 +1,74 @@
+#ifndef TRAFFIC_SIGN_DETECTION_TRACE_HPP
+#define TRAFFIC_SIGN_DETECTION_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Timeline spans for one capture of the whole frame pipeline (preprocess, inference, decode,
+// NMS, cascade refine), exported as Chrome trace-event JSON for chrome://tracing or
+// ui.perfetto.dev. TSR_TRACE_SCOPE("decode") records the enclosing scope into the calling
+// thread's own buffer: no locks and no shared writes on the hot path. Recording is off until
+// start(); while off a scope costs one relaxed load. Build with TSR_TRACE=0 to compile the
+// scopes out entirely.
+namespace trace {
+
+namespace detail {
+extern std::atomic<bool> enabled;
+} // namespace detail
+
+// Steady clock in nanoseconds; on Android the same clock as System.nanoTime()
+inline int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline bool isEnabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+void start();
+// Spans already open when recording stops are still recorded when they close
+void stop();
+
+// Records a finished span on the calling thread. `name` must stay valid until the span is
+// exported: a string literal, or intern() for names built at runtime.
+void record(const char* name, int64_t beginNs, int64_t endNs);
+const char* intern(const std::string& name);
+
+// Every span recorded since the previous export as {"traceEvents": [...]} with complete
+// ("X") events, ts/dur in microseconds at nanosecond resolution, pid and OS thread id.
+// Exporting releases the spans' memory, so buffers only grow between exports.
+std::string exportChromeJson();
+bool writeChromeJson(const std::string& path); // false if the file cannot be written
+
+class Scope {
+public:
+    explicit Scope(const char* name) : name(isEnabled() ? name : nullptr), begin(this->name != nullptr ? nowNs() : 0) {}
+    ~Scope() {
+        if (name != nullptr) record(name, begin, nowNs());
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name;
+    int64_t begin;
+};
+
+} // namespace trace
+
+#ifndef TSR_TRACE
+#define TSR_TRACE 1
+#endif
+
+#if TSR_TRACE
+#define TSR_TRACE_CONCAT_(a, b) a##b
+#define TSR_TRACE_CONCAT(a, b) TSR_TRACE_CONCAT_(a, b)
+#define TSR_TRACE_SCOPE(name) trace::Scope TSR_TRACE_CONCAT(tsrTraceScope, __LINE__)(name)
+#else
+#define TSR_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+#endif //TRAFFIC_SIGN_DETECTION_TRACE_HPP
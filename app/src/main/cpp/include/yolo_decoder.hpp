@@ -0,0 +1,36 @@
+#ifndef TRAFFIC_SIGN_DETECTION_YOLO_DECODER_HPP
+#define TRAFFIC_SIGN_DETECTION_YOLO_DECODER_HPP
+
+#include <cstddef>
+#include <vector>
+#include "preprocess.hpp"
+
+// Structure-of-arrays candidate list, boxes in source-frame pixel coordinates.
+struct DetectionCandidates {
+    std::vector<float> x1;
+    std::vector<float> y1;
+    std::vector<float> x2;
+    std::vector<float> y2;
+    std::vector<float> score;
+    std::vector<int> classId;
+
+    size_t size() const { return score.size(); }
+    void clear();
+    void reserve(size_t n);
+    void push(float bx1, float by1, float bx2, float by2, float s, int cls);
+};
+
+// Decodes a YOLOv8 head laid out as [1, 4 + numClasses, numAnchors] (rows 0-3 = cx, cy, w, h
+// in letterbox space, rows 4+ = class scores). Per-anchor max/argmax is computed with
+// row-major SIMD passes over the class rows, anchors scoring below confThreshold are dropped,
+// and survivors are mapped back through `letterbox` into `out` (cleared first).
+// Returns the number of candidates written.
+size_t decodeYolo(const float* output, int numClasses, int numAnchors, float confThreshold,
+                  const LetterboxInfo& letterbox, DetectionCandidates& out);
+
+// Tensor overload for a contiguous CPU head of shape [1, 4 + numClasses, numAnchors],
+// typically a Tensor::fromBuffer view over the ONNX Runtime output.
+size_t decodeYolo(const Tensor& output, float confThreshold, const LetterboxInfo& letterbox,
+                  DetectionCandidates& out);
+
+#endif //TRAFFIC_SIGN_DETECTION_YOLO_DECODER_HPP
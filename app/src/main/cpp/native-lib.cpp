@@ -1,12 +1,27 @@
 #include <jni.h>
 #include <string>
+#include "allocator.hpp"
 #include "logger.hpp"
+#include "memory_tracker.hpp"
+#include "metrics.hpp"
+#include "preprocess.hpp"
+#include "yolo_decoder.hpp"
+#include "nms.hpp"
+#include "trace.hpp"
 
 #ifdef OPENCV_ENABLED
 #include <opencv2/opencv.hpp>
 #include "tensor.hpp"
 #endif
 
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* /* vm */, void* /* reserved */) {
+    // Tensors that outlive a frame (the OpenCV path, anything cached across calls) come from one
+    // shared pool; per-frame tensors use the calling thread's arena (FrameAllocatorScope below)
+    static PoolAllocator* pool = new PoolAllocator();
+    setDefaultAllocator(pool);
+    return JNI_VERSION_1_6;
+}
+
 extern "C" JNIEXPORT jstring JNICALL
 Java_com_example_tsrapp_ui_main_MainActivity_stringFromJNI(
         JNIEnv* env,
@@ -34,6 +49,7 @@ Java_com_example_tsrapp_ui_main_MainActivity_processImage(
         return env->NewStringUTF("Error: Could not load image");
     }
 
+    MemoryTagScope tag(MemoryTag::Preproc);
     Tensor t = Tensor::fromMat(img);
     t.multiplyScalar(2.0f);
 
@@ -46,3 +62,272 @@ Java_com_example_tsrapp_ui_main_MainActivity_processImage(
     return env->NewStringUTF("Native image processing requires OpenCV. Using Kotlin ONNX inference path instead.");
 #endif
 }
+
+// ---- NativeBridge: zero-copy frame/tensor surface ----
+// Every buffer below is a direct ByteBuffer owned by Kotlin and reused across frames; native
+// code reads and writes it in place, so no per-frame Java arrays are created or copied.
+
+namespace {
+
+bool hasCapacity(JNIEnv* env, jobject buffer, jlong bytes) {
+    return env->GetDirectBufferCapacity(buffer) >= bytes;
+}
+
+// Tensors created during one frame call come from this thread's arena, rewound when the call
+// returns; after the first frame it holds one chunk and the calls never reach the heap.
+ArenaAllocator& frameArena() {
+    static thread_local ArenaAllocator arena;
+    return arena;
+}
+
+// Tracked native memory that may be live while one frame call runs (the frame's tensors plus
+// whatever else is resident); each call's peak is published as the memory.<stage>.peak gauge
+// and a warning is logged above this.
+constexpr int64_t kFrameMemoryBudget = 64ll << 20;
+
+} // namespace
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_yuv420ToRgba(
+        JNIEnv* env,
+        jobject /* this */,
+        jobject yBuffer,
+        jobject uBuffer,
+        jobject vBuffer,
+        jint width,
+        jint height,
+        jint yRowStride,
+        jint uvRowStride,
+        jint uvPixelStride,
+        jint rotationDegrees,
+        jobject dstBuffer) {
+
+    Yuv420Frame frame;
+    frame.y = static_cast<const uint8_t*>(env->GetDirectBufferAddress(yBuffer));
+    frame.u = static_cast<const uint8_t*>(env->GetDirectBufferAddress(uBuffer));
+    frame.v = static_cast<const uint8_t*>(env->GetDirectBufferAddress(vBuffer));
+    frame.width = width;
+    frame.height = height;
+    frame.yRowStride = yRowStride;
+    frame.uvRowStride = uvRowStride;
+    frame.uvPixelStride = uvPixelStride;
+    auto* dst = static_cast<uint8_t*>(env->GetDirectBufferAddress(dstBuffer));
+    if (frame.y == nullptr || frame.u == nullptr || frame.v == nullptr || dst == nullptr) {
+        LOG_ERROR("yuv420ToRgba requires direct ByteBuffers");
+        return JNI_FALSE;
+    }
+
+    const jlong uvBytes = (jlong)uvRowStride * ((height + 1) / 2 - 1) + (jlong)((width + 1) / 2 - 1) * uvPixelStride + 1;
+    if (!hasCapacity(env, yBuffer, (jlong)yRowStride * (height - 1) + width) ||
+        !hasCapacity(env, uBuffer, uvBytes) || !hasCapacity(env, vBuffer, uvBytes) ||
+        !hasCapacity(env, dstBuffer, (jlong)width * height * 4)) {
+        LOG_ERROR("yuv420ToRgba buffer too small");
+        return JNI_FALSE;
+    }
+
+    const bool swapped = rotationDegrees % 180 != 0;
+    yuv420ToRgba(frame, rotationDegrees, dst, (swapped ? height : width) * 4);
+    return JNI_TRUE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_letterboxNormalize(
+        JNIEnv* env,
+        jobject /* this */,
+        jobject srcBuffer,
+        jint srcWidth,
+        jint srcHeight,
+        jint srcRowStride,
+        jint pixelFormat,
+        jobject dstBuffer,
+        jint dstSize) {
+
+    auto* src = static_cast<const uint8_t*>(env->GetDirectBufferAddress(srcBuffer));
+    auto* dst = static_cast<float*>(env->GetDirectBufferAddress(dstBuffer));
+    if (src == nullptr || dst == nullptr) {
+        LOG_ERROR("letterboxNormalize requires direct ByteBuffers");
+        return JNI_FALSE;
+    }
+    if (srcWidth <= 0 || srcHeight <= 0 || dstSize <= 0 || (jlong)srcRowStride < (jlong)srcWidth * 4 ||
+        (pixelFormat != (jint)PixelFormat::RGBA8888 && pixelFormat != (jint)PixelFormat::BGRA8888)) {
+        LOG_ERROR("letterboxNormalize invalid frame: " + std::to_string(srcWidth) + "x" + std::to_string(srcHeight) +
+                  " stride " + std::to_string(srcRowStride) + " format " + std::to_string(pixelFormat) +
+                  " -> " + std::to_string(dstSize));
+        return JNI_FALSE;
+    }
+    if (!hasCapacity(env, srcBuffer, (jlong)srcRowStride * srcHeight) ||
+        !hasCapacity(env, dstBuffer, (jlong)3 * dstSize * dstSize * (jlong)sizeof(float))) {
+        LOG_ERROR("letterboxNormalize buffer too small");
+        return JNI_FALSE;
+    }
+
+    MemoryProbe memory("preprocess", kFrameMemoryBudget);
+    FrameAllocatorScope frame(frameArena());
+    Tensor input = Tensor::fromBuffer(dst, {1, 3, dstSize, dstSize});
+    letterboxNormalize(src, srcWidth, srcHeight, srcRowStride, static_cast<PixelFormat>(pixelFormat), input);
+    return JNI_TRUE;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_postprocessYolo(
+        JNIEnv* env,
+        jobject /* this */,
+        jobject outputBuffer,
+        jint numClasses,
+        jint numAnchors,
+        jfloat confThreshold,
+        jfloat iouThreshold,
+        jboolean classAware,
+        jint padX,
+        jint padY,
+        jfloat scale,
+        jobject resultBuffer,
+        jint maxResults) {
+
+    auto* output = static_cast<float*>(env->GetDirectBufferAddress(outputBuffer));
+    auto* results = static_cast<float*>(env->GetDirectBufferAddress(resultBuffer));
+    if (output == nullptr || results == nullptr) {
+        LOG_ERROR("postprocessYolo requires direct ByteBuffers");
+        return -1;
+    }
+    if (!hasCapacity(env, outputBuffer, (jlong)(4 + numClasses) * numAnchors * (jlong)sizeof(float)) ||
+        !hasCapacity(env, resultBuffer, (jlong)maxResults * 6 * (jlong)sizeof(float))) {
+        LOG_ERROR("postprocessYolo buffer too small");
+        return -1;
+    }
+
+    LetterboxInfo letterbox;
+    letterbox.padX = padX;
+    letterbox.padY = padY;
+    letterbox.scale = scale;
+
+    NmsConfig nms;
+    nms.iouThreshold = iouThreshold;
+    nms.classAware = classAware == JNI_TRUE;
+    nms.maxDetections = maxResults;
+
+    MemoryProbe memory("postprocess", kFrameMemoryBudget);
+    FrameAllocatorScope frame(frameArena());
+    static thread_local DetectionCandidates candidates;
+    static thread_local std::vector<int> keep;
+    Tensor head = Tensor::fromBuffer(output, {1, 4 + numClasses, numAnchors});
+    decodeYolo(head, confThreshold, letterbox, candidates);
+    size_t n = nonMaxSuppression(candidates, nms, keep);
+
+    // Rows of [x1, y1, x2, y2, score, classId], highest score first
+    for (size_t k = 0; k < n; ++k) {
+        const int i = keep[k];
+        float* d = results + k * 6;
+        d[0] = candidates.x1[i];
+        d[1] = candidates.y1[i];
+        d[2] = candidates.x2[i];
+        d[3] = candidates.y2[i];
+        d[4] = candidates.score[i];
+        d[5] = (float)candidates.classId[i];
+    }
+    return (jint)n;
+}
+
+// ---- NativeBridge: pipeline trace and latency metrics ----
+// Native stages record TSR_TRACE_SCOPE spans and TSR_LATENCY_SCOPE histograms themselves;
+// Kotlin stages (ONNX inference, cascade refine, whole frames) time themselves with
+// System.nanoTime() and hand the interval over through recordStage.
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_traceStart(
+        JNIEnv* /* env */,
+        jobject /* this */) {
+    trace::start();
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_traceStop(
+        JNIEnv* /* env */,
+        jobject /* this */) {
+    trace::stop();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_isTracing(
+        JNIEnv* /* env */,
+        jobject /* this */) {
+    return trace::isEnabled() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_traceName(
+        JNIEnv* env,
+        jobject /* this */,
+        jstring name) {
+    const char* chars = env->GetStringUTFChars(name, 0);
+    const char* interned = trace::intern(chars);
+    env->ReleaseStringUTFChars(name, chars);
+    return (jlong)(intptr_t)interned;
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_stageHistogram(
+        JNIEnv* env,
+        jobject /* this */,
+        jstring name) {
+    const char* chars = env->GetStringUTFChars(name, 0);
+    Histogram& histogram = Metrics::getInstance().histogram(chars);
+    env->ReleaseStringUTFChars(name, chars);
+    return (jlong)(intptr_t)&histogram;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_recordStage(
+        JNIEnv* /* env */,
+        jobject /* this */,
+        jlong traceName,
+        jlong histogram,
+        jlong beginNs,
+        jlong endNs) {
+    reinterpret_cast<Histogram*>((intptr_t)histogram)->record(endNs - beginNs);
+    if (trace::isEnabled()) trace::record((const char*)(intptr_t)traceName, beginNs, endNs);
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_metricsText(
+        JNIEnv* env,
+        jobject /* this */,
+        jboolean reset) {
+    return env->NewStringUTF(Metrics::getInstance().toText(reset == JNI_TRUE).c_str());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_metricsJson(
+        JNIEnv* env,
+        jobject /* this */,
+        jboolean reset) {
+    return env->NewStringUTF(Metrics::getInstance().toJson(reset == JNI_TRUE).c_str());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_metricsLog(
+        JNIEnv* /* env */,
+        jobject /* this */,
+        jboolean reset) {
+    Metrics::getInstance().logSnapshot(reset == JNI_TRUE);
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_memoryText(
+        JNIEnv* env,
+        jobject /* this */) {
+    return env->NewStringUTF(MemoryTracker::getInstance().snapshot().toText().c_str());
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_tsrapp_ml_NativeBridge_traceWrite(
+        JNIEnv* env,
+        jobject /* this */,
+        jstring path) {
+    const char* chars = env->GetStringUTFChars(path, 0);
+    std::string pathStr(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    const bool ok = trace::writeChromeJson(pathStr);
+    if (!ok) LOG_ERROR("Failed to write trace to " + pathStr);
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
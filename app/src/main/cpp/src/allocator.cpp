@@ -0,0 +1,191 @@
+#include "allocator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <new>
+
+namespace {
+
+constexpr size_t kAlignment = 64;
+constexpr size_t kMinBlockBytes = 256;
+
+thread_local Allocator* threadAllocator = nullptr;
+std::atomic<Allocator*> defaultAllocator{nullptr};
+
+char* systemAlloc(size_t bytes) {
+    return static_cast<char*>(::operator new(bytes, std::align_val_t(kAlignment)));
+}
+
+void systemFree(void* p) {
+    ::operator delete(p, std::align_val_t(kAlignment));
+}
+
+size_t roundUp(size_t v, size_t to) {
+    return (v + to - 1) / to * to;
+}
+
+void noteInUse(AllocatorStats& s, size_t bytesInUse) {
+    s.bytesInUse = bytesInUse;
+    s.highWaterBytes = std::max(s.highWaterBytes, bytesInUse);
+}
+
+// Smallest power-of-two bucket (from kMinBlockBytes up) that holds `bytes`
+int bucketFor(size_t bytes) {
+    int bucket = 0;
+    size_t size = kMinBlockBytes;
+    while (size < bytes) {
+        size <<= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+size_t bucketBytes(int bucket) {
+    return kMinBlockBytes << bucket;
+}
+
+} // namespace
+
+float* HeapAllocator::allocate(size_t n) {
+    const size_t bytes = std::max<size_t>(n, 1) * sizeof(float);
+    float* p = reinterpret_cast<float*>(systemAlloc(bytes));
+    std::lock_guard<std::mutex> lock(mtx);
+    counters.misses++;
+    counters.reservedBytes += bytes;
+    noteInUse(counters, counters.bytesInUse + bytes);
+    return p;
+}
+
+void HeapAllocator::deallocate(float* p, size_t n) {
+    const size_t bytes = std::max<size_t>(n, 1) * sizeof(float);
+    systemFree(p);
+    std::lock_guard<std::mutex> lock(mtx);
+    counters.reservedBytes -= bytes;
+    counters.bytesInUse -= bytes;
+}
+
+AllocatorStats HeapAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return counters;
+}
+
+PoolAllocator::~PoolAllocator() {
+    trim();
+}
+
+float* PoolAllocator::allocate(size_t n) {
+    const int bucket = bucketFor(n * sizeof(float));
+    assert(bucket < kNumBuckets);
+    const size_t bytes = bucketBytes(bucket);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    noteInUse(counters, counters.bytesInUse + bytes);
+    std::vector<float*>& list = freeLists[bucket];
+    if (!list.empty()) {
+        float* p = list.back();
+        list.pop_back();
+        counters.hits++;
+        return p;
+    }
+    counters.misses++;
+    counters.reservedBytes += bytes;
+    return reinterpret_cast<float*>(systemAlloc(bytes));
+}
+
+void PoolAllocator::deallocate(float* p, size_t n) {
+    const int bucket = bucketFor(n * sizeof(float));
+    std::lock_guard<std::mutex> lock(mtx);
+    counters.bytesInUse -= bucketBytes(bucket);
+    freeLists[bucket].push_back(p);
+}
+
+AllocatorStats PoolAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return counters;
+}
+
+void PoolAllocator::trim() {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+        for (float* p : freeLists[bucket]) systemFree(p);
+        counters.reservedBytes -= freeLists[bucket].size() * bucketBytes(bucket);
+        freeLists[bucket].clear();
+    }
+}
+
+ArenaAllocator::ArenaAllocator(size_t initialBytes) {
+    if (initialBytes > 0) addChunk(roundUp(initialBytes, kAlignment));
+}
+
+ArenaAllocator::~ArenaAllocator() {
+    for (const Chunk& c : chunks) systemFree(c.base);
+}
+
+void ArenaAllocator::addChunk(size_t bytes) {
+    chunks.push_back({systemAlloc(bytes), bytes});
+    used = 0;
+    counters.reservedBytes += bytes;
+}
+
+float* ArenaAllocator::allocate(size_t n) {
+    const size_t bytes = roundUp(std::max<size_t>(n, 1) * sizeof(float), kAlignment);
+    if (chunks.empty() || used + bytes > chunks.back().size) {
+        counters.misses++;
+        const size_t last = chunks.empty() ? 0 : chunks.back().size;
+        addChunk(std::max(bytes, last * 2));
+    } else {
+        counters.hits++;
+    }
+
+    float* p = reinterpret_cast<float*>(chunks.back().base + used);
+    used += bytes;
+    liveBlocks++;
+    noteInUse(counters, counters.bytesInUse + bytes);
+    return p;
+}
+
+void ArenaAllocator::deallocate(float*, size_t) {
+    assert(liveBlocks > 0);
+    liveBlocks--; // memory comes back at reset()
+}
+
+AllocatorStats ArenaAllocator::stats() const {
+    return counters;
+}
+
+void ArenaAllocator::reset() {
+    assert(liveBlocks == 0 && "ArenaAllocator::reset() with tensors still alive");
+    if (chunks.size() > 1) {
+        // This frame overflowed: replace the chain with one chunk big enough for all of it
+        size_t total = 0;
+        for (const Chunk& c : chunks) {
+            total += c.size;
+            systemFree(c.base);
+        }
+        chunks.clear();
+        counters.reservedBytes = 0;
+        addChunk(total);
+    }
+    used = 0;
+    counters.bytesInUse = 0;
+}
+
+Allocator& currentAllocator() {
+    // Leaked on purpose: tensors in static storage may be destroyed after any static allocator
+    static HeapAllocator* heap = new HeapAllocator();
+    if (threadAllocator != nullptr) return *threadAllocator;
+    Allocator* fallback = defaultAllocator.load(std::memory_order_acquire);
+    return fallback != nullptr ? *fallback : *heap;
+}
+
+void setDefaultAllocator(Allocator* allocator) {
+    defaultAllocator.store(allocator, std::memory_order_release);
+}
+
+AllocatorScope::AllocatorScope(Allocator& allocator) : previous(threadAllocator) {
+    threadAllocator = &allocator;
+}
+
+AllocatorScope::~AllocatorScope() {
+    threadAllocator = previous;
+}
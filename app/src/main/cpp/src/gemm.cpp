@@ -0,0 +1,321 @@
+#include "gemm.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr int kMR = 6;                  // rows per register tile (12 accumulators + 3 operands fit 16 registers)
+constexpr int kNR = 2 * simd::kWidth;   // columns per register tile
+constexpr int kKC = 256;                // panel depth: one KC x NR panel of B stays in L1
+constexpr int kMC = 120;                // rows per packed A block: MC x KC (~120 KB) stays in L2
+constexpr int kNC = 2048;               // columns per packed B block, shared by all threads
+constexpr int kPanelsPerTask = 8;       // B panels per parallel task within an MC x NC macro-tile
+constexpr long kSmallGemm = 64L * 64 * 64;  // MACs below which packing costs more than it saves
+constexpr long kMinTaskMacs = 1L << 18;     // below this much work a task stays on the calling thread
+
+inline simd::VecF activate(simd::VecF v, Activation act, simd::VecF alpha) {
+    // Same compare-and-select forms as kernels::relu/lrelu
+    const simd::VecF zero = simd::set1(0.0f);
+    switch (act) {
+        case Activation::ReLU: return simd::select(simd::cmpGt(v, zero), v, zero);
+        case Activation::LReLU: return simd::select(simd::cmpLt(v, zero), simd::mul(v, alpha), v);
+        default: return v;
+    }
+}
+
+inline float activateScalar(float v, Activation act, float alpha) {
+    switch (act) {
+        case Activation::ReLU: return v > 0.0f ? v : 0.0f;
+        case Activation::LReLU: return v < 0.0f ? v * alpha : v;
+        default: return v;
+    }
+}
+
+// ---- Unpacked path for small products ----
+
+// C[R x V vectors] = A[R x K] * B[K x V vectors] + bias + colBias, then activation
+template <int R, int V>
+inline void directTile(int K, const float* A, int lda, const float* B, int ldb, float* C, int ldc,
+                       const float* bias, const float* colBias, Activation act, float alpha) {
+    simd::VecF acc[R][V];
+    for (int r = 0; r < R; ++r) {
+        const simd::VecF init = simd::set1(bias ? bias[r] : 0.0f);
+        for (int v = 0; v < V; ++v) acc[r][v] = colBias ? simd::add(init, simd::load(colBias + v * simd::kWidth)) : init;
+    }
+    for (int k = 0; k < K; ++k) {
+        const float* b = B + (size_t)k * ldb;
+        simd::VecF bv[V];
+        for (int v = 0; v < V; ++v) bv[v] = simd::load(b + v * simd::kWidth);
+        for (int r = 0; r < R; ++r) {
+            const simd::VecF a = simd::set1(A[(size_t)r * lda + k]);
+            for (int v = 0; v < V; ++v) acc[r][v] = simd::mulAdd(a, bv[v], acc[r][v]);
+        }
+    }
+    const simd::VecF va = simd::set1(alpha);
+    for (int r = 0; r < R; ++r) {
+        for (int v = 0; v < V; ++v) simd::store(C + (size_t)r * ldc + v * simd::kWidth, activate(acc[r][v], act, va));
+    }
+}
+
+template <int V>
+void directStrip(int M, int K, const float* A, int lda, const float* B, int ldb, float* C, int ldc,
+                 const float* bias, const float* colBias, Activation act, float alpha) {
+    constexpr int kRows = 4;
+    int m = 0;
+    for (; m + kRows <= M; m += kRows) {
+        directTile<kRows, V>(K, A + (size_t)m * lda, lda, B, ldb, C + (size_t)m * ldc, ldc,
+                             bias ? bias + m : nullptr, colBias, act, alpha);
+    }
+    for (; m < M; ++m) {
+        directTile<1, V>(K, A + (size_t)m * lda, lda, B, ldb, C + (size_t)m * ldc, ldc,
+                         bias ? bias + m : nullptr, colBias, act, alpha);
+    }
+}
+
+// Non-transposed operands only. Walks B in register-width column strips so each strip stays
+// in L1 while every row block of A passes over it.
+void sgemmDirect(int M, int N, int K, const float* A, int lda, const float* B, int ldb, float* C, int ldc,
+                 const GemmEpilogue& ep) {
+    const float* bias = ep.rowBias;
+    const float* colBias = ep.colBias;
+    int j = 0;
+    for (; j + kNR <= N; j += kNR) {
+        directStrip<2>(M, K, A, lda, B + j, ldb, C + j, ldc, bias, colBias ? colBias + j : nullptr, ep.activation, ep.alpha);
+    }
+    for (; j + simd::kWidth <= N; j += simd::kWidth) {
+        directStrip<1>(M, K, A, lda, B + j, ldb, C + j, ldc, bias, colBias ? colBias + j : nullptr, ep.activation, ep.alpha);
+    }
+    for (; j < N; ++j) {
+        for (int m = 0; m < M; ++m) {
+            const float* a = A + (size_t)m * lda;
+            float acc = (bias ? bias[m] : 0.0f) + (colBias ? colBias[j] : 0.0f);
+            for (int k = 0; k < K; ++k) acc += a[k] * B[(size_t)k * ldb + j];
+            C[(size_t)m * ldc + j] = activateScalar(acc, ep.activation, ep.alpha);
+        }
+    }
+}
+
+// ---- Single-row path (fully-connected heads) ----
+
+// c[N] = a[K] * op(B)[K x N]. Packing B would cost as much as the product itself, so a
+// transposed B ([N x K] weights) is read as N contiguous dot products and a plain one as K
+// row updates.
+void sgemvRow(bool transB, int N, int K, const float* a, const float* B, int ldb, float* c, const GemmEpilogue& ep) {
+    const float bias = ep.rowBias ? ep.rowBias[0] : 0.0f;
+    const int grain = std::max(kNR, kDefaultGrainSize / std::max(1, K));
+    ThreadPool::getInstance().parallelFor(0, N, grain, [&](int begin, int end) {
+        if (transB) {
+            for (int j = begin; j < end; ++j) {
+                const float* b = B + (size_t)j * ldb;
+                simd::VecF acc0 = simd::set1(0.0f), acc1 = simd::set1(0.0f);
+                int k = 0;
+                for (; k + kNR <= K; k += kNR) {
+                    acc0 = simd::mulAdd(simd::load(a + k), simd::load(b + k), acc0);
+                    acc1 = simd::mulAdd(simd::load(a + k + simd::kWidth), simd::load(b + k + simd::kWidth), acc1);
+                }
+                float lanes[simd::kWidth];
+                simd::store(lanes, simd::add(acc0, acc1));
+                float sum = bias + (ep.colBias ? ep.colBias[j] : 0.0f);
+                for (float l : lanes) sum += l;
+                for (; k < K; ++k) sum += a[k] * b[k];
+                c[j] = activateScalar(sum, ep.activation, ep.alpha);
+            }
+            return;
+        }
+        for (int j = begin; j < end; ++j) c[j] = bias + (ep.colBias ? ep.colBias[j] : 0.0f);
+        for (int k = 0; k < K; ++k) {
+            const float* b = B + (size_t)k * ldb;
+            const simd::VecF ak = simd::set1(a[k]);
+            int j = begin;
+            for (; j + simd::kWidth <= end; j += simd::kWidth) {
+                simd::store(c + j, simd::mulAdd(ak, simd::load(b + j), simd::load(c + j)));
+            }
+            for (; j < end; ++j) c[j] += a[k] * b[j];
+        }
+        for (int j = begin; j < end; ++j) c[j] = activateScalar(c[j], ep.activation, ep.alpha);
+    });
+}
+
+// ---- Packed path ----
+
+// Rows [i0, i0 + mc) x depth [k0, k0 + kc) of op(A) into MR-row micro-panels, k-major within
+// a panel; rows past mc are zero.
+void packA(bool transA, const float* A, int lda, int i0, int mc, int k0, int kc, float* dst) {
+    for (int ip = 0; ip < mc; ip += kMR) {
+        const int rows = std::min(kMR, mc - ip);
+        for (int k = 0; k < kc; ++k) {
+            float* out = dst + (size_t)(ip / kMR) * kc * kMR + (size_t)k * kMR;
+            for (int r = 0; r < rows; ++r) {
+                const int i = i0 + ip + r, kk = k0 + k;
+                out[r] = transA ? A[(size_t)kk * lda + i] : A[(size_t)i * lda + kk];
+            }
+            for (int r = rows; r < kMR; ++r) out[r] = 0.0f;
+        }
+    }
+}
+
+// Depth [k0, k0 + kc) x columns [j0 + p * NR, ...) of op(B) into NR-column micro-panel p,
+// k-major; columns past nc are zero.
+void packBPanel(bool transB, const float* B, int ldb, int k0, int kc, int j0, int nc, int p, float* dst) {
+    const int jp = p * kNR;
+    const int cols = std::min(kNR, nc - jp);
+    float* out = dst + (size_t)p * kc * kNR;
+    for (int k = 0; k < kc; ++k, out += kNR) {
+        const int kk = k0 + k;
+        if (!transB && cols == kNR) {
+            const float* src = B + (size_t)kk * ldb + j0 + jp;
+            simd::store(out, simd::load(src));
+            simd::store(out + simd::kWidth, simd::load(src + simd::kWidth));
+            continue;
+        }
+        for (int c = 0; c < cols; ++c) {
+            const int j = j0 + jp + c;
+            out[c] = transB ? B[(size_t)j * ldb + kk] : B[(size_t)kk * ldb + j];
+        }
+        for (int c = cols; c < kNR; ++c) out[c] = 0.0f;
+    }
+}
+
+// C[MR x NR] (+)= a-panel * b-panel over kc. The first K block starts from the row + column
+// biases, later ones accumulate onto C; the last one applies the activation.
+inline void microKernel(int kc, const float* a, const float* b, float* C, int ldc, const float* bias,
+                        const float* colBias, bool first, bool last, Activation act, float alpha) {
+    simd::VecF acc[kMR][2];
+    for (int r = 0; r < kMR; ++r) {
+        if (first) {
+            const simd::VecF br = simd::set1(bias[r]);
+            acc[r][0] = simd::add(br, simd::load(colBias));
+            acc[r][1] = simd::add(br, simd::load(colBias + simd::kWidth));
+        } else {
+            acc[r][0] = simd::load(C + (size_t)r * ldc);
+            acc[r][1] = simd::load(C + (size_t)r * ldc + simd::kWidth);
+        }
+    }
+    for (int k = 0; k < kc; ++k, a += kMR, b += kNR) {
+        const simd::VecF b0 = simd::load(b);
+        const simd::VecF b1 = simd::load(b + simd::kWidth);
+        for (int r = 0; r < kMR; ++r) {
+            const simd::VecF ar = simd::set1(a[r]);
+            acc[r][0] = simd::mulAdd(ar, b0, acc[r][0]);
+            acc[r][1] = simd::mulAdd(ar, b1, acc[r][1]);
+        }
+    }
+    if (last && act != Activation::None) {
+        const simd::VecF va = simd::set1(alpha);
+        for (int r = 0; r < kMR; ++r) {
+            acc[r][0] = activate(acc[r][0], act, va);
+            acc[r][1] = activate(acc[r][1], act, va);
+        }
+    }
+    for (int r = 0; r < kMR; ++r) {
+        simd::store(C + (size_t)r * ldc, acc[r][0]);
+        simd::store(C + (size_t)r * ldc + simd::kWidth, acc[r][1]);
+    }
+}
+
+// One MC x (panels [p0, p1)) macro-tile: every A micro-panel against every B panel.
+// Ragged edges go through a local tile so the micro-kernel always runs full width.
+void macroKernel(const float* packedA, int mc, const float* packedB, int nc, int kc, int p0, int p1, float* C,
+                 int ldc, const float* rowBias, const float* colBias, bool first, bool last, const GemmEpilogue& ep) {
+    alignas(64) float edge[kMR * kNR];
+    for (int p = p0; p < p1; ++p) {
+        const int jp = p * kNR;
+        const int cols = std::min(kNR, nc - jp);
+        const float* b = packedB + (size_t)p * kc * kNR;
+        float cbias[kNR] = {};
+        if (colBias) std::copy(colBias + jp, colBias + jp + cols, cbias);
+        for (int ip = 0; ip < mc; ip += kMR) {
+            const int rows = std::min(kMR, mc - ip);
+            const float* a = packedA + (size_t)(ip / kMR) * kc * kMR;
+            float bias[kMR] = {};
+            if (rowBias) std::copy(rowBias + ip, rowBias + ip + rows, bias);
+            float* c = C + (size_t)ip * ldc + jp;
+
+            if (rows == kMR && cols == kNR) {
+                microKernel(kc, a, b, c, ldc, bias, cbias, first, last, ep.activation, ep.alpha);
+                continue;
+            }
+            if (!first) {
+                for (int r = 0; r < rows; ++r) std::copy(c + (size_t)r * ldc, c + (size_t)r * ldc + cols, edge + r * kNR);
+            }
+            microKernel(kc, a, b, edge, kNR, bias, cbias, first, last, ep.activation, ep.alpha);
+            for (int r = 0; r < rows; ++r) std::copy(edge + r * kNR, edge + r * kNR + cols, c + (size_t)r * ldc);
+        }
+    }
+}
+
+void sgemmPacked(bool transA, bool transB, int M, int N, int K, const float* A, int lda, const float* B, int ldb,
+                 float* C, int ldc, const GemmEpilogue& ep) {
+    ThreadPool& pool = ThreadPool::getInstance();
+    static thread_local std::vector<float> packedB;
+
+    for (int j0 = 0; j0 < N; j0 += kNC) {
+        const int nc = std::min(kNC, N - j0);
+        const int panels = (nc + kNR - 1) / kNR;
+        for (int k0 = 0; k0 < K; k0 += kKC) {
+            const int kc = std::min(kKC, K - k0);
+            const bool first = k0 == 0, last = k0 + kKC >= K;
+
+            packedB.resize((size_t)panels * kc * kNR);
+            float* pb = packedB.data();
+            pool.parallelFor(0, panels, std::max(1, kDefaultGrainSize / std::max(1, kc * kNR)), [&](int begin, int end) {
+                for (int p = begin; p < end; ++p) packBPanel(transB, B, ldb, k0, kc, j0, nc, p, pb);
+            });
+
+            const int mBlocks = (M + kMC - 1) / kMC;
+            const int nTasks = (panels + kPanelsPerTask - 1) / kPanelsPerTask;
+            const long taskMacs = std::max(1L, (long)std::min(M, kMC) * std::min(nc, kPanelsPerTask * kNR) * kc);
+            const int grain = (int)std::max(1L, kMinTaskMacs / taskMacs);
+            pool.parallelFor(0, mBlocks * nTasks, grain, [&](int begin, int end) {
+                static thread_local std::vector<float> packedA;
+                packedA.resize((size_t)kMC * kc);
+                int packedBlock = -1;
+                for (int t = begin; t < end; ++t) {
+                    const int mb = t / nTasks, nt = t % nTasks;
+                    const int i0 = mb * kMC, mc = std::min(kMC, M - i0);
+                    if (mb != packedBlock) { // consecutive tasks of one thread usually share the A block
+                        packA(transA, A, lda, i0, mc, k0, kc, packedA.data());
+                        packedBlock = mb;
+                    }
+                    const int p0 = nt * kPanelsPerTask, p1 = std::min(panels, p0 + kPanelsPerTask);
+                    macroKernel(packedA.data(), mc, pb, nc, kc, p0, p1, C + (size_t)i0 * ldc + j0, ldc,
+                                ep.rowBias ? ep.rowBias + i0 : nullptr, ep.colBias ? ep.colBias + j0 : nullptr, first,
+                                last, ep);
+                }
+            });
+        }
+    }
+}
+
+} // namespace
+
+void sgemm(bool transA, bool transB, int M, int N, int K, const float* A, int lda, const float* B, int ldb,
+           float* C, int ldc, const GemmEpilogue& epilogue) {
+    if (M <= 0 || N <= 0) return;
+    if (K <= 0 || (!transA && !transB && (long)M * N * K < kSmallGemm)) {
+        sgemmDirect(M, N, std::max(0, K), A, lda, B, ldb, C, ldc, epilogue);
+        return;
+    }
+    if (M == 1 && (!transA || lda == 1)) { // a single row of A is contiguous either way
+        sgemvRow(transB, N, K, A, B, ldb, C, epilogue);
+        return;
+    }
+    sgemmPacked(transA, transB, M, N, K, A, lda, B, ldb, C, ldc, epilogue);
+}
+
+void sgemmReference(bool transA, bool transB, int M, int N, int K, const float* A, int lda, const float* B,
+                    int ldb, float* C, int ldc, const GemmEpilogue& epilogue) {
+    for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < N; ++j) {
+            float acc = (epilogue.rowBias ? epilogue.rowBias[i] : 0.0f) + (epilogue.colBias ? epilogue.colBias[j] : 0.0f);
+            for (int k = 0; k < K; ++k) {
+                const float a = transA ? A[(size_t)k * lda + i] : A[(size_t)i * lda + k];
+                const float b = transB ? B[(size_t)j * ldb + k] : B[(size_t)k * ldb + j];
+                acc += a * b;
+            }
+            C[(size_t)i * ldc + j] = activateScalar(acc, epilogue.activation, epilogue.alpha);
+        }
+    }
+}
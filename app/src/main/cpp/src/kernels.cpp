@@ -0,0 +1,189 @@
+#include "kernels.hpp"
+#include "simd.hpp"
+#include "simd_math.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(TSR_SIMD_SCALAR) && !defined(TSR_REFERENCE_KERNELS)
+#define TSR_REFERENCE_KERNELS 1
+#endif
+
+namespace {
+
+// Applies op to every vector of x; the tail is copied into a padded vector and back.
+template <typename Op>
+inline void mapVec(float* x, int n, Op op) {
+    int i = 0;
+    for (; i + simd::kWidth <= n; i += simd::kWidth) {
+        simd::store(x + i, op(simd::load(x + i)));
+    }
+    if (i < n) {
+        float pad[simd::kWidth] = {};
+        std::copy(x + i, x + n, pad);
+        simd::store(pad, op(simd::load(pad)));
+        std::copy(pad, pad + (n - i), x + i);
+    }
+}
+
+template <typename Op>
+inline void zipVec(float* x, const float* y, int n, Op op) {
+    int i = 0;
+    for (; i + simd::kWidth <= n; i += simd::kWidth) {
+        simd::store(x + i, op(simd::load(x + i), simd::load(y + i)));
+    }
+    if (i < n) {
+        float padX[simd::kWidth] = {};
+        float padY[simd::kWidth];
+        std::fill(padY, padY + simd::kWidth, 1.0f); // keeps padded lanes of div finite
+        std::copy(x + i, x + n, padX);
+        std::copy(y + i, y + n, padY);
+        simd::store(padX, op(simd::load(padX), simd::load(padY)));
+        std::copy(padX, padX + (n - i), x + i);
+    }
+}
+
+} // namespace
+
+namespace kernels {
+
+void addScalar(float* x, int n, float s) {
+    const simd::VecF v = simd::set1(s);
+    mapVec(x, n, [v](simd::VecF a) { return simd::add(a, v); });
+}
+
+void subScalar(float* x, int n, float s) {
+    const simd::VecF v = simd::set1(s);
+    mapVec(x, n, [v](simd::VecF a) { return simd::sub(a, v); });
+}
+
+void mulScalar(float* x, int n, float s) {
+    const simd::VecF v = simd::set1(s);
+    mapVec(x, n, [v](simd::VecF a) { return simd::mul(a, v); });
+}
+
+void divScalar(float* x, int n, float s) {
+    const simd::VecF v = simd::set1(s);
+    mapVec(x, n, [v](simd::VecF a) { return simd::div(a, v); });
+}
+
+void add(float* x, const float* y, int n) {
+    zipVec(x, y, n, [](simd::VecF a, simd::VecF b) { return simd::add(a, b); });
+}
+
+void sub(float* x, const float* y, int n) {
+    zipVec(x, y, n, [](simd::VecF a, simd::VecF b) { return simd::sub(a, b); });
+}
+
+void mul(float* x, const float* y, int n) {
+    zipVec(x, y, n, [](simd::VecF a, simd::VecF b) { return simd::mul(a, b); });
+}
+
+void div(float* x, const float* y, int n) {
+    zipVec(x, y, n, [](simd::VecF a, simd::VecF b) { return simd::div(a, b); });
+}
+
+void affineScalar(float* x, int n, float scale, float shift) {
+    const simd::VecF vs = simd::set1(scale), vb = simd::set1(shift);
+    mapVec(x, n, [=](simd::VecF a) { return simd::mulAdd(a, vs, vb); });
+}
+
+void affine(float* x, const float* scale, const float* shift, int n) {
+    int i = 0;
+    for (; i + simd::kWidth <= n; i += simd::kWidth) {
+        simd::store(x + i, simd::mulAdd(simd::load(x + i), simd::load(scale + i), simd::load(shift + i)));
+    }
+    if (i < n) {
+        float padX[simd::kWidth] = {}, padS[simd::kWidth] = {}, padB[simd::kWidth] = {};
+        std::copy(x + i, x + n, padX);
+        std::copy(scale + i, scale + n, padS);
+        std::copy(shift + i, shift + n, padB);
+        simd::store(padX, simd::mulAdd(simd::load(padX), simd::load(padS), simd::load(padB)));
+        std::copy(padX, padX + (n - i), x + i);
+    }
+}
+
+void negate(float* x, int n) {
+    const simd::VecF zero = simd::set1(-0.0f); // -0 - a flips the sign of zeros too
+    mapVec(x, n, [zero](simd::VecF a) { return simd::sub(zero, a); });
+}
+
+void relu(float* x, int n) {
+    // Compare-and-select rather than max so NaN maps to 0 on every ISA, like fmaxf(x, 0)
+    const simd::VecF zero = simd::set1(0.0f);
+    mapVec(x, n, [zero](simd::VecF a) { return simd::select(simd::cmpGt(a, zero), a, zero); });
+}
+
+void lrelu(float* x, int n, float alpha) {
+    const simd::VecF zero = simd::set1(0.0f), va = simd::set1(alpha);
+    mapVec(x, n, [=](simd::VecF a) { return simd::select(simd::cmpLt(a, zero), simd::mul(a, va), a); });
+}
+
+void square(float* x, int n) {
+    mapVec(x, n, [](simd::VecF a) { return simd::mul(a, a); });
+}
+
+void sqrt(float* x, int n) {
+    mapVec(x, n, [](simd::VecF a) { return simd::sqrt(a); });
+}
+
+#if defined(TSR_REFERENCE_KERNELS)
+
+void elu(float* x, int n, float alpha) { ref::elu(x, n, alpha); }
+void sigmoid(float* x, int n) { ref::sigmoid(x, n); }
+void tanh(float* x, int n) { ref::tanh(x, n); }
+void exp(float* x, int n) { ref::exp(x, n); }
+void log(float* x, int n) { ref::log(x, n); }
+
+#else
+
+void elu(float* x, int n, float alpha) {
+    const simd::VecF zero = simd::set1(0.0f), one = simd::set1(1.0f), va = simd::set1(alpha);
+    mapVec(x, n, [=](simd::VecF a) {
+        simd::VecF neg = simd::mul(va, simd::sub(simd::exp(simd::min(a, zero)), one));
+        return simd::select(simd::cmpLt(a, zero), neg, a);
+    });
+}
+
+void sigmoid(float* x, int n) {
+    mapVec(x, n, [](simd::VecF a) { return simd::sigmoid(a); });
+}
+
+void tanh(float* x, int n) {
+    mapVec(x, n, [](simd::VecF a) { return simd::tanh(a); });
+}
+
+void exp(float* x, int n) {
+    mapVec(x, n, [](simd::VecF a) { return simd::exp(a); });
+}
+
+void log(float* x, int n) {
+    mapVec(x, n, [](simd::VecF a) { return simd::log(a); });
+}
+
+#endif
+
+namespace ref {
+
+void elu(float* x, int n, float alpha) {
+    for (int i = 0; i < n; ++i) x[i] = x[i] < 0 ? alpha * (expf(x[i]) - 1) : x[i];
+}
+
+void sigmoid(float* x, int n) {
+    for (int i = 0; i < n; ++i) x[i] = 1.0f / (1.0f + expf(-x[i]));
+}
+
+void tanh(float* x, int n) {
+    for (int i = 0; i < n; ++i) x[i] = tanhf(x[i]);
+}
+
+void exp(float* x, int n) {
+    for (int i = 0; i < n; ++i) x[i] = expf(x[i]);
+}
+
+void log(float* x, int n) {
+    for (int i = 0; i < n; ++i) x[i] = logf(x[i]);
+}
+
+} // namespace ref
+
+} // namespace kernels
@@ -0,0 +1,944 @@
+#include "layers.hpp"
+#include "kernels.hpp"
+#include "layout.hpp"
+#include "logger.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace {
+
+constexpr int kTileAlign = 2 * simd::kWidth; // im2col tile widths are whole GEMM register tiles
+constexpr int kPatchBudget = 262144;         // floats of im2col patch per tile (1 MB): wide enough to amortize packing
+constexpr long kMinChunkMacs = 1L << 18;     // below this much work a chunk stays on one thread
+
+inline void activateRow(float* x, int n, Activation act, float alpha) {
+    if (act == Activation::ReLU) kernels::relu(x, n);
+    else if (act == Activation::LReLU) kernels::lrelu(x, n, alpha);
+}
+
+inline GemmEpilogue epilogueFor(const float* bias, const Conv2dParams& p) {
+    GemmEpilogue ep;
+    ep.rowBias = bias;
+    ep.activation = p.activation;
+    ep.alpha = p.alpha;
+    return ep;
+}
+
+// Output positions o in [lo, hi) whose input coordinate o * stride + offset lies in [0, size).
+inline void validRange(int outSize, int stride, int offset, int size, int& lo, int& hi) {
+    lo = offset >= 0 ? 0 : (-offset + stride - 1) / stride;
+    hi = size - offset <= 0 ? 0 : (size - 1 - offset) / stride + 1;
+    lo = std::min(lo, outSize);
+    hi = std::max(lo, std::min(hi, outSize));
+}
+
+// y[i] += a * x[i]
+inline void axpy(float* y, const float* x, int n, float a) {
+    const simd::VecF va = simd::set1(a);
+    int i = 0;
+    for (; i + simd::kWidth <= n; i += simd::kWidth) {
+        simd::store(y + i, simd::mulAdd(va, simd::load(x + i), simd::load(y + i)));
+    }
+    for (; i < n; ++i) y[i] += a * x[i];
+}
+
+struct ConvShape {
+    int N, Cin, H, W;
+    int Cout, kH, kW;
+    int Hout, Wout;
+    int groups;
+};
+
+ConvShape convShape(const std::vector<int>& in, const std::vector<int>& w, const Conv2dParams& p) {
+    assert(in.size() == 4 && w.size() == 4);
+    assert(p.groups >= 1 && in[1] % p.groups == 0 && w[0] % p.groups == 0);
+    assert(w[1] == in[1] / p.groups);
+    ConvShape s;
+    s.N = in[0];
+    s.Cin = in[1];
+    s.H = in[2];
+    s.W = in[3];
+    s.Cout = w[0];
+    s.kH = w[2];
+    s.kW = w[3];
+    s.Hout = convOutputSize(s.H, s.kH, p.strideH, p.padH, p.dilationH);
+    s.Wout = convOutputSize(s.W, s.kW, p.strideW, p.padW, p.dilationW);
+    s.groups = p.groups;
+    assert(s.Hout > 0 && s.Wout > 0);
+    return s;
+}
+
+bool isDepthwise(const ConvShape& s) {
+    return s.groups > 1 && s.groups == s.Cin && s.Cout % s.Cin == 0;
+}
+
+bool isPointwise(const ConvShape& s, const Conv2dParams& p) {
+    return s.kH == 1 && s.kW == 1 && p.strideH == 1 && p.strideW == 1 && p.padH == 0 && p.padW == 0;
+}
+
+bool fitsWinograd(const ConvShape& s, const Conv2dParams& p) {
+    return s.kH == 3 && s.kW == 3 && p.strideH == 1 && p.strideW == 1 && p.dilationH == 1 &&
+           p.dilationW == 1 && s.groups == 1;
+}
+
+const char* algoName(ConvAlgo algo) {
+    switch (algo) {
+        case ConvAlgo::Im2colGemm: return "im2col+gemm";
+        case ConvAlgo::Direct: return "direct";
+        case ConvAlgo::Winograd: return "winograd";
+        default: return "auto";
+    }
+}
+
+// Unrolls the receptive fields of output positions [j0, j0 + cols) of one image into
+// patch[K x cols], rows in (ci, ky, kx) order to line up with the weight layout.
+void im2colTile(const float* in, int cin, const ConvShape& s, const Conv2dParams& p, int j0, int cols,
+                float* patch) {
+    for (int ci = 0; ci < cin; ++ci) {
+        const float* plane = in + (size_t)ci * s.H * s.W;
+        for (int ky = 0; ky < s.kH; ++ky) {
+            const int dy = ky * p.dilationH - p.padH;
+            for (int kx = 0; kx < s.kW; ++kx) {
+                const int dx = kx * p.dilationW - p.padW;
+                int lo, hi;
+                validRange(s.Wout, p.strideW, dx, s.W, lo, hi);
+                float* row = patch + (size_t)((ci * s.kH + ky) * s.kW + kx) * cols;
+
+                int oy = j0 / s.Wout, ox = j0 % s.Wout;
+                for (int j = 0; j < cols; ox = 0, ++oy) {
+                    const int run = std::min(cols - j, s.Wout - ox); // stays on output row oy
+                    const int iy = oy * p.strideH + dy;
+                    const int a = std::max(ox, lo), b = std::min(ox + run, hi);
+                    if (iy < 0 || iy >= s.H || a >= b) {
+                        std::fill(row + j, row + j + run, 0.0f);
+                    } else {
+                        const float* src = plane + (size_t)iy * s.W;
+                        float* dst = row + j - ox;
+                        std::fill(dst + ox, dst + a, 0.0f);
+                        if (p.strideW == 1) {
+                            std::memcpy(dst + a, src + a + dx, sizeof(float) * (b - a));
+                        } else {
+                            for (int x = a; x < b; ++x) dst[x] = src[x * p.strideW + dx];
+                        }
+                        std::fill(dst + b, dst + ox + run, 0.0f);
+                    }
+                    j += run;
+                }
+            }
+        }
+    }
+}
+
+// Output columns per parallel chunk so each chunk carries at least kMinChunkMacs of GEMM work.
+int columnGrain(int rows, int K) {
+    const long perColumn = std::max(1L, (long)rows * K);
+    return (int)std::max<long>(kTileAlign, kMinChunkMacs / perColumn);
+}
+
+void convIm2col(const float* in, const float* weight, const float* bias, float* out, const ConvShape& s,
+                const Conv2dParams& p) {
+    const int cinG = s.Cin / s.groups, coutG = s.Cout / s.groups;
+    const int K = cinG * s.kH * s.kW;
+    const int plane = s.H * s.W, outPlane = s.Hout * s.Wout;
+    const int tileCols = std::max(kTileAlign, std::min(1024, kPatchBudget / K / kTileAlign * kTileAlign));
+
+    for (int n = 0; n < s.N; ++n) {
+        for (int g = 0; g < s.groups; ++g) {
+            const float* inG = in + ((size_t)n * s.Cin + (size_t)g * cinG) * plane;
+            const float* wG = weight + (size_t)g * coutG * K;
+            const GemmEpilogue ep = epilogueFor(bias ? bias + (size_t)g * coutG : nullptr, p);
+            float* outG = out + ((size_t)n * s.Cout + (size_t)g * coutG) * outPlane;
+
+            ThreadPool::getInstance().parallelFor(0, outPlane, columnGrain(coutG, K), [&](int begin, int end) {
+                static thread_local std::vector<float> patch;
+                patch.resize((size_t)K * tileCols);
+                for (int j0 = begin; j0 < end; j0 += tileCols) {
+                    const int cols = std::min(tileCols, end - j0);
+                    im2colTile(inG, cinG, s, p, j0, cols, patch.data());
+                    sgemm(false, false, coutG, cols, K, wG, K, patch.data(), cols, outG + j0, outPlane, ep);
+                }
+            });
+        }
+    }
+}
+
+// 1x1, stride 1, no padding: the input planes already are the GEMM's B matrix.
+void convPointwise(const float* in, const float* weight, const float* bias, float* out, const ConvShape& s,
+                   const Conv2dParams& p) {
+    const int cinG = s.Cin / s.groups, coutG = s.Cout / s.groups;
+    const int plane = s.H * s.W;
+
+    for (int n = 0; n < s.N; ++n) {
+        for (int g = 0; g < s.groups; ++g) {
+            const float* inG = in + ((size_t)n * s.Cin + (size_t)g * cinG) * plane;
+            const float* wG = weight + (size_t)g * coutG * cinG;
+            float* outG = out + ((size_t)n * s.Cout + (size_t)g * coutG) * plane;
+            sgemm(false, false, coutG, plane, cinG, wG, cinG, inG, plane, outG, plane,
+                  epilogueFor(bias ? bias + (size_t)g * coutG : nullptr, p));
+        }
+    }
+}
+
+// One output plane per task; each output row accumulates its kH x kW shifted input rows
+// while it sits in L1.
+void convDepthwise(const float* in, const float* weight, const float* bias, float* out, const ConvShape& s,
+                   const Conv2dParams& p) {
+    const int multiplier = s.Cout / s.Cin;
+    const int plane = s.H * s.W, outPlane = s.Hout * s.Wout;
+    const long perPlane = std::max(1L, (long)outPlane * s.kH * s.kW);
+
+    std::vector<int> xLo(s.kW), xHi(s.kW);
+    for (int kx = 0; kx < s.kW; ++kx) validRange(s.Wout, p.strideW, kx * p.dilationW - p.padW, s.W, xLo[kx], xHi[kx]);
+
+    ThreadPool::getInstance().parallelFor(0, s.N * s.Cout, (int)std::max(1L, kMinChunkMacs / perPlane),
+                                          [&](int begin, int end) {
+        for (int idx = begin; idx < end; ++idx) {
+            const int n = idx / s.Cout, co = idx % s.Cout;
+            const float* src = in + ((size_t)n * s.Cin + co / multiplier) * plane;
+            const float* w = weight + (size_t)co * s.kH * s.kW;
+            float* dst = out + (size_t)idx * outPlane;
+
+            for (int oy = 0; oy < s.Hout; ++oy) {
+                float* dstRow = dst + (size_t)oy * s.Wout;
+                simd::fill(dstRow, s.Wout, bias ? bias[co] : 0.0f);
+                for (int ky = 0; ky < s.kH; ++ky) {
+                    const int iy = oy * p.strideH + ky * p.dilationH - p.padH;
+                    if (iy < 0 || iy >= s.H) continue;
+                    const float* srcRow = src + (size_t)iy * s.W;
+                    for (int kx = 0; kx < s.kW; ++kx) {
+                        const int lo = xLo[kx], hi = xHi[kx];
+                        if (lo >= hi) continue;
+                        const float wv = w[ky * s.kW + kx];
+                        const int dx = kx * p.dilationW - p.padW;
+                        if (p.strideW == 1) {
+                            axpy(dstRow + lo, srcRow + lo + dx, hi - lo, wv);
+                        } else {
+                            for (int ox = lo; ox < hi; ++ox) dstRow[ox] += wv * srcRow[ox * p.strideW + dx];
+                        }
+                    }
+                }
+                activateRow(dstRow, s.Wout, p.activation, p.alpha);
+            }
+        }
+    });
+}
+
+// Winograd F(2x2, 3x3): each 2x2 output tile costs 16 multiplies per (ci, co) instead of 36.
+// Weights become U = G g G^T and input tiles V = B^T d B; the 16 elementwise products over
+// channels are 16 GEMMs U[xi] (Cout x Cin) * V[xi] (Cin x tiles), and Y = A^T m A maps each
+// product back to a 2x2 output tile. Both tile transforms run one vector of neighbouring
+// tiles at a time.
+void convWinograd(const float* in, const float* weight, const float* bias, float* out, const ConvShape& s,
+                  const Conv2dParams& p) {
+    constexpr int kLanes = simd::kWidth;
+    const int Cin = s.Cin, Cout = s.Cout;
+    const int plane = s.H * s.W, outPlane = s.Hout * s.Wout;
+    const int tilesW = (s.Wout + 1) / 2, tilesH = (s.Hout + 1) / 2;
+    const int tiles = tilesW * tilesH;
+    // Tiles per GEMM batch: keeps the V and M scratch (16 x (Cin + Cout) x batch) around 1 MB,
+    // wide enough for sgemm to amortize packing U
+    const int batch = std::max(16, std::min(512, 16384 / (Cin + Cout) / 16 * 16));
+    const int ldT = batch + kLanes; // tile stride of V/M rows: a vector store may run past the batch end
+
+    std::vector<float> U((size_t)16 * Cout * Cin);
+    for (int co = 0; co < Cout; ++co) {
+        for (int ci = 0; ci < Cin; ++ci) {
+            const float* g = weight + ((size_t)co * Cin + ci) * 9;
+            float t[4][3]; // G g
+            for (int c = 0; c < 3; ++c) {
+                t[0][c] = g[c];
+                t[1][c] = 0.5f * (g[c] + g[3 + c] + g[6 + c]);
+                t[2][c] = 0.5f * (g[c] - g[3 + c] + g[6 + c]);
+                t[3][c] = g[6 + c];
+            }
+            for (int r = 0; r < 4; ++r) { // (G g) G^T
+                const float u[4] = {t[r][0], 0.5f * (t[r][0] + t[r][1] + t[r][2]),
+                                    0.5f * (t[r][0] - t[r][1] + t[r][2]), t[r][2]};
+                for (int c = 0; c < 4; ++c) U[((size_t)(r * 4 + c) * Cout + co) * Cin + ci] = u[c];
+            }
+        }
+    }
+
+    for (int n = 0; n < s.N; ++n) {
+        const float* inN = in + (size_t)n * Cin * plane;
+        float* outN = out + (size_t)n * Cout * outPlane;
+
+        ThreadPool::getInstance().parallelFor(0, tiles, std::max(batch, (int)(kMinChunkMacs / (16L * Cin * Cout) + 1)),
+                                              [&](int begin, int end) {
+            static thread_local std::vector<float> V, M, cols;
+            V.resize((size_t)16 * Cin * ldT);
+            M.resize((size_t)16 * Cout * ldT);
+            cols.resize((size_t)8 * (tilesW + 1 + kLanes));
+
+            for (int t0 = begin; t0 < end; t0 += batch) {
+                const int nt = std::min(batch, end - t0);
+
+                // Input transform, one tile row segment at a time
+                for (int t = 0; t < nt;) {
+                    const int ty = (t0 + t) / tilesW, tx0 = (t0 + t) % tilesW;
+                    const int seg = std::min(nt - t, tilesW - tx0);
+                    const int len = seg + 1 + kLanes;
+                    for (int ci = 0; ci < Cin; ++ci) {
+                        // Even/odd input columns of the 4 rows under this tile row (zero outside the
+                        // image): column c of tile tx is even[tx + c / 2] or odd[tx + c / 2].
+                        const float* src = inN + (size_t)ci * plane;
+                        for (int r = 0; r < 4; ++r) {
+                            float* even = cols.data() + (size_t)(2 * r) * len;
+                            float* odd = even + len;
+                            const int y = 2 * ty + r - p.padH;
+                            for (int k = 0; k < len; ++k) {
+                                const int x = 2 * (tx0 + k) - p.padW;
+                                const bool rowIn = y >= 0 && y < s.H;
+                                even[k] = rowIn && x >= 0 && x < s.W ? src[(size_t)y * s.W + x] : 0.0f;
+                                odd[k] = rowIn && x + 1 >= 0 && x + 1 < s.W ? src[(size_t)y * s.W + x + 1] : 0.0f;
+                            }
+                        }
+                        for (int k = 0; k < seg; k += kLanes) {
+                            simd::VecF b[4][4]; // B^T d
+                            simd::VecF d[4][4];
+                            for (int r = 0; r < 4; ++r) {
+                                const float* even = cols.data() + (size_t)(2 * r) * len + k;
+                                const float* odd = even + len;
+                                d[r][0] = simd::load(even);
+                                d[r][1] = simd::load(odd);
+                                d[r][2] = simd::load(even + 1);
+                                d[r][3] = simd::load(odd + 1);
+                            }
+                            for (int c = 0; c < 4; ++c) {
+                                b[0][c] = simd::sub(d[0][c], d[2][c]);
+                                b[1][c] = simd::add(d[1][c], d[2][c]);
+                                b[2][c] = simd::sub(d[2][c], d[1][c]);
+                                b[3][c] = simd::sub(d[1][c], d[3][c]);
+                            }
+                            for (int r = 0; r < 4; ++r) { // (B^T d) B
+                                const simd::VecF v[4] = {simd::sub(b[r][0], b[r][2]), simd::add(b[r][1], b[r][2]),
+                                                         simd::sub(b[r][2], b[r][1]), simd::sub(b[r][1], b[r][3])};
+                                for (int c = 0; c < 4; ++c) {
+                                    simd::store(V.data() + ((size_t)(r * 4 + c) * Cin + ci) * ldT + t + k, v[c]);
+                                }
+                            }
+                        }
+                    }
+                    t += seg;
+                }
+
+                for (int xi = 0; xi < 16; ++xi) {
+                    sgemm(false, false, Cout, nt, Cin, U.data() + (size_t)xi * Cout * Cin, Cin,
+                          V.data() + (size_t)xi * Cin * ldT, ldT, M.data() + (size_t)xi * Cout * ldT, ldT);
+                }
+
+                // Output transform + bias + activation, scattered into the 2x2 output tiles
+                for (int t = 0; t < nt;) {
+                    const int ty = (t0 + t) / tilesW, tx0 = (t0 + t) % tilesW;
+                    const int seg = std::min(nt - t, tilesW - tx0);
+                    const int rows = std::min(2, s.Hout - 2 * ty);
+                    for (int co = 0; co < Cout; ++co) {
+                        float* dst = outN + (size_t)co * outPlane + (size_t)(2 * ty) * s.Wout;
+                        const simd::VecF vb = simd::set1(bias ? bias[co] : 0.0f);
+                        for (int k = 0; k < seg; k += kLanes) {
+                            simd::VecF m[4][4];
+                            for (int xi = 0; xi < 16; ++xi) {
+                                m[xi / 4][xi % 4] = simd::load(M.data() + ((size_t)xi * Cout + co) * ldT + t + k);
+                            }
+                            alignas(32) float y[2][2][kLanes];
+                            for (int r = 0; r < 2; ++r) { // A^T m A
+                                const simd::VecF a[4] = {
+                                    r == 0 ? simd::add(simd::add(m[0][0], m[1][0]), m[2][0]) : simd::sub(simd::sub(m[1][0], m[2][0]), m[3][0]),
+                                    r == 0 ? simd::add(simd::add(m[0][1], m[1][1]), m[2][1]) : simd::sub(simd::sub(m[1][1], m[2][1]), m[3][1]),
+                                    r == 0 ? simd::add(simd::add(m[0][2], m[1][2]), m[2][2]) : simd::sub(simd::sub(m[1][2], m[2][2]), m[3][2]),
+                                    r == 0 ? simd::add(simd::add(m[0][3], m[1][3]), m[2][3]) : simd::sub(simd::sub(m[1][3], m[2][3]), m[3][3])};
+                                simd::store(y[r][0], simd::add(simd::add(simd::add(a[0], a[1]), a[2]), vb));
+                                simd::store(y[r][1], simd::add(simd::sub(simd::sub(a[1], a[2]), a[3]), vb));
+                            }
+                            activateRow(&y[0][0][0], 4 * kLanes, p.activation, p.alpha);
+                            const int count = std::min(kLanes, seg - k);
+                            for (int r = 0; r < rows; ++r) {
+                                float* row = dst + (size_t)r * s.Wout;
+                                for (int l = 0; l < count; ++l) {
+                                    const int ox = 2 * (tx0 + k + l);
+                                    row[ox] = y[r][0][l];
+                                    if (ox + 1 < s.Wout) row[ox + 1] = y[r][1][l];
+                                }
+                            }
+                        }
+                    }
+                    t += seg;
+                }
+            }
+        });
+    }
+}
+
+// ---- NHWC and blocked (NCHWc) formats ----
+//
+// Both keep the channels of a pixel (all C, or one block) in a run of `lanes` contiguous
+// floats, so depthwise convs and pooling are per-lane multiply-adds / maxes over whole pixels.
+
+struct PixelRuns {
+    int planes; // H x W planes of pixel runs: N (NHWC) or N * Cb (blocked)
+    int lanes;  // floats per pixel: C or the block
+    int groups; // lane groups per image: plane q holds channels from (q % groups) * lanes
+};
+
+PixelRuns pixelRuns(MemoryFormat format, int N, int C) {
+    const int block = channelBlock(format);
+    if (block == 1) return {N, C, 1};
+    const int Cb = (C + block - 1) / block;
+    return {N * Cb, block, Cb};
+}
+
+// Lanes stored per pixel weight vector: runs narrower than a SIMD vector that divide it
+// (NCHWc4 on AVX2) keep their weights repeated across the whole vector
+inline int replicatedLanes(int L) {
+    return L < simd::kWidth && simd::kWidth % L == 0 ? simd::kWidth : L;
+}
+
+// dst[o * L + l] += src[o * step + l] * w[l] for `count` pixels of L lanes; w holds
+// replicatedLanes(L) values
+inline void mulAddPixels(float* dst, const float* src, int step, const float* w, int L, int count) {
+    if (L <= simd::kWidth && step == L && simd::kWidth % L == 0) { // one contiguous run, lane pattern per vector
+        const simd::VecF wv = simd::load(w);
+        const int n = count * L;
+        int i = 0;
+        for (; i + simd::kWidth <= n; i += simd::kWidth) {
+            simd::store(dst + i, simd::mulAdd(simd::load(src + i), wv, simd::load(dst + i)));
+        }
+        for (; i < n; ++i) dst[i] += src[i] * w[i % L];
+        return;
+    }
+    if (L == simd::kWidth) {
+        const simd::VecF wv = simd::load(w);
+        for (int o = 0; o < count; ++o) {
+            simd::store(dst + (size_t)o * L, simd::mulAdd(simd::load(src + (size_t)o * step), wv, simd::load(dst + (size_t)o * L)));
+        }
+        return;
+    }
+    for (int o = 0; o < count; ++o, dst += L, src += step) {
+        int l = 0;
+        for (; l + simd::kWidth <= L; l += simd::kWidth) {
+            simd::store(dst + l, simd::mulAdd(simd::load(src + l), simd::load(w + l), simd::load(dst + l)));
+        }
+        for (; l < L; ++l) dst[l] += src[l] * w[l];
+    }
+}
+
+// Depthwise conv with multiplier 1 over pixel runs: weights repacked per tap into channel
+// lanes, one output row of one plane per task.
+void convDepthwisePixels(const float* in, const float* weight, const float* bias, float* out, const ConvShape& s,
+                         const Conv2dParams& p, MemoryFormat format) {
+    const PixelRuns r = pixelRuns(format, s.N, s.Cin);
+    const int L = r.lanes, Lw = replicatedLanes(L), taps = s.kH * s.kW;
+    const int width = r.groups * Lw; // per tap: each lane group's weights, repeated to Lw
+    std::vector<float> w((size_t)taps * width, 0.0f);
+    for (int c = 0; c < s.Cin; ++c) {
+        for (int t = 0; t < taps; ++t) {
+            for (int l = c % L; l < Lw; l += L) w[(size_t)t * width + c / L * Lw + l] = weight[(size_t)c * taps + t];
+        }
+    }
+    const std::vector<float> b = bias ? layout::channelLanes(bias, 1, s.Cin, format, 0.0f)
+                                      : std::vector<float>((size_t)r.groups * L, 0.0f);
+
+    std::vector<int> xLo(s.kW), xHi(s.kW);
+    for (int kx = 0; kx < s.kW; ++kx) validRange(s.Wout, p.strideW, kx * p.dilationW - p.padW, s.W, xLo[kx], xHi[kx]);
+    const long perRow = std::max(1L, (long)s.Wout * taps * L);
+
+    ThreadPool::getInstance().parallelFor(0, r.planes * s.Hout, (int)std::max(1L, kMinChunkMacs / perRow),
+                                          [&](int begin, int end) {
+        for (int idx = begin; idx < end; ++idx) {
+            const int q = idx / s.Hout, oy = idx % s.Hout, group = q % r.groups;
+            const float* src = in + (size_t)q * s.H * s.W * L;
+            const float* bl = b.data() + (size_t)group * L;
+            float* dstRow = out + (size_t)idx * s.Wout * L;
+            for (int ox = 0; ox < s.Wout; ++ox) {
+                for (int l = 0; l < L; ++l) dstRow[(size_t)ox * L + l] = bl[l];
+            }
+
+            for (int ky = 0; ky < s.kH; ++ky) {
+                const int iy = oy * p.strideH + ky * p.dilationH - p.padH;
+                if (iy < 0 || iy >= s.H) continue;
+                const float* srcRow = src + (size_t)iy * s.W * L;
+                for (int kx = 0; kx < s.kW; ++kx) {
+                    const float* wl = w.data() + (size_t)(ky * s.kW + kx) * width + (size_t)group * Lw;
+                    const int lo = xLo[kx], dx = kx * p.dilationW - p.padW;
+                    if (lo >= xHi[kx]) continue;
+                    mulAddPixels(dstRow + (size_t)lo * L, srcRow + (size_t)(lo * p.strideW + dx) * L, p.strideW * L, wl, L,
+                                 xHi[kx] - lo);
+                }
+            }
+            activateRow(dstRow, s.Wout * L, p.activation, p.alpha);
+        }
+    });
+}
+
+// NHWC im2col: the receptive field of an output pixel is kH * kW runs of Cin / groups
+// contiguous channels, so patch rows are pixels and the weight, repacked (ky, kx, ci)-major,
+// is the GEMM's transposed B. Bias rides the column epilogue.
+void convNhwcIm2col(const float* in, const float* weight, const float* bias, float* out, const ConvShape& s,
+                    const Conv2dParams& p) {
+    const int cinG = s.Cin / s.groups, coutG = s.Cout / s.groups;
+    const int taps = s.kH * s.kW, K = taps * cinG;
+    const int outPlane = s.Hout * s.Wout;
+    const int tileRows = std::max(kTileAlign, std::min(1024, kPatchBudget / K / kTileAlign * kTileAlign));
+
+    std::vector<float> w((size_t)s.Cout * K);
+    for (int co = 0; co < s.Cout; ++co) {
+        for (int ci = 0; ci < cinG; ++ci) {
+            for (int t = 0; t < taps; ++t) w[(size_t)co * K + t * cinG + ci] = weight[((size_t)co * cinG + ci) * taps + t];
+        }
+    }
+
+    for (int n = 0; n < s.N; ++n) {
+        const float* inN = in + (size_t)n * s.H * s.W * s.Cin;
+        for (int g = 0; g < s.groups; ++g) {
+            GemmEpilogue ep = epilogueFor(nullptr, p);
+            ep.colBias = bias ? bias + (size_t)g * coutG : nullptr;
+            const float* wG = w.data() + (size_t)g * coutG * K;
+            float* outG = out + (size_t)n * outPlane * s.Cout + (size_t)g * coutG;
+
+            ThreadPool::getInstance().parallelFor(0, outPlane, columnGrain(coutG, K), [&](int begin, int end) {
+                static thread_local std::vector<float> patch;
+                patch.resize((size_t)K * tileRows);
+                for (int j0 = begin; j0 < end; j0 += tileRows) {
+                    const int rows = std::min(tileRows, end - j0);
+                    for (int j = 0; j < rows; ++j) {
+                        const int oy = (j0 + j) / s.Wout, ox = (j0 + j) % s.Wout;
+                        float* row = patch.data() + (size_t)j * K;
+                        for (int ky = 0; ky < s.kH; ++ky) {
+                            const int iy = oy * p.strideH + ky * p.dilationH - p.padH;
+                            for (int kx = 0; kx < s.kW; ++kx, row += cinG) {
+                                const int ix = ox * p.strideW + kx * p.dilationW - p.padW;
+                                if (iy < 0 || iy >= s.H || ix < 0 || ix >= s.W) {
+                                    std::fill(row, row + cinG, 0.0f);
+                                } else {
+                                    std::memcpy(row, inN + ((size_t)iy * s.W + ix) * s.Cin + (size_t)g * cinG,
+                                                sizeof(float) * cinG);
+                                }
+                            }
+                        }
+                    }
+                    sgemm(false, true, rows, coutG, K, patch.data(), K, wG, K, outG + (size_t)j0 * s.Cout, s.Cout, ep);
+                }
+            });
+        }
+    }
+}
+
+// T output pixels of one channel block: per input channel, a broadcast input value times the
+// block-wide weight vector, accumulated in registers over every input block and tap. Taps
+// outside the input row read a zero pixel.
+template <int V, int T>
+inline void blockedConvTile(const float* in, const float* w, const ConvShape& s, const Conv2dParams& p, int CbIn,
+                            int oy, int ox0, const float* bias, float* dst) {
+    constexpr int B = V * simd::kWidth;
+    alignas(64) static const float kZeroPixel[B] = {};
+    simd::VecF acc[T][V];
+    for (int t = 0; t < T; ++t) {
+        for (int v = 0; v < V; ++v) acc[t][v] = simd::load(bias + v * simd::kWidth);
+    }
+    for (int cb = 0; cb < CbIn; ++cb) {
+        const float* plane = in + (size_t)cb * s.H * s.W * B;
+        for (int ky = 0; ky < s.kH; ++ky) {
+            const int iy = oy * p.strideH + ky * p.dilationH - p.padH;
+            if (iy < 0 || iy >= s.H) continue;
+            const float* row = plane + (size_t)iy * s.W * B;
+            for (int kx = 0; kx < s.kW; ++kx) {
+                const float* px[T];
+                for (int t = 0; t < T; ++t) {
+                    const int ix = (ox0 + t) * p.strideW + kx * p.dilationW - p.padW;
+                    px[t] = ix >= 0 && ix < s.W ? row + (size_t)ix * B : kZeroPixel;
+                }
+                const float* wk = w + (((size_t)cb * s.kH + ky) * s.kW + kx) * B * B;
+                for (int ci = 0; ci < B; ++ci, wk += B) {
+                    simd::VecF wv[V];
+                    for (int v = 0; v < V; ++v) wv[v] = simd::load(wk + v * simd::kWidth);
+                    for (int t = 0; t < T; ++t) {
+                        const simd::VecF a = simd::set1(px[t][ci]);
+                        for (int v = 0; v < V; ++v) acc[t][v] = simd::mulAdd(a, wv[v], acc[t][v]);
+                    }
+                }
+            }
+        }
+    }
+    for (int t = 0; t < T; ++t) {
+        for (int v = 0; v < V; ++v) simd::store(dst + t * B + v * simd::kWidth, acc[t][v]);
+    }
+}
+
+// NCHWc direct conv (groups 1) for blocks of V vectors: weights repacked to
+// [Cout blocks][Cin blocks][kH][kW][block in][block out], one output row of one block per task.
+template <int V>
+void convBlockedImpl(const float* in, const float* weight, const float* bias, float* out, const ConvShape& s,
+                     const Conv2dParams& p, MemoryFormat format) {
+    constexpr int B = V * simd::kWidth;
+    constexpr int T = V == 1 ? 8 : 6; // accumulators that fit the register file with the weights
+    const int CbIn = (s.Cin + B - 1) / B, CbOut = (s.Cout + B - 1) / B;
+    const int taps = s.kH * s.kW;
+
+    std::vector<float> w((size_t)CbOut * CbIn * taps * B * B, 0.0f);
+    for (int co = 0; co < s.Cout; ++co) {
+        for (int ci = 0; ci < s.Cin; ++ci) {
+            for (int t = 0; t < taps; ++t) {
+                w[((((size_t)(co / B) * CbIn + ci / B) * taps + t) * B + ci % B) * B + co % B] =
+                    weight[((size_t)co * s.Cin + ci) * taps + t];
+            }
+        }
+    }
+    const std::vector<float> b = bias ? layout::channelLanes(bias, 1, s.Cout, format, 0.0f)
+                                      : std::vector<float>((size_t)CbOut * B, 0.0f);
+    const long perRow = std::max(1L, (long)s.Wout * CbIn * taps * B * B);
+
+    ThreadPool::getInstance().parallelFor(0, s.N * CbOut * s.Hout, (int)std::max(1L, kMinChunkMacs / perRow),
+                                          [&](int begin, int end) {
+        for (int idx = begin; idx < end; ++idx) {
+            const int oy = idx % s.Hout, cbo = (idx / s.Hout) % CbOut, n = idx / s.Hout / CbOut;
+            const float* inN = in + (size_t)n * CbIn * s.H * s.W * B;
+            const float* wB = w.data() + (size_t)cbo * CbIn * taps * B * B;
+            const float* bB = b.data() + (size_t)cbo * B;
+            float* dstRow = out + (size_t)idx * s.Wout * B;
+            int ox = 0;
+            for (; ox + T <= s.Wout; ox += T) blockedConvTile<V, T>(inN, wB, s, p, CbIn, oy, ox, bB, dstRow + (size_t)ox * B);
+            for (; ox + 4 <= s.Wout; ox += 4) blockedConvTile<V, 4>(inN, wB, s, p, CbIn, oy, ox, bB, dstRow + (size_t)ox * B);
+            for (; ox + 2 <= s.Wout; ox += 2) blockedConvTile<V, 2>(inN, wB, s, p, CbIn, oy, ox, bB, dstRow + (size_t)ox * B);
+            for (; ox < s.Wout; ++ox) blockedConvTile<V, 1>(inN, wB, s, p, CbIn, oy, ox, bB, dstRow + (size_t)ox * B);
+            activateRow(dstRow, s.Wout * B, p.activation, p.alpha);
+        }
+    });
+}
+
+void convBlocked(const float* in, const float* weight, const float* bias, float* out, const ConvShape& s,
+                 const Conv2dParams& p, MemoryFormat format) {
+    switch (channelBlock(format) / simd::kWidth) {
+        case 1: convBlockedImpl<1>(in, weight, bias, out, s, p, format); break;
+        case 2: convBlockedImpl<2>(in, weight, bias, out, s, p, format); break;
+        case 4: convBlockedImpl<4>(in, weight, bias, out, s, p, format); break;
+        default: convBlockedImpl<8>(in, weight, bias, out, s, p, format); break;
+    }
+}
+
+// Convs on NHWC / blocked inputs produce the same format through the kernel specialized for
+// it. Shapes without one (depthwise multipliers > 1, grouped convs in blocked formats, blocks
+// narrower than a SIMD vector) round-trip through NCHW.
+Tensor convFormatted(const Tensor& input, const Tensor& weight, const Tensor* bias, const Conv2dParams& params,
+                     const ConvShape& s) {
+    const MemoryFormat format = input.getMemoryFormat();
+    const int block = channelBlock(format);
+    const bool depthwise = isDepthwise(s) && s.Cout == s.Cin;
+    const bool pointwise = s.groups == 1 && isPointwise(s, params);
+    const bool supported = depthwise || (format == MemoryFormat::NHWC ? !isDepthwise(s)
+                                                                      : s.groups == 1 && block % simd::kWidth == 0);
+    if (!supported) {
+        Tensor out = conv2d(input.toMemoryFormat(MemoryFormat::NCHW), weight, bias, params);
+        return out.toMemoryFormat(format);
+    }
+
+    Tensor src = input.toContiguous();
+    Tensor w = weight.toContiguous();
+    Tensor b;
+    const float* biasData = nullptr;
+    if (bias != nullptr) {
+        assert(bias->getDevice() == Device::CPU && bias->size() == s.Cout);
+        b = bias->toContiguous();
+        biasData = b.data();
+    }
+
+    Tensor out = Tensor::withMemoryFormat({s.N, s.Cout, s.Hout, s.Wout}, format);
+    const char* path;
+    if (depthwise) {
+        convDepthwisePixels(src.data(), w.data(), biasData, out.data(), s, params, format);
+        path = "direct";
+    } else if (format == MemoryFormat::NHWC && pointwise) { // the input pixels are the GEMM's A
+        GemmEpilogue ep = epilogueFor(nullptr, params);
+        ep.colBias = biasData;
+        sgemm(false, true, s.N * s.H * s.W, s.Cout, s.Cin, src.data(), s.Cin, w.data(), s.Cin, out.data(), s.Cout, ep);
+        path = "direct";
+    } else if (format == MemoryFormat::NHWC) {
+        convNhwcIm2col(src.data(), w.data(), biasData, out.data(), s, params);
+        path = "im2col+gemm";
+    } else {
+        convBlocked(src.data(), w.data(), biasData, out.data(), s, params, format);
+        path = "direct";
+    }
+
+    LOG_TENSOR_OP("CONV2D", "CPU", out.getShape(), true, std::string(path) + " " + memoryFormatName(format));
+    return out;
+}
+
+enum class PoolMode { Max, Avg };
+
+inline simd::VecF poolVec(simd::VecF a, simd::VecF b, PoolMode mode) {
+    return mode == PoolMode::Max ? simd::max(a, b) : simd::add(a, b);
+}
+
+inline float poolScalar(float a, float b, PoolMode mode) {
+    return mode == PoolMode::Max ? std::max(a, b) : a + b;
+}
+
+// dst[o * L + l] = max(dst, src[o * step + l]) or dst + src for `count` pixels of L lanes
+inline void poolPixels(float* dst, const float* src, int step, int L, int count, PoolMode mode) {
+    if (step == L) { // one contiguous run
+        const int n = count * L;
+        int i = 0;
+        for (; i + simd::kWidth <= n; i += simd::kWidth) {
+            simd::store(dst + i, poolVec(simd::load(dst + i), simd::load(src + i), mode));
+        }
+        for (; i < n; ++i) dst[i] = poolScalar(dst[i], src[i], mode);
+        return;
+    }
+    for (int o = 0; o < count; ++o, dst += L, src += step) {
+        int l = 0;
+        for (; l + simd::kWidth <= L; l += simd::kWidth) {
+            simd::store(dst + l, poolVec(simd::load(dst + l), simd::load(src + l), mode));
+        }
+        for (; l < L; ++l) dst[l] = poolScalar(dst[l], src[l], mode);
+    }
+}
+
+Tensor pool2d(const Tensor& input, const Pool2dParams& params, PoolMode mode) {
+    assert(input.getDevice() == Device::CPU);
+    const std::vector<int> shape = input.getLogicalShape();
+    const MemoryFormat format = input.getMemoryFormat();
+    const int kH = params.kernelH, kW = params.kernelW;
+    const int sH = params.strideH > 0 ? params.strideH : kH;
+    const int sW = params.strideW > 0 ? params.strideW : kW;
+    assert(kH > 0 && kW > 0 && 2 * params.padH <= kH && 2 * params.padW <= kW);
+
+    const int N = shape[0], C = shape[1], H = shape[2], W = shape[3];
+    const int Hout = convOutputSize(H, kH, sH, params.padH);
+    const int Wout = convOutputSize(W, kW, sW, params.padW);
+    assert(Hout > 0 && Wout > 0);
+
+    Tensor src = input.toContiguous();
+    Tensor out = Tensor::withMemoryFormat({N, C, Hout, Wout}, format);
+    const float* in = src.data();
+    float* o = out.data();
+    const int plane = H * W, outPlane = Hout * Wout;
+
+    std::vector<int> xLo(kW), xHi(kW);
+    for (int kx = 0; kx < kW; ++kx) validRange(Wout, sW, kx - params.padW, W, xLo[kx], xHi[kx]);
+    std::vector<float> colCount(Wout, 0.0f); // in-bounds taps per output column
+    for (int kx = 0; kx < kW; ++kx) {
+        for (int ox = xLo[kx]; ox < xHi[kx]; ++ox) colCount[ox] += 1.0f;
+    }
+
+    const float init = mode == PoolMode::Max ? -std::numeric_limits<float>::infinity() : 0.0f;
+    if (format != MemoryFormat::NCHW) { // whole pixel runs per tap, one output row of one plane per task
+        const PixelRuns r = pixelRuns(format, N, C);
+        const int L = r.lanes;
+        ThreadPool::getInstance().parallelFor(0, r.planes * Hout, std::max(1, kDefaultGrainSize / std::max(1, Wout * L * kH * kW)),
+                                              [&](int begin, int end) {
+            for (int idx = begin; idx < end; ++idx) {
+                const float* srcPlane = in + (size_t)(idx / Hout) * plane * L;
+                const int oy = idx % Hout;
+                float* dstRow = o + (size_t)idx * Wout * L;
+                simd::fill(dstRow, Wout * L, init);
+                int rows = 0;
+                for (int ky = 0; ky < kH; ++ky) {
+                    const int iy = oy * sH + ky - params.padH;
+                    if (iy < 0 || iy >= H) continue;
+                    ++rows;
+                    const float* srcRow = srcPlane + (size_t)iy * W * L;
+                    for (int kx = 0; kx < kW; ++kx) {
+                        const int lo = xLo[kx], hi = xHi[kx], dx = kx - params.padW;
+                        if (lo < hi) {
+                            poolPixels(dstRow + (size_t)lo * L, srcRow + (size_t)(lo * sW + dx) * L, sW * L, L, hi - lo, mode);
+                        }
+                    }
+                }
+                if (mode == PoolMode::Avg) {
+                    for (int x = 0; x < Wout; ++x) {
+                        const float count = params.countIncludePad ? (float)(kH * kW) : (float)rows * colCount[x];
+                        const float inv = 1.0f / count;
+                        for (int l = 0; l < L; ++l) dstRow[(size_t)x * L + l] *= inv;
+                    }
+                }
+            }
+        });
+        return out;
+    }
+
+    ThreadPool::getInstance().parallelFor(0, N * C, std::max(1, kDefaultGrainSize / std::max(1, plane)),
+                                          [&](int begin, int end) {
+        for (int idx = begin; idx < end; ++idx) {
+            const float* srcPlane = in + (size_t)idx * plane;
+            float* dstPlane = o + (size_t)idx * outPlane;
+            for (int oy = 0; oy < Hout; ++oy) {
+                float* dstRow = dstPlane + (size_t)oy * Wout;
+                simd::fill(dstRow, Wout, init);
+                int rows = 0;
+                for (int ky = 0; ky < kH; ++ky) {
+                    const int iy = oy * sH + ky - params.padH;
+                    if (iy < 0 || iy >= H) continue;
+                    ++rows;
+                    const float* srcRow = srcPlane + (size_t)iy * W;
+                    for (int kx = 0; kx < kW; ++kx) {
+                        const int lo = xLo[kx], hi = xHi[kx], dx = kx - params.padW;
+                        if (sW == 1) {
+                            const float* s = srcRow + dx;
+                            int x = lo;
+                            for (; x + simd::kWidth <= hi; x += simd::kWidth) {
+                                const simd::VecF a = simd::load(dstRow + x), b = simd::load(s + x);
+                                simd::store(dstRow + x, mode == PoolMode::Max ? simd::max(a, b) : simd::add(a, b));
+                            }
+                            for (; x < hi; ++x) dstRow[x] = mode == PoolMode::Max ? std::max(dstRow[x], s[x]) : dstRow[x] + s[x];
+                        } else {
+                            for (int x = lo; x < hi; ++x) {
+                                const float v = srcRow[x * sW + dx];
+                                dstRow[x] = mode == PoolMode::Max ? std::max(dstRow[x], v) : dstRow[x] + v;
+                            }
+                        }
+                    }
+                }
+                if (mode == PoolMode::Avg) {
+                    if (params.countIncludePad) {
+                        kernels::mulScalar(dstRow, Wout, 1.0f / (float)(kH * kW));
+                    } else {
+                        for (int x = 0; x < Wout; ++x) dstRow[x] /= (float)rows * colCount[x];
+                    }
+                }
+            }
+        }
+    });
+    return out;
+}
+
+} // namespace
+
+int convOutputSize(int in, int kernel, int stride, int pad, int dilation) {
+    return (in + 2 * pad - dilation * (kernel - 1) - 1) / stride + 1;
+}
+
+ConvAlgo selectConvAlgo(const std::vector<int>& inputShape, const std::vector<int>& weightShape,
+                        const Conv2dParams& params) {
+    const ConvShape s = convShape(inputShape, weightShape, params);
+    if (isDepthwise(s) || isPointwise(s, params)) return ConvAlgo::Direct;
+    // The transforms only pay off with enough channels and large planes; below ~32x32 outputs
+    // the packed im2col GEMM is faster
+    if (fitsWinograd(s, params) && s.Cin >= 16 && s.Cout >= 16 && s.Hout * s.Wout >= 1024) return ConvAlgo::Winograd;
+    return ConvAlgo::Im2colGemm;
+}
+
+Tensor conv2d(const Tensor& input, const Tensor& weight, const Tensor* bias, const Conv2dParams& params) {
+    assert(input.getDevice() == Device::CPU && weight.getDevice() == Device::CPU);
+    assert(weight.getMemoryFormat() == MemoryFormat::NCHW);
+    const ConvShape s = convShape(input.getLogicalShape(), weight.getShape(), params);
+    assert(params.strideH > 0 && params.strideW > 0 && params.dilationH > 0 && params.dilationW > 0);
+    if (input.getMemoryFormat() != MemoryFormat::NCHW) return convFormatted(input, weight, bias, params, s);
+
+    ConvAlgo algo = params.algo;
+    if (algo == ConvAlgo::Auto) algo = selectConvAlgo(input.getShape(), weight.getShape(), params);
+
+    Tensor src = input.toContiguous();
+    Tensor w = weight.toContiguous();
+    Tensor b;
+    const float* biasData = nullptr;
+    if (bias != nullptr) {
+        assert(bias->getDevice() == Device::CPU && bias->size() == s.Cout);
+        b = bias->toContiguous();
+        biasData = b.data();
+    }
+
+    Tensor out({s.N, s.Cout, s.Hout, s.Wout});
+    switch (algo) {
+        case ConvAlgo::Direct:
+            if (isDepthwise(s)) {
+                convDepthwise(src.data(), w.data(), biasData, out.data(), s, params);
+            } else {
+                assert(isPointwise(s, params));
+                convPointwise(src.data(), w.data(), biasData, out.data(), s, params);
+            }
+            break;
+        case ConvAlgo::Winograd:
+            assert(fitsWinograd(s, params));
+            convWinograd(src.data(), w.data(), biasData, out.data(), s, params);
+            break;
+        default:
+            convIm2col(src.data(), w.data(), biasData, out.data(), s, params);
+            break;
+    }
+
+    LOG_TENSOR_OP("CONV2D", "CPU", out.getShape(), true, algoName(algo));
+    return out;
+}
+
+Tensor depthwiseConv2d(const Tensor& input, const Tensor& weight, const Tensor* bias, const Conv2dParams& params) {
+    assert(weight.getShape().size() == 4 && weight.getShape()[1] == 1);
+    Conv2dParams p = params;
+    p.groups = input.getChannels();
+    if (p.algo == ConvAlgo::Auto) p.algo = ConvAlgo::Direct;
+    return conv2d(input, weight, bias, p);
+}
+
+Tensor maxPool2d(const Tensor& input, const Pool2dParams& params) {
+    Tensor out = pool2d(input, params, PoolMode::Max);
+    LOG_TENSOR_OP("MAX_POOL", "CPU", out.getShape(), true, "");
+    return out;
+}
+
+Tensor avgPool2d(const Tensor& input, const Pool2dParams& params) {
+    Tensor out = pool2d(input, params, PoolMode::Avg);
+    LOG_TENSOR_OP("AVG_POOL", "CPU", out.getShape(), true, "");
+    return out;
+}
+
+Tensor globalAvgPool(const Tensor& input) {
+    assert(input.getDevice() == Device::CPU);
+    const std::vector<int> shape = input.getLogicalShape();
+    const MemoryFormat format = input.getMemoryFormat();
+    const int N = shape[0], C = shape[1], plane = shape[2] * shape[3];
+
+    Tensor src = input.toContiguous();
+    Tensor out = Tensor::withMemoryFormat({N, C, 1, 1}, format);
+    const float* in = src.data();
+    float* o = out.data();
+    const float scale = 1.0f / (float)plane;
+
+    if (format != MemoryFormat::NCHW) { // sum the pixel runs of each plane lane-wise
+        const PixelRuns r = pixelRuns(format, N, C);
+        const int L = r.lanes;
+        ThreadPool::getInstance().parallelFor(0, r.planes, std::max(1, kDefaultGrainSize / std::max(1, plane * L)),
+                                              [&](int begin, int end) {
+            for (int q = begin; q < end; ++q) {
+                float* acc = o + (size_t)q * L;
+                const float* x = in + (size_t)q * plane * L;
+                if (simd::kWidth % L == 0) { // whole vectors hold kWidth / L pixels: sum flat, then fold
+                    const int n = plane * L;
+                    simd::VecF v = simd::set1(0.0f);
+                    int i = 0;
+                    for (; i + simd::kWidth <= n; i += simd::kWidth) v = simd::add(v, simd::load(x + i));
+                    float lanes[simd::kWidth];
+                    simd::store(lanes, v);
+                    for (int l = 0; l < simd::kWidth; ++l) acc[l % L] += lanes[l];
+                    for (; i < n; ++i) acc[i % L] += x[i];
+                } else {
+                    for (int i = 0; i < plane; ++i) poolPixels(acc, x + (size_t)i * L, L, L, 1, PoolMode::Avg);
+                }
+                for (int l = 0; l < L; ++l) acc[l] *= scale;
+            }
+        });
+        LOG_TENSOR_OP("GLOBAL_AVG_POOL", "CPU", out.getShape(), true, memoryFormatName(format));
+        return out;
+    }
+
+    ThreadPool::getInstance().parallelFor(0, N * C, std::max(1, kDefaultGrainSize / std::max(1, plane)),
+                                          [&](int begin, int end) {
+        for (int idx = begin; idx < end; ++idx) {
+            const float* x = in + (size_t)idx * plane;
+            simd::VecF acc = simd::set1(0.0f);
+            int i = 0;
+            for (; i + simd::kWidth <= plane; i += simd::kWidth) acc = simd::add(acc, simd::load(x + i));
+            float lanes[simd::kWidth];
+            simd::store(lanes, acc);
+            float sum = 0.0f;
+            for (float l : lanes) sum += l;
+            for (; i < plane; ++i) sum += x[i];
+            o[idx] = sum * scale;
+        }
+    });
+
+    LOG_TENSOR_OP("GLOBAL_AVG_POOL", "CPU", out.getShape(), true, "");
+    return out;
+}
@@ -0,0 +1,175 @@
+#include "layout.hpp"
+#include "kernels.hpp"
+#include "strided_copy.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+
+namespace {
+
+constexpr int kTile = 8;     // minimum pixels per chunk
+constexpr int kSpan = 1024;  // elements of repeated lane pattern per ChannelPattern group
+
+// Runs fn(n, p0, p1) over pixel ranges [p0, p1) of image n, covering every pixel of the batch
+// with chunks split across the pool (about kDefaultGrainSize elements each).
+template <typename Fn>
+void forPixels(int N, int HW, int C, Fn fn) {
+    const int grain = std::max(kTile, kDefaultGrainSize / std::max(1, C));
+    ThreadPool::getInstance().parallelFor(0, N * HW, grain, [&](int begin, int end) {
+        while (begin < end) {
+            const int n = begin / HW, p0 = begin % HW;
+            const int p1 = std::min(HW, p0 + (end - begin));
+            fn(n, p0, p1);
+            begin += p1 - p0;
+        }
+    });
+}
+
+inline void zeroLanes(float* dst, int pixels, int from, int block) {
+    if (from == block) return;
+    for (int p = 0; p < pixels; ++p) std::fill(dst + (size_t)p * block + from, dst + (size_t)(p + 1) * block, 0.0f);
+}
+
+} // namespace
+
+namespace layout {
+
+void nchwToNhwc(const float* src, float* dst, int N, int C, int HW) {
+    strided::pack(src, {N, HW, C}, {C * HW, 1, HW}, dst);
+}
+
+void nhwcToNchw(const float* src, float* dst, int N, int C, int HW) {
+    strided::pack(src, {N, C, HW}, {HW * C, 1, C}, dst);
+}
+
+void nchwToBlocked(const float* src, float* dst, int N, int C, int HW, int block) {
+    const int Cb = (C + block - 1) / block;
+    if (C % block == 0) { // no padding lanes: one batched transpose per block of channel planes
+        strided::pack(src, {N, Cb, HW, block}, {C * HW, block * HW, 1, HW}, dst);
+        return;
+    }
+    forPixels(N, HW, Cb * block, [&](int n, int p0, int p1) {
+        for (int cb = 0; cb < Cb; ++cb) {
+            const int count = std::min(block, C - cb * block);
+            float* out = dst + (((size_t)n * Cb + cb) * HW + p0) * block;
+            strided::transpose2d(src + ((size_t)n * C + (size_t)cb * block) * HW + p0, HW, out, block, count, p1 - p0);
+            zeroLanes(out, p1 - p0, count, block);
+        }
+    });
+}
+
+void blockedToNchw(const float* src, float* dst, int N, int C, int HW, int block) {
+    const int Cb = (C + block - 1) / block;
+    if (C % block == 0) {
+        strided::pack(src, {N, Cb, block, HW}, {Cb * HW * block, HW * block, 1, block}, dst);
+        return;
+    }
+    forPixels(N, HW, Cb * block, [&](int n, int p0, int p1) {
+        for (int cb = 0; cb < Cb; ++cb) {
+            const int count = std::min(block, C - cb * block);
+            strided::transpose2d(src + (((size_t)n * Cb + cb) * HW + p0) * block, block,
+                                 dst + ((size_t)n * C + (size_t)cb * block) * HW + p0, HW, p1 - p0, count);
+        }
+    });
+}
+
+void nhwcToBlocked(const float* src, float* dst, int N, int C, int HW, int block) {
+    const int Cb = (C + block - 1) / block;
+    forPixels(N, HW, Cb * block, [&](int n, int p0, int p1) {
+        for (int cb = 0; cb < Cb; ++cb) {
+            const int count = std::min(block, C - cb * block);
+            const float* in = src + ((size_t)n * HW + p0) * C + (size_t)cb * block;
+            float* out = dst + (((size_t)n * Cb + cb) * HW + p0) * block;
+            for (int p = 0; p < p1 - p0; ++p) std::copy(in + (size_t)p * C, in + (size_t)p * C + count, out + (size_t)p * block);
+            zeroLanes(out, p1 - p0, count, block);
+        }
+    });
+}
+
+void blockedToNhwc(const float* src, float* dst, int N, int C, int HW, int block) {
+    const int Cb = (C + block - 1) / block;
+    forPixels(N, HW, Cb * block, [&](int n, int p0, int p1) {
+        for (int cb = 0; cb < Cb; ++cb) {
+            const int count = std::min(block, C - cb * block);
+            const float* in = src + (((size_t)n * Cb + cb) * HW + p0) * block;
+            float* out = dst + ((size_t)n * HW + p0) * C + (size_t)cb * block;
+            for (int p = 0; p < p1 - p0; ++p) std::copy(in + (size_t)p * block, in + (size_t)p * block + count, out + (size_t)p * C);
+        }
+    });
+}
+
+std::vector<float> channelLanes(const float* values, int stride, int C, MemoryFormat format, float pad) {
+    const int block = channelBlock(format);
+    std::vector<float> lanes((size_t)(C + block - 1) / block * block, pad);
+    for (int c = 0; c < C; ++c) lanes[c] = values[(size_t)c * stride];
+    return lanes;
+}
+
+ChannelPattern::ChannelPattern(const float* values, int stride, MemoryFormat format, int channels, int plane,
+                               float pad)
+    : format(format), channels(channels), plane(plane), lanes(channelLanes(values, stride, channels, format, pad)) {
+    period = format == MemoryFormat::NHWC ? channels : channelBlock(format);
+    if (format == MemoryFormat::NCHW) {
+        span = 0;
+        return;
+    }
+    // Whole periods, so a chunk of `span` elements leaves the phase where it was
+    span = std::max(1, kSpan / period) * period;
+    const int groups = (int)lanes.size() / period;
+    pattern.resize((size_t)groups * (span + period));
+    for (int g = 0; g < groups; ++g) {
+        float* dst = pattern.data() + (size_t)g * (span + period);
+        for (int i = 0; i < span + period; ++i) dst[i] = lanes[(size_t)g * period + i % period];
+    }
+}
+
+template <typename PerChannel, typename PerSpan>
+void ChannelPattern::forRuns(long begin, int n, PerChannel perChannel, PerSpan perSpan) const {
+    const long end = begin + n;
+    long pos = begin;
+    if (format == MemoryFormat::NCHW) { // one channel per H*W run
+        while (pos < end) {
+            const long runEnd = std::min(end, (pos / plane + 1) * plane);
+            perChannel((int)(pos - begin), (int)((pos / plane) % channels), (int)(runEnd - pos));
+            pos = runEnd;
+        }
+        return;
+    }
+
+    // NHWC repeats one group forever; blocked formats switch group every H*W pixels
+    const int groups = (int)lanes.size() / period;
+    const long groupRun = (long)plane * period;
+    while (pos < end) {
+        int g = 0;
+        long runEnd = end;
+        if (format != MemoryFormat::NHWC) {
+            g = (int)((pos / groupRun) % groups);
+            runEnd = std::min(end, (pos / groupRun + 1) * groupRun);
+        }
+        const long src = (long)g * (span + period) + pos % period;
+        while (pos < runEnd) {
+            const int len = (int)std::min<long>(span, runEnd - pos);
+            perSpan((int)(pos - begin), src, len);
+            pos += len;
+        }
+    }
+}
+
+void ChannelPattern::apply(float* x, long begin, int n, ChannelOp op) const {
+    const float* p = pattern.data();
+    if (op == ChannelOp::Add) {
+        forRuns(begin, n, [&](int i, int c, int len) { kernels::addScalar(x + i, len, lanes[c]); },
+                [&](int i, long src, int len) { kernels::add(x + i, p + src, len); });
+    } else {
+        forRuns(begin, n, [&](int i, int c, int len) { kernels::mulScalar(x + i, len, lanes[c]); },
+                [&](int i, long src, int len) { kernels::mul(x + i, p + src, len); });
+    }
+}
+
+void ChannelPattern::applyAffine(float* x, long begin, int n, const ChannelPattern& shift) const {
+    const float* p = pattern.data();
+    const float* q = shift.pattern.data();
+    forRuns(begin, n, [&](int i, int c, int len) { kernels::affineScalar(x + i, len, lanes[c], shift.lanes[c]); },
+            [&](int i, long src, int len) { kernels::affine(x + i, p + src, q + src, len); });
+}
+
+} // namespace layout
@@ -3,21 +3,136 @@
 //
 
 #include "logger.hpp"
+#include "memory_tracker.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <ctime>
 
+namespace {
+
+constexpr size_t kRecordText = 224; // longer messages are cut and end in "..."
+const char* const kLevelTags[] = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// One log line before the timestamp and tag are added by the writer
+struct Logger::Record {
+    int64_t timeNs;
+    const char* tag; // string literal: level name, "PERFORMANCE", "MEMORY", ...
+    LogLevel level;
+    uint32_t length;
+    size_t pos; // ring position this record was claimed at
+    char text[kRecordText];
+
+    void append(const char* s, size_t n) {
+        const size_t room = kRecordText - length;
+        if (n > room) { // truncated: mark it
+            std::memcpy(text + length, s, room);
+            length = kRecordText;
+            std::memcpy(text + kRecordText - 3, "...", 3);
+            return;
+        }
+        std::memcpy(text + length, s, n);
+        length += (uint32_t)n;
+    }
+    Record& operator<<(const char* s) { append(s, std::strlen(s)); return *this; }
+    Record& operator<<(const std::string& s) { append(s.data(), s.size()); return *this; }
+    Record& operator<<(long long v) {
+        char buf[24];
+        append(buf, (size_t)std::snprintf(buf, sizeof(buf), "%lld", v));
+        return *this;
+    }
+    Record& operator<<(const std::vector<int>& shape) {
+        *this << "[";
+        for (size_t i = 0; i < shape.size(); ++i) {
+            if (i > 0) *this << ", ";
+            *this << (long long)shape[i];
+        }
+        return *this << "]";
+    }
+};
+
+// Bounded MPSC queue (Vyukov-style): every slot carries a sequence number. A producer claims
+// position p with one CAS on `tail` once slot p's sequence says it is free, fills it and
+// publishes by setting the sequence to p + 1; the single consumer frees it with p + capacity.
+struct Logger::Ring {
+    struct Slot {
+        std::atomic<size_t> seq;
+        Record record;
+    };
+
+    explicit Ring(size_t capacity) : mask(capacity - 1), slots(new Slot[capacity]) {
+        for (size_t i = 0; i < capacity; ++i) slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // Null when the queue is full
+    Record* tryClaim() {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & mask];
+            const intptr_t diff = (intptr_t)slot.seq.load(std::memory_order_acquire) - (intptr_t)pos;
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record.pos = pos;
+                    return &slot.record;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(Record* record) {
+        slots[record->pos & mask].seq.store(record->pos + 1, std::memory_order_release);
+    }
+
+    // Consumer side: the next published record, or null
+    Record* front() {
+        const size_t pos = head.load(std::memory_order_relaxed);
+        Slot& slot = slots[pos & mask];
+        return slot.seq.load(std::memory_order_acquire) == pos + 1 ? &slot.record : nullptr;
+    }
+
+    void pop() {
+        const size_t pos = head.load(std::memory_order_relaxed);
+        slots[pos & mask].seq.store(pos + mask + 1, std::memory_order_release);
+        head.store(pos + 1, std::memory_order_relaxed);
+    }
+
+    size_t backlog() const {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed);
+    }
+
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<size_t> head{0}; // written by the consumer only
+};
+
 Logger& Logger::getInstance() {
     static Logger instance;
     return instance;
 }
 
-void Logger::initialize(const std::string& logFilePath, LogLevel level, bool consoleOutput) {
-    currentLevel = level;
-    this->consoleOutput = consoleOutput;
+Logger::~Logger() {
+    close();
+}
 
-    if (logFile.is_open()) {
-        logFile.close();
-    }
+void Logger::initialize(const std::string& logFilePath, LogLevel level, bool consoleOutput,
+                        const LoggerOptions& options) {
+    close();
+    currentLevel.store((int)level, std::memory_order_relaxed);
+    this->consoleOutput = consoleOutput;
+    this->options = options;
 
     logFile.open(logFilePath, std::ios::app);
     if (!logFile.is_open()) {
@@ -25,7 +140,12 @@ void Logger::initialize(const std::string& logFilePath, LogLevel level, bool con
         return;
     }
 
-    initialized = true;
+    // The ring lives as long as the logger: a producer racing close() may still hold a slot
+    if (!ring) {
+        size_t capacity = 2;
+        while (capacity < std::max<size_t>(options.queueCapacity, 2)) capacity *= 2;
+        ring = std::make_unique<Ring>(capacity);
+    }
 
     // Log initialization
     std::string initMsg = "=== Traffic Sign Recognition Application Logger Initialized ===";
@@ -33,7 +153,13 @@ void Logger::initialize(const std::string& logFilePath, LogLevel level, bool con
     if (consoleOutput) {
         std::cout << getCurrentTimestamp() << " [INIT] " << initMsg << std::endl;
     }
-    logFile.flush();
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopRequested = false;
+    }
+    running.store(true, std::memory_order_release);
+    writer = std::thread(&Logger::writerLoop, this);
 }
 
 void Logger::debug(const std::string& message, const std::string& component) {
@@ -58,162 +184,212 @@ void Logger::critical(const std::string& message, const std::string& component)
 
 void Logger::logPerformance(const std::string& operation, const std::string& device,
                             long long microseconds, const std::string& additionalInfo) {
-    if (!initialized) return;
+    Record* r = claim(LogLevel::INFO, "PERFORMANCE");
+    if (r == nullptr) return;
 
-    std::ostringstream oss;
-    oss << "PERF [" << device << "] " << operation << ": " << microseconds << " μs";
+    *r << "PERF [" << device << "] " << operation << ": " << microseconds << " μs";
     if (!additionalInfo.empty()) {
-        oss << " (" << additionalInfo << ")";
-    }
-
-    std::string logMessage = oss.str();
-
-    if (logFile.is_open()) {
-        logFile << getCurrentTimestamp() << " [PERFORMANCE] " << logMessage << std::endl;
-        logFile.flush();
-    }
-
-    if (consoleOutput) {
-        std::cout << getCurrentTimestamp() << " [PERFORMANCE] " << logMessage << std::endl;
+        *r << " (" << additionalInfo << ")";
     }
+    publish(r);
 }
 
 void Logger::logTensorOperation(const std::string& operation, const std::string& device,
                                 const std::vector<int>& shape, bool success, const std::string& errorMsg) {
-    if (!initialized) return;
-
-    std::ostringstream oss;
-    oss << "TENSOR [" << device << "] " << operation << " - Shape: " << formatShape(shape);
-    oss << " - " << (success ? "SUCCESS" : "FAILED");
-    if (!success && !errorMsg.empty()) {
-        oss << " - Error: " << errorMsg;
-    }
-
-    std::string logMessage = oss.str();
     LogLevel level = success ? LogLevel::INFO : LogLevel::ERROR;
+    Record* r = claim(level, success ? "INFO" : "ERROR");
+    if (r == nullptr) return;
 
-    if (logFile.is_open()) {
-        logFile << getCurrentTimestamp() << " [" << logLevelToString(level) << "] " << logMessage << std::endl;
-        logFile.flush();
-    }
-
-    if (consoleOutput) {
-        std::cout << getCurrentTimestamp() << " [" << logLevelToString(level) << "] " << logMessage << std::endl;
+    *r << "TENSOR [" << device << "] " << operation << " - Shape: " << shape;
+    *r << " - " << (success ? "SUCCESS" : "FAILED");
+    if (!success && !errorMsg.empty()) {
+        *r << " - Error: " << errorMsg;
     }
+    publish(r);
 }
 
 void Logger::logCudaOperation(const std::string& operation, const std::string& kernelName,
                               int blockSize, int gridSize, bool success, const std::string& errorMsg) {
-    if (!initialized) return;
-
-    std::ostringstream oss;
-    oss << "CUDA [" << operation << "] Kernel: " << kernelName;
-    oss << " - Grid: " << gridSize << "x" << blockSize;
-    oss << " - " << (success ? "SUCCESS" : "FAILED");
-    if (!success && !errorMsg.empty()) {
-        oss << " - Error: " << errorMsg;
-    }
-
-    std::string logMessage = oss.str();
     LogLevel level = success ? LogLevel::INFO : LogLevel::ERROR;
+    Record* r = claim(level, success ? "INFO" : "ERROR");
+    if (r == nullptr) return;
 
-    if (logFile.is_open()) {
-        logFile << getCurrentTimestamp() << " [" << logLevelToString(level) << "] " << logMessage << std::endl;
-        logFile.flush();
-    }
-
-    if (consoleOutput) {
-        std::cout << getCurrentTimestamp() << " [" << logLevelToString(level) << "] " << logMessage << std::endl;
+    *r << "CUDA [" << operation << "] Kernel: " << kernelName;
+    *r << " - Grid: " << (long long)gridSize << "x" << (long long)blockSize;
+    *r << " - " << (success ? "SUCCESS" : "FAILED");
+    if (!success && !errorMsg.empty()) {
+        *r << " - Error: " << errorMsg;
     }
+    publish(r);
 }
 
 void Logger::logMemoryAllocation(const std::string& device, size_t sizeBytes, const std::string& purpose) {
-    if (!initialized) return;
+    Record* r = claim(LogLevel::INFO, "MEMORY");
+    if (r == nullptr) return;
 
-    std::ostringstream oss;
-    oss << "MEMORY [" << device << "] ALLOC: " << sizeBytes << " bytes";
+    *r << "MEMORY [" << device << "] ALLOC: " << (long long)sizeBytes << " bytes";
     if (!purpose.empty()) {
-        oss << " - Purpose: " << purpose;
-    }
-
-    std::string logMessage = oss.str();
-
-    if (logFile.is_open()) {
-        logFile << getCurrentTimestamp() << " [MEMORY] " << logMessage << std::endl;
-        logFile.flush();
-    }
-
-    if (consoleOutput) {
-        std::cout << getCurrentTimestamp() << " [MEMORY] " << logMessage << std::endl;
+        *r << " - Purpose: " << purpose;
     }
+    publish(r);
 }
 
 void Logger::logMemoryDeallocation(const std::string& device, size_t sizeBytes, const std::string& purpose) {
-    if (!initialized) return;
+    Record* r = claim(LogLevel::INFO, "MEMORY");
+    if (r == nullptr) return;
 
-    std::ostringstream oss;
-    oss << "MEMORY [" << device << "] DEALLOC: " << sizeBytes << " bytes";
+    *r << "MEMORY [" << device << "] DEALLOC: " << (long long)sizeBytes << " bytes";
     if (!purpose.empty()) {
-        oss << " - Purpose: " << purpose;
-    }
-
-    std::string logMessage = oss.str();
-
-    if (logFile.is_open()) {
-        logFile << getCurrentTimestamp() << " [MEMORY] " << logMessage << std::endl;
-        logFile.flush();
-    }
-
-    if (consoleOutput) {
-        std::cout << getCurrentTimestamp() << " [MEMORY] " << logMessage << std::endl;
+        *r << " - Purpose: " << purpose;
     }
+    publish(r);
 }
 
 void Logger::setLogLevel(LogLevel level) {
-    currentLevel = level;
+    currentLevel.store((int)level, std::memory_order_relaxed);
 }
 
 void Logger::flush() {
-    if (logFile.is_open()) {
-        logFile.flush();
-    }
+    if (!running.load(std::memory_order_acquire)) return;
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    const uint64_t ticket = ++flushRequested;
+    wake.notify_one();
+    drained.wait(lock, [&] { return flushCompleted >= ticket || stopRequested; });
 }
 
 void Logger::close() {
-    if (initialized) {
-        std::string closeMsg = "=== Traffic Sign Recognition Application Logger Closing ===";
-        if (logFile.is_open()) {
-            logFile << getCurrentTimestamp() << " [SHUTDOWN] " << closeMsg << std::endl;
-            logFile.flush();
-            logFile.close();
-        }
-        if (consoleOutput) {
-            std::cout << getCurrentTimestamp() << " [SHUTDOWN] " << closeMsg << std::endl;
-        }
+    if (!running.load(std::memory_order_acquire)) return;
+
+    if (options.reportMemoryLeaks) MemoryTracker::getInstance().reportLeaks();
+    flush(); // make room so the closing line is not dropped
+    if (Record* r = claim(LogLevel::CRITICAL, "SHUTDOWN")) {
+        *r << "=== Traffic Sign Recognition Application Logger Closing ===";
+        publish(r);
+    }
+    running.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopRequested = true;
     }
+    wake.notify_one();
+    writer.join();
+    logFile.close();
+}
+
+uint64_t Logger::getWrittenCount() const {
+    return written.load(std::memory_order_relaxed);
+}
 
-    initialized = false;
+uint64_t Logger::getDroppedCount() const {
+    return dropped.load(std::memory_order_relaxed);
 }
 
 void Logger::log(LogLevel level, const std::string& message, const std::string& component) {
-    if (!initialized || level < currentLevel) return;
+    Record* r = claim(level, nullptr);
+    if (r == nullptr) return;
 
-    std::lock_guard<std::mutex> lock(logMutex);
-    std::ostringstream oss;
-    oss << message;
+    *r << message;
     if (!component.empty()) {
-        oss << " [Component: " << component << "]";
+        *r << " [Component: " << component << "]";
     }
+    publish(r);
+}
 
-    std::string logMessage = oss.str();
+Logger::Record* Logger::claim(LogLevel level, const char* tag) {
+    if ((int)level < currentLevel.load(std::memory_order_relaxed) || !running.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
 
-    if (logFile.is_open()) {
-        logFile << getCurrentTimestamp() << " [" << logLevelToString(level) << "] " << logMessage << std::endl;
-        logFile.flush();
+    Record* r = ring->tryClaim();
+    while (r == nullptr) {
+        if (options.overflow == LogOverflow::Drop || !running.load(std::memory_order_acquire)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        wake.notify_one(); // Block: make sure the writer is draining, then retry
+        std::this_thread::yield();
+        r = ring->tryClaim();
     }
 
-    if (consoleOutput) {
-        std::cout << getCurrentTimestamp() << " [" << logLevelToString(level) << "] " << logMessage << std::endl;
+    r->timeNs = nowNs();
+    r->tag = tag;
+    r->level = level;
+    r->length = 0;
+    return r;
+}
+
+void Logger::publish(Record* record) {
+    const bool urgent = record->level >= options.flushLevel;
+    ring->publish(record);
+    // The writer polls on flushInterval; wake it early for urgent records or a filling queue
+    if (urgent || ring->backlog() > ring->mask / 2) wake.notify_one();
+}
+
+void Logger::writerLoop() {
+    std::string batch;
+    batch.reserve(64 * 1024);
+    char stamp[32] = {};
+    int64_t stampSecond = -1;
+    auto lastFlush = std::chrono::steady_clock::now();
+
+    for (;;) {
+        uint64_t ticket;
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            ticket = flushRequested;
+            stopping = stopRequested;
+        }
+
+        // Drain everything published so far into one batch
+        bool urgent = false;
+        uint64_t count = 0;
+        while (Record* r = ring->front()) {
+            const int64_t second = r->timeNs / 1000000000;
+            if (second != stampSecond) { // the date part only changes once a second
+                const time_t t = (time_t)second;
+                std::tm tm{};
+                localtime_r(&t, &tm);
+                std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+                stampSecond = second;
+            }
+            const int ms = (int)(r->timeNs / 1000000 % 1000);
+            const char millis[5] = {'.', (char)('0' + ms / 100), (char)('0' + ms / 10 % 10), (char)('0' + ms % 10), ' '};
+            batch += stamp;
+            batch.append(millis, sizeof(millis));
+            batch += '[';
+            batch += r->tag != nullptr ? r->tag : kLevelTags[(int)r->level];
+            batch += "] ";
+            batch.append(r->text, r->length);
+            batch += '\n';
+            urgent |= r->level >= options.flushLevel;
+            ring->pop();
+            ++count;
+        }
+
+        if (!batch.empty()) {
+            logFile.write(batch.data(), (std::streamsize)batch.size());
+            if (consoleOutput) std::cout.write(batch.data(), (std::streamsize)batch.size());
+            batch.clear();
+            written.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const bool flushDue = urgent || now - lastFlush >= options.flushInterval;
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (flushDue || ticket != flushCompleted || stopping) {
+            logFile.flush();
+            if (consoleOutput) std::cout.flush();
+            lastFlush = now;
+            flushCompleted = ticket;
+            drained.notify_all();
+        }
+        if (stopping) return;
+        if (ring->front() == nullptr) {
+            wake.wait_for(lock, options.flushInterval, [&] {
+                return ring->front() != nullptr || flushRequested != flushCompleted || stopRequested;
+            });
+        }
     }
 }
 
@@ -240,14 +416,3 @@ std::string Logger::logLevelToString(LogLevel level) {
         default: return "UNKNOWN";
     }
 }
-
-std::string Logger::formatShape(const std::vector<int>& shape) {
-    std::ostringstream oss;
-    oss << "[";
-    for (size_t i = 0; i < shape.size(); ++i) {
-        if (i > 0) oss << ", ";
-        oss << shape[i];
-    }
-    oss << "]";
-    return oss.str();
-}
\ No newline at end of file
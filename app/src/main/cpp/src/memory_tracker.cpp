@@ -0,0 +1,189 @@
+#include "memory_tracker.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+#include <cstdio>
+
+namespace {
+
+thread_local MemoryTag threadTag = MemoryTag::Activation;
+
+void storeMax(std::atomic<int64_t>& target, int64_t value) {
+    int64_t seen = target.load(std::memory_order_relaxed);
+    while (value > seen && !target.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+std::string formatBytes(int64_t bytes) {
+    char buf[32];
+    if (bytes >= (1 << 20) || bytes <= -(1 << 20)) std::snprintf(buf, sizeof(buf), "%.1fMB", bytes / 1048576.0);
+    else std::snprintf(buf, sizeof(buf), "%.1fKB", bytes / 1024.0);
+    return buf;
+}
+
+std::string usageLine(const char* name, const MemoryUsage& u) {
+    return std::string(name) + " live=" + formatBytes(u.liveBytes) + " peak=" + formatBytes(u.peakBytes) +
+           " allocs=" + std::to_string(u.liveAllocations) + "/" + std::to_string(u.allocations);
+}
+
+} // namespace
+
+const char* deviceName(Device device) {
+    return device == Device::GPU ? "GPU" : "CPU";
+}
+
+const char* memoryTagName(MemoryTag tag) {
+    static const char* const kNames[kMemoryTagCount] = {"activation", "weights", "preproc", "gradient", "scratch"};
+    return kNames[(int)tag];
+}
+
+std::string MemorySnapshot::toText() const {
+    std::string out = usageLine("memory", total) + "\n";
+    for (int d = 0; d < kDeviceCount; ++d) {
+        if (device[d].allocations == 0) continue;
+        out += usageLine((std::string("memory.") + deviceName((Device)d)).c_str(), device[d]) + "\n";
+    }
+    for (int t = 0; t < kMemoryTagCount; ++t) {
+        if (tag[t].allocations == 0) continue;
+        out += usageLine((std::string("memory.") + memoryTagName((MemoryTag)t)).c_str(), tag[t]) + "\n";
+    }
+    return out;
+}
+
+void MemoryTracker::Cell::add(int64_t bytes) {
+    // seq_cst for MemoryProbe's publish-then-read handshake with recordAlloc
+    const int64_t live = liveBytes.fetch_add(bytes) + bytes;
+    storeMax(peakBytes, live);
+    liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::Cell::remove(int64_t bytes) {
+    liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+MemoryUsage MemoryTracker::Cell::load() const {
+    MemoryUsage u;
+    u.liveBytes = liveBytes.load(std::memory_order_relaxed);
+    u.peakBytes = peakBytes.load(std::memory_order_relaxed);
+    u.liveAllocations = liveAllocations.load(std::memory_order_relaxed);
+    u.allocations = allocations.load(std::memory_order_relaxed);
+    return u;
+}
+
+MemoryTracker& MemoryTracker::getInstance() {
+    // Never destroyed: tensors are freed from static and thread_local destructors
+    static MemoryTracker* instance = new MemoryTracker();
+    return *instance;
+}
+
+void MemoryTracker::recordAlloc(Device device, MemoryTag tag, size_t bytes) {
+    const int64_t n = (int64_t)bytes;
+    total.add(n);
+    devices[(int)device].add(n);
+    tags[(int)tag].add(n);
+    // seq_cst like the add above and MemoryProbe's publish: either a starting probe reads these
+    // bytes or this reads its bit
+    uint32_t probes = activeProbes.load();
+    if (probes != 0) {
+        const int64_t live = total.liveBytes.load(std::memory_order_relaxed);
+        for (; probes != 0; probes &= probes - 1) storeMax(probePeaks[__builtin_ctz(probes)], live);
+    }
+    LOG_MEMORY_ALLOC(deviceName(device), bytes, memoryTagName(tag));
+}
+
+void MemoryTracker::recordFree(Device device, MemoryTag tag, size_t bytes) {
+    const int64_t n = (int64_t)bytes;
+    total.remove(n);
+    devices[(int)device].remove(n);
+    tags[(int)tag].remove(n);
+    LOG_MEMORY_DEALLOC(deviceName(device), bytes, memoryTagName(tag));
+}
+
+MemorySnapshot MemoryTracker::snapshot() const {
+    MemorySnapshot s;
+    s.total = total.load();
+    for (int d = 0; d < kDeviceCount; ++d) s.device[d] = devices[d].load();
+    for (int t = 0; t < kMemoryTagCount; ++t) s.tag[t] = tags[t].load();
+    return s;
+}
+
+void MemoryTracker::resetPeaks() {
+    auto reset = [](Cell& cell) { cell.peakBytes.store(cell.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed); };
+    reset(total);
+    for (Cell& cell : devices) reset(cell);
+    for (Cell& cell : tags) reset(cell);
+}
+
+int64_t MemoryTracker::reportLeaks() const {
+    const MemorySnapshot s = snapshot();
+    if (s.total.liveAllocations == 0) {
+        LOG_INFO("No tracked memory live at shutdown (peak " + formatBytes(s.total.peakBytes) + ")");
+        return 0;
+    }
+    LOG_WARNING("Tracked memory still live at shutdown: " + usageLine("total", s.total));
+    for (int d = 0; d < kDeviceCount; ++d) {
+        if (s.device[d].liveAllocations != 0) LOG_WARNING("  " + usageLine(deviceName((Device)d), s.device[d]));
+    }
+    for (int t = 0; t < kMemoryTagCount; ++t) {
+        if (s.tag[t].liveAllocations != 0) LOG_WARNING("  " + usageLine(memoryTagName((MemoryTag)t), s.tag[t]));
+    }
+    return s.total.liveBytes;
+}
+
+MemoryTag currentMemoryTag() {
+    return threadTag;
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag) : previous(threadTag) {
+    threadTag = tag;
+}
+
+MemoryTagScope::~MemoryTagScope() {
+    threadTag = previous;
+}
+
+MemoryProbe::MemoryProbe(const char* name, int64_t budgetBytes) : name(name), budget(budgetBytes), slot(-1) {
+    MemoryTracker& tracker = MemoryTracker::getInstance();
+    startBytes = tracker.total.liveBytes.load(std::memory_order_relaxed);
+    uint32_t claimed = tracker.claimedProbes.load(std::memory_order_relaxed);
+    while (~claimed != 0) {
+        const int free = __builtin_ctz(~claimed);
+        if (tracker.claimedProbes.compare_exchange_weak(claimed, claimed | (1u << free), std::memory_order_relaxed)) {
+            slot = free;
+            break;
+        }
+    }
+    if (slot < 0) return;
+    // Seed the window before recordAlloc can see it, so a concurrent allocation's peak is never
+    // overwritten by the seed; then catch up with anything allocated while it was being published.
+    tracker.probePeaks[slot].store(startBytes, std::memory_order_relaxed);
+    tracker.activeProbes.fetch_or(1u << slot);
+    storeMax(tracker.probePeaks[slot], tracker.total.liveBytes.load());
+}
+
+MemoryProbe::~MemoryProbe() {
+    const int64_t peak = peakBytes();
+    if (slot >= 0) {
+        MemoryTracker& tracker = MemoryTracker::getInstance();
+        tracker.activeProbes.fetch_and(~(1u << slot), std::memory_order_relaxed);
+        tracker.claimedProbes.fetch_and(~(1u << slot), std::memory_order_release);
+    }
+    if (name != nullptr) {
+        Metrics::getInstance().gauge(std::string("memory.") + name + ".peak").set(peak);
+    }
+    if (budget > 0 && peak > budget) {
+        LOG_WARNING(std::string("Memory budget exceeded") + (name != nullptr ? std::string(" in ") + name : "") +
+                    ": peak " + formatBytes(peak) + " > " + formatBytes(budget));
+    }
+}
+
+int64_t MemoryProbe::peakBytes() const {
+    const MemoryTracker& tracker = MemoryTracker::getInstance();
+    if (slot < 0) return tracker.total.peakBytes.load(std::memory_order_relaxed);
+    return tracker.probePeaks[slot].load(std::memory_order_relaxed);
+}
+
+int64_t MemoryProbe::peakGrowth() const {
+    return peakBytes() - startBytes;
+}
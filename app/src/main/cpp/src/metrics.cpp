@@ -0,0 +1,149 @@
+#include "metrics.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+int Histogram::bucketOf(int64_t ns) {
+    if (ns < kSubBuckets) return ns < 0 ? 0 : (int)ns;
+    const int top = 63 - __builtin_clzll((unsigned long long)ns);
+    if (top >= kMaxBits) return kBuckets - 1;
+    const int shift = top - kSubBits;
+    return (shift + 1) * kSubBuckets + (int)((ns >> shift) - kSubBuckets);
+}
+
+int64_t Histogram::bucketUpper(int bucket) {
+    if (bucket < kSubBuckets) return bucket;
+    const int shift = bucket / kSubBuckets - 1;
+    const int64_t low = (int64_t)(kSubBuckets + bucket % kSubBuckets) << shift;
+    return low + ((int64_t)1 << shift) - 1;
+}
+
+void Histogram::record(int64_t ns) {
+    counts[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(ns, std::memory_order_relaxed);
+    int64_t seen = maximum.load(std::memory_order_relaxed);
+    while (ns > seen && !maximum.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+}
+
+LatencySummary Histogram::summarize(bool reset) {
+    std::vector<uint64_t> snapshot(kBuckets);
+    uint64_t total = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        snapshot[i] = reset ? counts[i].exchange(0, std::memory_order_relaxed) : counts[i].load(std::memory_order_relaxed);
+        total += snapshot[i];
+    }
+    const int64_t sumNs = reset ? sum.exchange(0, std::memory_order_relaxed) : sum.load(std::memory_order_relaxed);
+    const int64_t maxNs = reset ? maximum.exchange(0, std::memory_order_relaxed) : maximum.load(std::memory_order_relaxed);
+
+    LatencySummary s;
+    s.count = total;
+    if (total == 0) return s;
+    s.mean = (double)sumNs / (double)total;
+    s.max = maxNs;
+
+    // Smallest bucket bound with at least p of the records at or below it
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    int64_t* outputs[] = {&s.p50, &s.p90, &s.p99, &s.p999};
+    uint64_t seen = 0;
+    int q = 0, bucket = 0;
+    for (; q < 4; ++q) {
+        const uint64_t rank = std::max<uint64_t>(1, (uint64_t)(quantiles[q] * (double)total + 0.999999));
+        while (bucket < kBuckets && seen + snapshot[bucket] < rank) seen += snapshot[bucket++];
+        *outputs[q] = std::min(bucketUpper(std::min(bucket, kBuckets - 1)), maxNs);
+    }
+    return s;
+}
+
+Metrics& Metrics::getInstance() {
+    // Never destroyed: gauges may be updated from static and thread_local destructors
+    static Metrics* instance = new Metrics();
+    return *instance;
+}
+
+Histogram& Metrics::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = histograms[name];
+    if (!slot) slot = std::make_unique<Histogram>();
+    return *slot;
+}
+
+Counter& Metrics::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = counters[name];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+Gauge& Metrics::gauge(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = gauges[name];
+    if (!slot) slot = std::make_unique<Gauge>();
+    return *slot;
+}
+
+std::vector<LatencySummary> Metrics::latencies(bool reset) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<LatencySummary> out;
+    out.reserve(histograms.size());
+    for (auto& entry : histograms) {
+        out.push_back(entry.second->summarize(reset));
+        out.back().name = entry.first;
+    }
+    return out;
+}
+
+std::string Metrics::toJson(bool reset) {
+    const std::vector<LatencySummary> summaries = latencies(reset);
+    std::ostringstream oss;
+    oss << "{\"latency\":{";
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        const LatencySummary& s = summaries[i];
+        oss << (i > 0 ? "," : "") << "\"" << s.name << "\":{\"count\":" << s.count << ",\"mean\":" << (int64_t)s.mean
+            << ",\"p50\":" << s.p50 << ",\"p90\":" << s.p90 << ",\"p99\":" << s.p99 << ",\"p999\":" << s.p999
+            << ",\"max\":" << s.max << "}";
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    oss << "},\"counters\":{";
+    const char* separator = "";
+    for (auto& entry : counters) {
+        oss << separator << "\"" << entry.first << "\":" << entry.second->get();
+        separator = ",";
+    }
+    oss << "},\"gauges\":{";
+    separator = "";
+    for (auto& entry : gauges) {
+        oss << separator << "\"" << entry.first << "\":" << entry.second->get();
+        separator = ",";
+    }
+    oss << "}}";
+    return oss.str();
+}
+
+std::string Metrics::toText(bool reset) {
+    const std::vector<LatencySummary> summaries = latencies(reset);
+    std::string out;
+    char line[256];
+    for (const LatencySummary& s : summaries) {
+        if (s.count == 0) continue;
+        std::snprintf(line, sizeof(line), "%s n=%llu p50=%.2f p90=%.2f p99=%.2f p99.9=%.2f max=%.2f ms\n",
+                      s.name.c_str(), (unsigned long long)s.count, s.p50 * 1e-6, s.p90 * 1e-6, s.p99 * 1e-6,
+                      s.p999 * 1e-6, s.max * 1e-6);
+        out += line;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : counters) out += entry.first + "=" + std::to_string(entry.second->get()) + "\n";
+    for (auto& entry : gauges) out += entry.first + "=" + std::to_string(entry.second->get()) + "\n";
+    return out;
+}
+
+void Metrics::logSnapshot(bool reset) {
+    std::istringstream lines(toText(reset));
+    std::string line;
+    while (std::getline(lines, line)) {
+        LOG_INFO("METRIC " + line);
+    }
+}
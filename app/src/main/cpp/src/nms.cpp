@@ -0,0 +1,247 @@
+#include "nms.hpp"
+#include "simd.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+// Candidates gathered into descending-score order (optionally grouped by class first) so
+// every pass below streams linearly.
+struct SortedBoxes {
+    std::vector<int> order; // sorted rank -> original index
+    std::vector<float> x1, y1, x2, y2, area, cls;
+    std::vector<float> suppressed; // 0 / 1, float so SIMD can blend it
+
+    void build(const DetectionCandidates& boxes, bool groupByClass) {
+        const size_t n = boxes.size();
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0);
+        if (groupByClass) {
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                if (boxes.classId[a] != boxes.classId[b]) return boxes.classId[a] < boxes.classId[b];
+                return boxes.score[a] > boxes.score[b];
+            });
+        } else {
+            std::stable_sort(order.begin(), order.end(),
+                             [&](int a, int b) { return boxes.score[a] > boxes.score[b]; });
+        }
+
+        x1.resize(n);
+        y1.resize(n);
+        x2.resize(n);
+        y2.resize(n);
+        area.resize(n);
+        cls.resize(n);
+        suppressed.assign(n, 0.0f);
+        for (size_t r = 0; r < n; ++r) {
+            int i = order[r];
+            x1[r] = boxes.x1[i];
+            y1[r] = boxes.y1[i];
+            x2[r] = boxes.x2[i];
+            y2[r] = boxes.y2[i];
+            area[r] = (x2[r] - x1[r]) * (y2[r] - y1[r]);
+            cls[r] = (float)boxes.classId[i];
+        }
+    }
+
+    float iou(size_t a, size_t b) const {
+        float iw = std::max(0.0f, std::min(x2[a], x2[b]) - std::max(x1[a], x1[b]));
+        float ih = std::max(0.0f, std::min(y2[a], y2[b]) - std::max(y1[a], y1[b]));
+        float inter = iw * ih;
+        float uni = area[a] + area[b] - inter;
+        return uni <= 0.0f ? 0.0f : inter / uni;
+    }
+};
+
+// All-pairs greedy NMS over ranks [begin, n), one SIMD sweep of the remaining boxes per kept box.
+// Every box in the range is treated as the same class.
+void greedyAllPairs(SortedBoxes& sb, int begin, int n, const NmsConfig& config, std::vector<int>& keep) {
+    const simd::VecF zero = simd::set1(0.0f);
+    const simd::VecF one = simd::set1(1.0f);
+    const simd::VecF thr = simd::set1(config.iouThreshold);
+
+    int kept = 0;
+    for (int i = begin; i < n; ++i) {
+        if (sb.suppressed[i] != 0.0f) continue;
+        keep.push_back(sb.order[i]);
+        if (++kept >= config.maxDetections) break;
+
+        const simd::VecF bx1 = simd::set1(sb.x1[i]), by1 = simd::set1(sb.y1[i]);
+        const simd::VecF bx2 = simd::set1(sb.x2[i]), by2 = simd::set1(sb.y2[i]);
+        const simd::VecF barea = simd::set1(sb.area[i]);
+
+        int j = i + 1;
+        for (; j + simd::kWidth <= n; j += simd::kWidth) {
+            simd::VecF iw = simd::max(zero, simd::sub(simd::min(bx2, simd::load(&sb.x2[j])),
+                                                      simd::max(bx1, simd::load(&sb.x1[j]))));
+            simd::VecF ih = simd::max(zero, simd::sub(simd::min(by2, simd::load(&sb.y2[j])),
+                                                      simd::max(by1, simd::load(&sb.y1[j]))));
+            simd::VecF inter = simd::mul(iw, ih);
+            simd::VecF uni = simd::sub(simd::add(barea, simd::load(&sb.area[j])), inter);
+            // IoU >= thr  <=>  inter >= thr * union, for union > 0
+            simd::MaskF hit = simd::maskAnd(simd::cmpGe(inter, simd::mul(thr, uni)), simd::cmpGt(uni, zero));
+            simd::store(&sb.suppressed[j], simd::select(hit, one, simd::load(&sb.suppressed[j])));
+        }
+        for (; j < n; ++j) {
+            if (sb.iou(i, j) >= config.iouThreshold) sb.suppressed[j] = 1.0f;
+        }
+    }
+}
+
+// Greedy NMS over a uniform grid: every box is binned into each cell it touches, so a kept box
+// only tests the boxes sharing one of its cells. Any pair with IoU > 0 overlaps and therefore
+// shares a cell, which makes the result identical to the all-pairs scan for iouThreshold > 0.
+void greedyGrid(SortedBoxes& sb, int begin, int n, const NmsConfig& config, std::vector<int>& keep) {
+    constexpr int kMaxCellsPerAxis = 128;
+
+    float minX = sb.x1[begin], minY = sb.y1[begin], maxX = sb.x2[begin], maxY = sb.y2[begin];
+    double sideSum = 0.0;
+    for (int r = begin; r < n; ++r) {
+        minX = std::min(minX, sb.x1[r]);
+        minY = std::min(minY, sb.y1[r]);
+        maxX = std::max(maxX, sb.x2[r]);
+        maxY = std::max(maxY, sb.y2[r]);
+        sideSum += 0.5 * ((sb.x2[r] - sb.x1[r]) + (sb.y2[r] - sb.y1[r]));
+    }
+    float cell = std::max(1.0f, (float)(sideSum / (n - begin)));
+    cell = std::max(cell, std::max(maxX - minX, maxY - minY) / kMaxCellsPerAxis);
+    const float invCell = 1.0f / cell;
+    const int gw = std::min(kMaxCellsPerAxis, (int)((maxX - minX) * invCell) + 1);
+    const int gh = std::min(kMaxCellsPerAxis, (int)((maxY - minY) * invCell) + 1);
+
+    auto cellRange = [&](int r, int& cx0, int& cy0, int& cx1, int& cy1) {
+        cx0 = std::min(gw - 1, std::max(0, (int)((sb.x1[r] - minX) * invCell)));
+        cy0 = std::min(gh - 1, std::max(0, (int)((sb.y1[r] - minY) * invCell)));
+        cx1 = std::min(gw - 1, std::max(cx0, (int)((sb.x2[r] - minX) * invCell)));
+        cy1 = std::min(gh - 1, std::max(cy0, (int)((sb.y2[r] - minY) * invCell)));
+    };
+
+    // CSR bins; items within a cell stay in rank order because ranks are inserted ascending
+    static thread_local std::vector<int> cellStart, cellCursor, cellItems, stamp;
+    cellStart.assign((size_t)gw * gh + 1, 0);
+    int cx0, cy0, cx1, cy1;
+    for (int r = begin; r < n; ++r) {
+        cellRange(r, cx0, cy0, cx1, cy1);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx) ++cellStart[(size_t)cy * gw + cx + 1];
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) cellStart[c] += cellStart[c - 1];
+    cellItems.resize(cellStart.back());
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (int r = begin; r < n; ++r) {
+        cellRange(r, cx0, cy0, cx1, cy1);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx) cellItems[cellCursor[(size_t)cy * gw + cx]++] = r;
+    }
+
+    stamp.assign(n, -1);
+    int kept = 0;
+    for (int i = begin; i < n; ++i) {
+        if (sb.suppressed[i] != 0.0f) continue;
+        keep.push_back(sb.order[i]);
+        if (++kept >= config.maxDetections) break;
+
+        cellRange(i, cx0, cy0, cx1, cy1);
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const size_t c = (size_t)cy * gw + cx;
+                // Skip the lower-ranked prefix: those boxes were already decided
+                const int* begin = cellItems.data() + cellStart[c];
+                const int* end = cellItems.data() + cellStart[c + 1];
+                for (const int* it = std::upper_bound(begin, end, i); it != end; ++it) {
+                    const int j = *it;
+                    if (stamp[j] == i || sb.suppressed[j] != 0.0f) continue;
+                    stamp[j] = i;
+                    if (sb.iou(i, j) >= config.iouThreshold) sb.suppressed[j] = 1.0f;
+                }
+            }
+        }
+    }
+}
+
+// Soft-NMS: repeatedly take the best remaining box and decay the scores of its neighbours.
+void softNms(SortedBoxes& sb, DetectionCandidates& boxes, const NmsConfig& config, std::vector<int>& keep) {
+    const int n = (int)sb.order.size();
+    std::vector<float> scores(n);
+    std::vector<int> live(n);
+    for (int r = 0; r < n; ++r) {
+        scores[r] = boxes.score[sb.order[r]];
+        live[r] = r;
+    }
+
+    while (!live.empty() && (int)keep.size() < config.maxDetections) {
+        size_t best = 0;
+        for (size_t k = 1; k < live.size(); ++k) {
+            if (scores[live[k]] > scores[live[best]]) best = k;
+        }
+        const int m = live[best];
+        live[best] = live.back();
+        live.pop_back();
+        keep.push_back(sb.order[m]);
+        boxes.score[sb.order[m]] = scores[m];
+
+        for (size_t k = 0; k < live.size();) {
+            const int r = live[k];
+            if (!config.classAware || sb.cls[r] == sb.cls[m]) {
+                float iou = sb.iou(m, r);
+                if (config.method == NmsMethod::SoftLinear) {
+                    if (iou >= config.iouThreshold) scores[r] *= 1.0f - iou;
+                } else {
+                    scores[r] *= std::exp(-(iou * iou) / config.softSigma);
+                }
+            }
+            if (scores[r] < config.scoreThreshold) {
+                boxes.score[sb.order[r]] = scores[r];
+                live[k] = live.back();
+                live.pop_back();
+            } else {
+                ++k;
+            }
+        }
+    }
+}
+
+} // namespace
+
+size_t nonMaxSuppression(DetectionCandidates& boxes, const NmsConfig& config, std::vector<int>& keep) {
+    TSR_TRACE_SCOPE("nms");
+    TSR_LATENCY_SCOPE("nms");
+    keep.clear();
+    if (boxes.size() == 0 || config.maxDetections <= 0) return 0;
+
+    static thread_local SortedBoxes sb;
+
+    if (config.method != NmsMethod::Hard) {
+        sb.build(boxes, false);
+        softNms(sb, boxes, config, keep);
+        return keep.size();
+    }
+
+    // Batched hard NMS: with boxes grouped by class each class is an independent segment,
+    // which both skips the class test and shrinks the pair count to sum(n_c^2).
+    sb.build(boxes, config.classAware);
+    const int n = (int)boxes.size();
+    for (int begin = 0; begin < n;) {
+        int end = n;
+        if (config.classAware) {
+            end = begin + 1;
+            while (end < n && sb.cls[end] == sb.cls[begin]) ++end;
+        }
+        if (config.gridMinCandidates >= 0 && config.iouThreshold > 0.0f &&
+            end - begin >= config.gridMinCandidates) {
+            greedyGrid(sb, begin, end, config, keep);
+        } else {
+            greedyAllPairs(sb, begin, end, config, keep);
+        }
+        begin = end;
+    }
+
+    if (config.classAware) {
+        std::stable_sort(keep.begin(), keep.end(), [&](int a, int b) { return boxes.score[a] > boxes.score[b]; });
+        if ((int)keep.size() > config.maxDetections) keep.resize(config.maxDetections);
+    }
+    return keep.size();
+}
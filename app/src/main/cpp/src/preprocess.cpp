@@ -0,0 +1,235 @@
+#include "preprocess.hpp"
+#include "simd.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+LetterboxInfo computeLetterbox(int srcW, int srcH, int dstW, int dstH) {
+    LetterboxInfo info;
+    info.dstW = dstW;
+    info.dstH = dstH;
+    info.scale = std::min((float)dstW / (float)srcW, (float)dstH / (float)srcH);
+    info.newW = std::max(1, std::min(dstW, (int)(srcW * info.scale)));
+    info.newH = std::max(1, std::min(dstH, (int)(srcH * info.scale)));
+    info.padX = (dstW - info.newW) / 2;
+    info.padY = (dstH - info.newH) / 2;
+    return info;
+}
+
+namespace {
+
+// Per-thread scratch so steady-state frames never hit the allocator.
+struct ResizeScratch {
+    std::vector<int> xOfs0;
+    std::vector<int> xOfs1;
+    std::vector<float> xWeight;
+    std::vector<float> rows; // 2 cached source rows x 3 planes x newW, already scaled by 1/255
+    std::vector<float> blended; // 3 planes x newW of the current output row, for interleaved layouts
+    int cachedY[2] = {-1, -1};
+};
+
+// Half-pixel-centre bilinear source coordinate, matching Bitmap.createScaledBitmap(filter = true).
+inline void sourceCoord(int d, int srcLen, int dstLen, int& i0, int& i1, float& w) {
+    float s = ((float)d + 0.5f) * (float)srcLen / (float)dstLen - 0.5f;
+    if (s < 0.0f) s = 0.0f;
+    i0 = (int)s;
+    if (i0 > srcLen - 1) i0 = srcLen - 1;
+    i1 = std::min(i0 + 1, srcLen - 1);
+    w = s - (float)i0;
+}
+
+// Horizontal pass for one source row into three planar float rows of length newW. Stays scalar:
+// the taps sit at arbitrary source columns (a byte gather NEON lacks), and gathering them into
+// planar rows first so the lerp can run on vectors measured ~15% slower on AVX2 than this loop.
+void resampleRow(const uint8_t* row, const ResizeScratch& sc, int newW, int rIdx, int gIdx, int bIdx,
+                 float* outR, float* outG, float* outB) {
+    const float inv255 = 1.0f / 255.0f;
+    for (int x = 0; x < newW; ++x) {
+        const uint8_t* p0 = row + sc.xOfs0[x];
+        const uint8_t* p1 = row + sc.xOfs1[x];
+        float w = sc.xWeight[x];
+        outR[x] = ((float)p0[rIdx] + w * (float)(p1[rIdx] - p0[rIdx])) * inv255;
+        outG[x] = ((float)p0[gIdx] + w * (float)(p1[gIdx] - p0[gIdx])) * inv255;
+        outB[x] = ((float)p0[bIdx] + w * (float)(p1[bIdx] - p0[bIdx])) * inv255;
+    }
+}
+
+// out = a + wy * (b - a), vectorized over one plane row.
+inline void blendRows(const float* a, const float* b, float wy, float* out, int n) {
+    simd::VecF vw = simd::set1(wy);
+    int i = 0;
+    for (; i + simd::kWidth <= n; i += simd::kWidth) {
+        simd::VecF va = simd::load(a + i);
+        simd::VecF vb = simd::load(b + i);
+        simd::store(out + i, simd::mulAdd(vw, simd::sub(vb, va), va));
+    }
+    for (; i < n; ++i) out[i] = a[i] + wy * (b[i] - a[i]);
+}
+
+// `count` interleaved pixels of `lanes` floats: letterbox grey in R, G, B, zero in padding lanes
+inline void fillPixels(float* dst, int count, int lanes) {
+    for (int i = 0; i < count; ++i, dst += lanes) {
+        dst[0] = dst[1] = dst[2] = kLetterboxPadValue;
+        for (int l = 3; l < lanes; ++l) dst[l] = 0.0f;
+    }
+}
+
+} // namespace
+
+void letterboxNormalize(const uint8_t* src, int srcW, int srcH, int srcRowStride, PixelFormat fmt,
+                        float* dst, const LetterboxInfo& info, MemoryFormat layout) {
+    TSR_TRACE_SCOPE("preprocess");
+    TSR_LATENCY_SCOPE("preprocess");
+    static thread_local ResizeScratch sc;
+
+    const int dstW = info.dstW, dstH = info.dstH;
+    const int newW = info.newW, newH = info.newH;
+    const int padX = info.padX, padY = info.padY;
+    const int plane = dstW * dstH;
+    float* planes[3] = {dst, dst + plane, dst + 2 * plane};
+    const int lanes = layout == MemoryFormat::NHWC ? 3 : channelBlock(layout); // floats per pixel, 1 = planar
+    assert(lanes == 1 || lanes >= 3);
+
+    const int rIdx = (fmt == PixelFormat::RGBA8888) ? 0 : 2;
+    const int gIdx = 1;
+    const int bIdx = (fmt == PixelFormat::RGBA8888) ? 2 : 0;
+
+    sc.xOfs0.resize(newW);
+    sc.xOfs1.resize(newW);
+    sc.xWeight.resize(newW);
+    for (int x = 0; x < newW; ++x) {
+        int x0, x1;
+        float w;
+        sourceCoord(x, srcW, newW, x0, x1, w);
+        sc.xOfs0[x] = x0 * 4;
+        sc.xOfs1[x] = x1 * 4;
+        sc.xWeight[x] = w;
+    }
+    sc.rows.resize((size_t)6 * newW);
+    if (lanes > 1) sc.blended.resize((size_t)3 * newW);
+    sc.cachedY[0] = sc.cachedY[1] = -1;
+
+    // Returns the slot holding source row y, resampling it into the slot not needed by `keep`.
+    auto cachedRow = [&](int y, int keep) -> int {
+        for (int s = 0; s < 2; ++s) {
+            if (sc.cachedY[s] == y) return s;
+        }
+        int slot = (sc.cachedY[0] == keep) ? 1 : 0;
+        float* base = sc.rows.data() + (size_t)slot * 3 * newW;
+        resampleRow(src + (size_t)y * srcRowStride, sc, newW, rIdx, gIdx, bIdx,
+                    base, base + newW, base + 2 * newW);
+        sc.cachedY[slot] = y;
+        return slot;
+    };
+
+    const int rightPad = dstW - padX - newW;
+    for (int y = 0; y < dstH; ++y) {
+        const size_t rowOff = (size_t)y * dstW;
+        if (y < padY || y >= padY + newH) {
+            if (lanes > 1) {
+                fillPixels(dst + rowOff * lanes, dstW, lanes);
+            } else {
+                for (float* p : planes) simd::fill(p + rowOff, dstW, kLetterboxPadValue);
+            }
+            continue;
+        }
+
+        int y0, y1;
+        float wy;
+        sourceCoord(y - padY, srcH, newH, y0, y1, wy);
+        int s0 = cachedRow(y0, -1);
+        int s1 = cachedRow(y1, y0);
+
+        if (lanes > 1) { // blend the planar rows, then interleave them into the output row
+            for (int c = 0; c < 3; ++c) {
+                blendRows(sc.rows.data() + ((size_t)s0 * 3 + c) * newW, sc.rows.data() + ((size_t)s1 * 3 + c) * newW, wy,
+                          sc.blended.data() + (size_t)c * newW, newW);
+            }
+            float* out = dst + rowOff * lanes;
+            const float* r = sc.blended.data();
+            const float* g = r + newW;
+            const float* b = g + newW;
+            fillPixels(out, padX, lanes);
+            for (int x = 0; x < newW; ++x) {
+                float* px = out + (size_t)(padX + x) * lanes;
+                px[0] = r[x];
+                px[1] = g[x];
+                px[2] = b[x];
+                for (int l = 3; l < lanes; ++l) px[l] = 0.0f;
+            }
+            fillPixels(out + (size_t)(padX + newW) * lanes, rightPad, lanes);
+            continue;
+        }
+
+        for (int c = 0; c < 3; ++c) {
+            float* out = planes[c] + rowOff;
+            const float* a = sc.rows.data() + ((size_t)s0 * 3 + c) * newW;
+            const float* b = sc.rows.data() + ((size_t)s1 * 3 + c) * newW;
+            simd::fill(out, padX, kLetterboxPadValue);
+            blendRows(a, b, wy, out + padX, newW);
+            simd::fill(out + padX + newW, rightPad, kLetterboxPadValue);
+        }
+    }
+}
+
+LetterboxInfo letterboxNormalize(const uint8_t* src, int srcW, int srcH, int srcRowStride, PixelFormat fmt,
+                                 Tensor& dst) {
+    const std::vector<int> shape = dst.getLogicalShape();
+    assert(shape[0] == 1 && shape[1] == 3);
+    assert(dst.isContiguous() && dst.getDevice() == Device::CPU);
+
+    LetterboxInfo info = computeLetterbox(srcW, srcH, shape[3], shape[2]);
+    letterboxNormalize(src, srcW, srcH, srcRowStride, fmt, dst.data(), info, dst.getMemoryFormat());
+    return info;
+}
+
+namespace {
+
+inline uint8_t clampToByte(int v) {
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+} // namespace
+
+void yuv420ToRgba(const Yuv420Frame& frame, int rotationDegrees, uint8_t* dst, int dstRowStride) {
+    TSR_TRACE_SCOPE("yuv420ToRgba");
+    TSR_LATENCY_SCOPE("yuv420ToRgba");
+    const int w = frame.width, h = frame.height;
+    const int rot = ((rotationDegrees % 360) + 360) % 360;
+
+    // Destination pixel step when the source x advances, and the row origin per source y
+    int stepX, stepY, origin;
+    switch (rot) {
+        case 90:  origin = (h - 1) * 4;                          stepX = dstRowStride;  stepY = -4;            break;
+        case 180: origin = (h - 1) * dstRowStride + (w - 1) * 4; stepX = -4;            stepY = -dstRowStride; break;
+        case 270: origin = (w - 1) * dstRowStride;               stepX = -dstRowStride; stepY = 4;             break;
+        default:  origin = 0;                                    stepX = 4;             stepY = dstRowStride;  break;
+    }
+
+    // 16.16 fixed-point JFIF coefficients
+    constexpr int kRV = 91881;  // 1.402
+    constexpr int kGU = 22554;  // 0.344136
+    constexpr int kGV = 46802;  // 0.714136
+    constexpr int kBU = 116130; // 1.772
+
+    for (int y = 0; y < h; ++y) {
+        const uint8_t* yRow = frame.y + (size_t)y * frame.yRowStride;
+        const uint8_t* uRow = frame.u + (size_t)(y >> 1) * frame.uvRowStride;
+        const uint8_t* vRow = frame.v + (size_t)(y >> 1) * frame.uvRowStride;
+        uint8_t* out = dst + origin + (ptrdiff_t)y * stepY;
+
+        for (int x = 0; x < w; ++x, out += stepX) {
+            const int uvOff = (x >> 1) * frame.uvPixelStride;
+            const int yy = (int)yRow[x] << 16;
+            const int u = (int)uRow[uvOff] - 128;
+            const int v = (int)vRow[uvOff] - 128;
+            out[0] = clampToByte((yy + kRV * v + 32768) >> 16);
+            out[1] = clampToByte((yy - kGU * u - kGV * v + 32768) >> 16);
+            out[2] = clampToByte((yy + kBU * u + 32768) >> 16);
+            out[3] = 255;
+        }
+    }
+}
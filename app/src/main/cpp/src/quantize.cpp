@@ -0,0 +1,159 @@
+#include "quantize.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// Converts n elements through a float vector: load(src + i) -> op -> store(dst + i). The tail
+// goes through padded buffers so every element takes the same instructions.
+template <typename Src, typename Dst, typename Load, typename Store, typename Op>
+inline void convertVec(const Src* src, Dst* dst, int n, Load load, Store store, Op op) {
+    int i = 0;
+    for (; i + simd::kWidth <= n; i += simd::kWidth) store(dst + i, op(load(src + i)));
+    if (i < n) {
+        Src padSrc[simd::kWidth] = {};
+        Dst padDst[simd::kWidth];
+        std::copy(src + i, src + n, padSrc);
+        store(padDst, op(load(padSrc)));
+        std::copy(padDst, padDst + (n - i), dst + i);
+    }
+}
+
+const auto loadF32 = [](const float* p) { return simd::load(p); };
+const auto storeF32 = [](float* p, simd::VecF v) { simd::store(p, v); };
+const auto loadI8 = [](const int8_t* p) { return simd::loadInt8(p); };
+const auto storeI8 = [](int8_t* p, simd::VecF v) { simd::storeInt8(p, v); };
+
+int saturate(int v) {
+    return std::min(127, std::max(-128, v));
+}
+
+} // namespace
+
+int dtypeSize(DType dtype) {
+    switch (dtype) {
+        case DType::FP16: return 2;
+        case DType::INT8: return 1;
+        default: return 4;
+    }
+}
+
+const char* dtypeName(DType dtype) {
+    switch (dtype) {
+        case DType::FP16: return "FP16";
+        case DType::INT8: return "INT8";
+        default: return "FP32";
+    }
+}
+
+QuantParams QuantParams::perTensor(float scale, int zeroPoint) {
+    assert(scale > 0.0f && zeroPoint >= -128 && zeroPoint <= 127);
+    QuantParams p;
+    p.scale = {scale};
+    p.zeroPoint = {zeroPoint};
+    return p;
+}
+
+QuantParams QuantParams::perChannel(std::vector<float> scale, std::vector<int> zeroPoint, int axis) {
+    assert(axis >= 0 && !scale.empty() && scale.size() == zeroPoint.size());
+    QuantParams p;
+    p.scale = std::move(scale);
+    p.zeroPoint = std::move(zeroPoint);
+    p.axis = axis;
+    return p;
+}
+
+namespace quant {
+
+void chooseParams(float minVal, float maxVal, float& scale, int& zeroPoint) {
+    minVal = std::min(minVal, 0.0f);
+    maxVal = std::max(maxVal, 0.0f);
+    scale = (maxVal - minVal) / 255.0f;
+    if (!(scale > 0.0f)) { // all zeros (or non-finite input)
+        scale = 1.0f;
+        zeroPoint = 0;
+        return;
+    }
+    zeroPoint = saturate((int)std::lround(-128.0f - minVal / scale));
+}
+
+void minMax(const float* x, int n, float& minVal, float& maxVal) {
+    simd::VecF lo = simd::set1(minVal), hi = simd::set1(maxVal);
+    int i = 0;
+    for (; i + simd::kWidth <= n; i += simd::kWidth) {
+        const simd::VecF v = simd::load(x + i);
+        lo = simd::min(lo, v);
+        hi = simd::max(hi, v);
+    }
+    float loLanes[simd::kWidth], hiLanes[simd::kWidth];
+    simd::store(loLanes, lo);
+    simd::store(hiLanes, hi);
+    for (int l = 0; l < simd::kWidth; ++l) {
+        minVal = std::min(minVal, loLanes[l]);
+        maxVal = std::max(maxVal, hiLanes[l]);
+    }
+    for (; i < n; ++i) {
+        minVal = std::min(minVal, x[i]);
+        maxVal = std::max(maxVal, x[i]);
+    }
+}
+
+void quantize(const float* x, int8_t* q, int n, float scale, int zeroPoint) {
+    const simd::VecF inv = simd::set1(1.0f / scale), zp = simd::set1((float)zeroPoint);
+    convertVec(x, q, n, loadF32, storeI8, [=](simd::VecF v) { return simd::mulAdd(v, inv, zp); });
+}
+
+void dequantize(const int8_t* q, float* x, int n, float scale, int zeroPoint) {
+    const simd::VecF s = simd::set1(scale), zp = simd::set1((float)zeroPoint);
+    convertVec(q, x, n, loadI8, storeF32, [=](simd::VecF v) { return simd::mul(simd::sub(v, zp), s); });
+}
+
+void toHalf(const float* x, uint16_t* h, int n) {
+    convertVec(x, h, n, loadF32, [](uint16_t* p, simd::VecF v) { simd::storeHalf(p, v); }, [](simd::VecF v) { return v; });
+}
+
+void fromHalf(const uint16_t* h, float* x, int n) {
+    convertVec(h, x, n, [](const uint16_t* p) { return simd::loadHalf(p); }, storeF32, [](simd::VecF v) { return v; });
+}
+
+void add(int8_t* a, const int8_t* b, int n, float scaleA, int zeroA, float scaleB, int zeroB,
+         float scaleOut, int zeroOut) {
+    // out = a * (sA / sO) + b * (sB / sO) + (zO - zA * sA / sO - zB * sB / sO), rounded once
+    const float ka = scaleA / scaleOut, kb = scaleB / scaleOut;
+    const simd::VecF va = simd::set1(ka), vb = simd::set1(kb);
+    const simd::VecF bias = simd::set1((float)zeroOut - zeroA * ka - zeroB * kb);
+    int i = 0;
+    for (; i + simd::kWidth <= n; i += simd::kWidth) {
+        const simd::VecF r = simd::mulAdd(simd::loadInt8(a + i), va, simd::mulAdd(simd::loadInt8(b + i), vb, bias));
+        simd::storeInt8(a + i, r);
+    }
+    if (i < n) {
+        int8_t padA[simd::kWidth] = {}, padB[simd::kWidth] = {};
+        std::copy(a + i, a + n, padA);
+        std::copy(b + i, b + n, padB);
+        simd::storeInt8(padA, simd::mulAdd(simd::loadInt8(padA), va, simd::mulAdd(simd::loadInt8(padB), vb, bias)));
+        std::copy(padA, padA + (n - i), a + i);
+    }
+}
+
+// Plain integer loops: compilers turn these into saturating byte adds / byte max on every target
+void addOffset(int8_t* x, int n, int offset) {
+    if (offset >= 255 || offset <= -255) { // saturates everything; keeps the int16 math below in range
+        std::fill(x, x + n, (int8_t)(offset > 0 ? 127 : -128));
+        return;
+    }
+    const int16_t o = (int16_t)offset;
+    for (int i = 0; i < n; ++i) {
+        const int16_t v = (int16_t)(x[i] + o);
+        x[i] = (int8_t)(v > 127 ? 127 : (v < -128 ? -128 : v));
+    }
+}
+
+void relu(int8_t* x, int n, int zeroPoint) {
+    const int8_t z = (int8_t)zeroPoint;
+    for (int i = 0; i < n; ++i) x[i] = x[i] < z ? z : x[i];
+}
+
+} // namespace quant
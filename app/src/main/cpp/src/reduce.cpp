@@ -0,0 +1,461 @@
+#include "reduce.hpp"
+#include "kernels.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+constexpr int W = simd::kWidth;
+constexpr int kPairwiseBlock = 256; // summed with plain vector accumulators before pairing
+constexpr int kPairwiseRows = 8;    // rows accumulated in sequence before the row range is halved
+constexpr int kColBlock = 1024;     // inner > 1: output row block, so the accumulator rows stay in L1
+constexpr int kInsertionTopK = 32;  // topK up to this k keeps sorted lists instead of partial_sort
+
+float laneSum(simd::VecF v) {
+    float lanes[W];
+    simd::store(lanes, v);
+    float s = 0.0f;
+    for (int i = 0; i < W; ++i) s += lanes[i];
+    return s;
+}
+
+float sumBlock(const float* x, int n) {
+    simd::VecF acc0 = simd::set1(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    int i = 0;
+    for (; i + 4 * W <= n; i += 4 * W) {
+        acc0 = simd::add(acc0, simd::load(x + i));
+        acc1 = simd::add(acc1, simd::load(x + i + W));
+        acc2 = simd::add(acc2, simd::load(x + i + 2 * W));
+        acc3 = simd::add(acc3, simd::load(x + i + 3 * W));
+    }
+    for (; i + W <= n; i += W) acc0 = simd::add(acc0, simd::load(x + i));
+    float s = laneSum(simd::add(simd::add(acc0, acc1), simd::add(acc2, acc3)));
+    for (; i < n; ++i) s += x[i];
+    return s;
+}
+
+float sumPairwise(const float* x, int n) {
+    if (n <= kPairwiseBlock) return sumBlock(x, n);
+    const int half = (n / kPairwiseBlock + 1) / 2 * kPairwiseBlock; // whole blocks on the left
+    return sumPairwise(x, half) + sumPairwise(x + half, n - half);
+}
+
+// Kahan per lane, then the lane sums and compensations folded in with a scalar Kahan pass
+float sumKahan(const float* x, int n) {
+    simd::VecF s = simd::set1(0.0f), c = s;
+    int i = 0;
+    for (; i + W <= n; i += W) {
+        const simd::VecF y = simd::sub(simd::load(x + i), c);
+        const simd::VecF t = simd::add(s, y);
+        c = simd::sub(simd::sub(t, s), y);
+        s = t;
+    }
+    float sLanes[W], cLanes[W];
+    simd::store(sLanes, s);
+    simd::store(cLanes, c);
+    float sum = 0.0f, comp = 0.0f;
+    auto addTerm = [&](float v) {
+        const float y = v - comp;
+        const float t = sum + y;
+        comp = (t - sum) - y;
+        sum = t;
+    };
+    for (int l = 0; l < W; ++l) {
+        addTerm(sLanes[l]);
+        addTerm(-cLanes[l]);
+    }
+    for (; i < n; ++i) addTerm(x[i]);
+    return sum;
+}
+
+float sumRow(const float* x, int n, reduce::Summation mode) {
+    return mode == reduce::Summation::Kahan ? sumKahan(x, n) : sumPairwise(x, n);
+}
+
+float maxRow(const float* x, int n) {
+    int i = 0;
+    float m = x[0];
+    if (n >= W) {
+        simd::VecF acc = simd::load(x);
+        for (i = W; i + W <= n; i += W) acc = simd::max(acc, simd::load(x + i));
+        float lanes[W];
+        simd::store(lanes, acc);
+        m = *std::max_element(lanes, lanes + W);
+    }
+    for (; i < n; ++i) m = std::max(m, x[i]);
+    return m;
+}
+
+int argmaxRow(const float* x, int n) {
+    int i = 0, best = 0;
+    float bestVal = x[0];
+    if (n >= W) {
+        float iota[W];
+        for (int l = 0; l < W; ++l) iota[l] = (float)l;
+        simd::VecF idx = simd::load(iota), bestIdx = idx, val = simd::load(x);
+        const simd::VecF step = simd::set1((float)W);
+        for (i = W; i + W <= n; i += W) {
+            idx = simd::add(idx, step);
+            const simd::VecF v = simd::load(x + i);
+            const simd::MaskF gt = simd::cmpGt(v, val); // strict: each lane keeps its first maximum
+            val = simd::select(gt, v, val);
+            bestIdx = simd::select(gt, idx, bestIdx);
+        }
+        float vals[W], idxs[W];
+        simd::store(vals, val);
+        simd::store(idxs, bestIdx);
+        bestVal = vals[0];
+        best = (int)idxs[0];
+        for (int l = 1; l < W; ++l) {
+            if (vals[l] > bestVal || (vals[l] == bestVal && (int)idxs[l] < best)) {
+                bestVal = vals[l];
+                best = (int)idxs[l];
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        if (x[i] > bestVal) {
+            bestVal = x[i];
+            best = i;
+        }
+    }
+    return best;
+}
+
+// ---- inner > 1: rows of `width` floats, `ld` apart ----
+
+// dst = sum of `rows` rows, accumulated in sequence up to kPairwiseRows and halved above;
+// scratch holds one row per recursion level
+void sumRowsPairwise(const float* x, long ld, int rows, int width, float* dst, float* scratch) {
+    if (rows <= kPairwiseRows) {
+        std::copy(x, x + width, dst);
+        for (int r = 1; r < rows; ++r) kernels::add(dst, x + r * ld, width);
+        return;
+    }
+    const int half = rows / 2;
+    sumRowsPairwise(x, ld, half, width, dst, scratch + width);
+    sumRowsPairwise(x + half * ld, ld, rows - half, width, scratch, scratch + width);
+    kernels::add(dst, scratch, width);
+}
+
+void sumRowsKahan(const float* x, long ld, int rows, int width, float* dst, float* comp) {
+    std::fill(dst, dst + width, 0.0f);
+    std::fill(comp, comp + width, 0.0f);
+    for (int r = 0; r < rows; ++r) {
+        const float* row = x + r * ld;
+        int j = 0;
+        for (; j + W <= width; j += W) {
+            const simd::VecF s = simd::load(dst + j);
+            const simd::VecF y = simd::sub(simd::load(row + j), simd::load(comp + j));
+            const simd::VecF t = simd::add(s, y);
+            simd::store(comp + j, simd::sub(simd::sub(t, s), y));
+            simd::store(dst + j, t);
+        }
+        for (; j < width; ++j) {
+            const float y = row[j] - comp[j];
+            const float t = dst[j] + y;
+            comp[j] = (t - dst[j]) - y;
+            dst[j] = t;
+        }
+    }
+}
+
+void maxRows(const float* x, long ld, int rows, int width, float* dst) {
+    std::copy(x, x + width, dst);
+    for (int r = 1; r < rows; ++r) {
+        const float* row = x + r * ld;
+        int j = 0;
+        for (; j + W <= width; j += W) simd::store(dst + j, simd::max(simd::load(dst + j), simd::load(row + j)));
+        for (; j < width; ++j) dst[j] = std::max(dst[j], row[j]);
+    }
+}
+
+void argmaxRows(const float* x, long ld, int rows, int width, float* best, float* dst) {
+    std::copy(x, x + width, best);
+    std::fill(dst, dst + width, 0.0f);
+    for (int r = 1; r < rows; ++r) {
+        const float* row = x + r * ld;
+        const simd::VecF idx = simd::set1((float)r);
+        int j = 0;
+        for (; j + W <= width; j += W) {
+            const simd::VecF v = simd::load(row + j), b = simd::load(best + j);
+            const simd::MaskF gt = simd::cmpGt(v, b);
+            simd::store(best + j, simd::select(gt, v, b));
+            simd::store(dst + j, simd::select(gt, idx, simd::load(dst + j)));
+        }
+        for (; j < width; ++j) {
+            if (row[j] > best[j]) {
+                best[j] = row[j];
+                dst[j] = (float)r;
+            }
+        }
+    }
+}
+
+// Sorted top k of a contiguous row: one compare per element once the list is full. Strict >
+// keeps the earlier index of equal values first. Returns min(k, n).
+int insertTopK(const float* x, int n, int k, float* topV, int* topI) {
+    int count = 0;
+    for (int r = 0; r < n; ++r) {
+        if (count == k && !(x[r] > topV[k - 1])) continue;
+        int j = count < k ? count++ : k - 1;
+        for (; j > 0 && x[r] > topV[j - 1]; --j) {
+            topV[j] = topV[j - 1];
+            topI[j] = topI[j - 1];
+        }
+        topV[j] = x[r];
+        topI[j] = r;
+    }
+    return count;
+}
+
+// inner > 1: every column keeps its top k in k output rows (values, indices `outLd` apart).
+// Each input row walks down the lists with compare/selects, W columns at a time: it takes the
+// first entry it strictly beats and every entry below shifts down one. Row r < k only passes
+// the r entries filled so far and lands in entry r when it beats none.
+void topKRows(const float* x, long ld, int rows, int width, int k, float* outV, float* outI, long outLd) {
+    int j = 0;
+    for (; j + W <= width; j += W) {
+        simd::VecF tv[kInsertionTopK], ti[kInsertionTopK];
+        for (int r = 0; r < rows; ++r) {
+            simd::VecF v = simd::load(x + r * ld + j), idx = simd::set1((float)r);
+            const int levels = std::min(r, k);
+            simd::MaskF shift = simd::cmpGt(v, v); // all false
+            for (int l = 0; l < levels; ++l) {
+                shift = simd::maskOr(shift, simd::cmpGt(v, tv[l]));
+                const simd::VecF keptV = simd::select(shift, v, tv[l]), keptI = simd::select(shift, idx, ti[l]);
+                v = simd::select(shift, tv[l], v);
+                idx = simd::select(shift, ti[l], idx);
+                tv[l] = keptV;
+                ti[l] = keptI;
+            }
+            if (r < k) {
+                tv[r] = v;
+                ti[r] = idx;
+            }
+        }
+        for (int l = 0; l < k; ++l) {
+            simd::store(outV + l * outLd + j, tv[l]);
+            simd::store(outI + l * outLd + j, ti[l]);
+        }
+    }
+    for (; j < width; ++j) {
+        float tv[kInsertionTopK], ti[kInsertionTopK];
+        for (int r = 0; r < rows; ++r) {
+            float v = x[r * ld + j], idx = (float)r;
+            const int levels = std::min(r, k);
+            bool shift = false;
+            for (int l = 0; l < levels; ++l) {
+                shift = shift || v > tv[l];
+                if (shift) {
+                    std::swap(v, tv[l]);
+                    std::swap(idx, ti[l]);
+                }
+            }
+            if (r < k) {
+                tv[r] = v;
+                ti[r] = idx;
+            }
+        }
+        for (int l = 0; l < k; ++l) {
+            outV[l * outLd + j] = tv[l];
+            outI[l * outLd + j] = ti[l];
+        }
+    }
+}
+
+// Runs rowFn(o) for every outer index when inner == 1, and blockFn(o, j0, width) for every
+// kColBlock-wide column block of every outer index otherwise, spread over the pool
+template <typename RowFn, typename BlockFn>
+void forEachSlice(int outer, int n, int inner, RowFn rowFn, BlockFn blockFn) {
+    if (inner == 1) {
+        ThreadPool::getInstance().parallelFor(0, outer, std::max(1, kDefaultGrainSize / n), [&](int b, int e) {
+            for (int o = b; o < e; ++o) rowFn(o);
+        });
+        return;
+    }
+    const int blocks = (inner + kColBlock - 1) / kColBlock;
+    const int width = std::min(inner, kColBlock);
+    ThreadPool::getInstance().parallelFor(0, outer * blocks, std::max(1, kDefaultGrainSize / (n * width)), [&](int b, int e) {
+        for (int i = b; i < e; ++i) {
+            const int j0 = (i % blocks) * kColBlock;
+            blockFn(i / blocks, j0, std::min(kColBlock, inner - j0));
+        }
+    });
+}
+
+std::vector<float>& scratchRows(size_t count) {
+    static thread_local std::vector<float> scratch;
+    if (scratch.size() < count) scratch.resize(count);
+    return scratch;
+}
+
+} // namespace
+
+namespace reduce {
+
+void sum(const float* x, int outer, int n, int inner, float* dst, Summation mode) {
+    if (inner == 1 && outer == 1 && n >= 2 * kDefaultGrainSize) {
+        // One long row (a global sum): partial sums over grain-sized pieces, then combined
+        const int pieces = n / kDefaultGrainSize;
+        std::vector<float> partial(pieces);
+        ThreadPool::getInstance().parallelFor(0, pieces, 1, [&](int b, int e) {
+            for (int p = b; p < e; ++p) {
+                const int begin = p * kDefaultGrainSize;
+                const int end = p + 1 == pieces ? n : begin + kDefaultGrainSize;
+                partial[p] = sumRow(x + begin, end - begin, mode);
+            }
+        });
+        dst[0] = sumRow(partial.data(), pieces, mode);
+        return;
+    }
+    forEachSlice(outer, n, inner, [&](int o) { dst[o] = sumRow(x + (long)o * n, n, mode); },
+                 [&](int o, int j0, int width) {
+        const float* src = x + (long)o * n * inner + j0;
+        float* out = dst + (long)o * inner + j0;
+        if (mode == Summation::Kahan) {
+            sumRowsKahan(src, inner, n, width, out, scratchRows(width).data());
+        } else {
+            int depth = 1;
+            for (int rows = n; rows > kPairwiseRows; rows -= rows / 2) ++depth;
+            sumRowsPairwise(src, inner, n, width, out, scratchRows((size_t)depth * width).data());
+        }
+    });
+}
+
+void max(const float* x, int outer, int n, int inner, float* dst) {
+    forEachSlice(outer, n, inner, [&](int o) { dst[o] = maxRow(x + (long)o * n, n); },
+                 [&](int o, int j0, int width) {
+        maxRows(x + (long)o * n * inner + j0, inner, n, width, dst + (long)o * inner + j0);
+    });
+}
+
+void argmax(const float* x, int outer, int n, int inner, float* dst) {
+    forEachSlice(outer, n, inner, [&](int o) { dst[o] = (float)argmaxRow(x + (long)o * n, n); },
+                 [&](int o, int j0, int width) {
+        argmaxRows(x + (long)o * n * inner + j0, inner, n, width, scratchRows(width).data(), dst + (long)o * inner + j0);
+    });
+}
+
+void logSumExp(const float* x, int outer, int n, int inner, float* dst) {
+    forEachSlice(outer, n, inner, [&](int o) {
+        const float* row = x + (long)o * n;
+        const float m = maxRow(row, n);
+        float* t = scratchRows(n).data();
+        std::copy(row, row + n, t);
+        kernels::subScalar(t, n, m);
+        kernels::exp(t, n);
+        dst[o] = m + std::log(sumPairwise(t, n));
+    }, [&](int o, int j0, int width) {
+        const float* src = x + (long)o * n * inner + j0;
+        float* out = dst + (long)o * inner + j0;
+        float* m = scratchRows(2 * (size_t)width).data();
+        float* t = m + width;
+        maxRows(src, inner, n, width, m);
+        std::fill(out, out + width, 0.0f);
+        for (int r = 0; r < n; ++r) {
+            std::copy(src + (long)r * inner, src + (long)r * inner + width, t);
+            kernels::sub(t, m, width);
+            kernels::exp(t, width);
+            kernels::add(out, t, width);
+        }
+        kernels::log(out, width);
+        kernels::add(out, m, width);
+    });
+}
+
+void softmax(float* x, int outer, int n, int inner) {
+    forEachSlice(outer, n, inner, [&](int o) {
+        float* row = x + (long)o * n;
+        kernels::subScalar(row, n, maxRow(row, n));
+        kernels::exp(row, n);
+        kernels::divScalar(row, n, sumPairwise(row, n));
+    }, [&](int o, int j0, int width) {
+        float* src = x + (long)o * n * inner + j0;
+        float* m = scratchRows(2 * (size_t)width).data();
+        float* s = m + width;
+        maxRows(src, inner, n, width, m);
+        std::fill(s, s + width, 0.0f);
+        for (int r = 0; r < n; ++r) {
+            float* row = src + (long)r * inner;
+            kernels::sub(row, m, width);
+            kernels::exp(row, width);
+            kernels::add(s, row, width);
+        }
+        for (int r = 0; r < n; ++r) kernels::div(src + (long)r * inner, s, width);
+    });
+}
+
+void logSoftmax(float* x, int outer, int n, int inner) {
+    forEachSlice(outer, n, inner, [&](int o) {
+        float* row = x + (long)o * n;
+        kernels::subScalar(row, n, maxRow(row, n));
+        float* t = scratchRows(n).data();
+        std::copy(row, row + n, t);
+        kernels::exp(t, n);
+        kernels::subScalar(row, n, std::log(sumPairwise(t, n)));
+    }, [&](int o, int j0, int width) {
+        float* src = x + (long)o * n * inner + j0;
+        float* m = scratchRows(3 * (size_t)width).data();
+        float* s = m + width;
+        float* t = s + width;
+        maxRows(src, inner, n, width, m);
+        std::fill(s, s + width, 0.0f);
+        for (int r = 0; r < n; ++r) {
+            float* row = src + (long)r * inner;
+            kernels::sub(row, m, width);
+            std::copy(row, row + width, t);
+            kernels::exp(t, width);
+            kernels::add(s, t, width);
+        }
+        kernels::log(s, width);
+        for (int r = 0; r < n; ++r) kernels::sub(src + (long)r * inner, s, width);
+    });
+}
+
+void topK(const float* x, int outer, int n, int inner, int k, float* values, float* indices) {
+    if (k <= kInsertionTopK && inner > 1) {
+        forEachSlice(outer, n, inner, [](int) {}, [&](int o, int j0, int width) {
+            const long out = (long)o * k * inner + j0;
+            topKRows(x + (long)o * n * inner + j0, inner, n, width, k, values + out, indices + out, inner);
+        });
+        return;
+    }
+    ThreadPool::getInstance().parallelFor(0, outer * inner, std::max(1, kDefaultGrainSize / n), [&](int b, int e) {
+        static thread_local std::vector<float> gathered;
+        static thread_local std::vector<int> order;
+        gathered.resize(n);
+        order.resize(n);
+        float* v = gathered.data();
+        int* ord = order.data();
+        for (int s = b; s < e; ++s) {
+            const int o = s / inner, i = s % inner;
+            const float* src = x + (long)o * n * inner + i;
+            float* outV = values + (long)o * k * inner + i;
+            float* outI = indices + (long)o * k * inner + i;
+            if (k <= kInsertionTopK) { // inner == 1: a contiguous row
+                float topV[kInsertionTopK];
+                int topI[kInsertionTopK];
+                const int filled = insertTopK(src, n, k, topV, topI);
+                for (int j = 0; j < filled; ++j) {
+                    outV[j] = topV[j];
+                    outI[j] = (float)topI[j];
+                }
+                continue;
+            }
+            for (int r = 0; r < n; ++r) v[r] = src[(long)r * inner];
+            std::iota(ord, ord + n, 0);
+            std::partial_sort(ord, ord + k, ord + n, [v](int a, int c) { return v[a] > v[c] || (v[a] == v[c] && a < c); });
+            for (int j = 0; j < k; ++j) {
+                outV[(long)j * inner] = v[ord[j]];
+                outI[(long)j * inner] = (float)ord[j];
+            }
+        }
+    });
+}
+
+} // namespace reduce
@@ -0,0 +1,27 @@
+#include "storage.hpp"
+#include <algorithm>
+
+Storage::~Storage() {
+    if (allocator != nullptr) {
+        allocator->deallocate(ptr, count);
+        MemoryTracker::getInstance().recordFree(Device::CPU, tag, count * sizeof(float));
+    }
+}
+
+std::shared_ptr<Storage> Storage::allocate(size_t n, Allocator* allocator, bool zeroed) {
+    auto s = std::make_shared<Storage>();
+    s->allocator = allocator != nullptr ? allocator : &currentAllocator();
+    s->ptr = s->allocator->allocate(n);
+    s->count = n;
+    s->tag = currentMemoryTag();
+    if (zeroed) std::fill(s->ptr, s->ptr + n, 0.0f);
+    MemoryTracker::getInstance().recordAlloc(Device::CPU, s->tag, n * sizeof(float));
+    return s;
+}
+
+std::shared_ptr<Storage> Storage::wrap(float* data, size_t n) {
+    auto s = std::make_shared<Storage>();
+    s->ptr = data;
+    s->count = n;
+    return s;
+}
@@ -0,0 +1,364 @@
+#include "strided_copy.hpp"
+#include "kernels.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <array>
+
+namespace {
+
+constexpr int kBlock = 32; // transpose cache block: 32 x 32 floats = 4 KB per side
+
+// A strided loop nest after simplification: dims outermost first, with one element-stride
+// vector per operand (for copies: the source, then the row-major destination).
+template <int N>
+struct Dims {
+    std::vector<int> shape;
+    std::array<std::vector<long>, N> strides;
+};
+
+template <int N>
+using Offsets = std::array<long, N>;
+
+// Drops size-1 dims and merges neighbours that are contiguous for every operand
+template <int N>
+Dims<N> simplify(const std::vector<int>& shape, const std::array<std::vector<long>, N>& strides) {
+    Dims<N> d;
+    for (size_t i = 0; i < shape.size(); ++i) {
+        if (shape[i] == 1) continue;
+        const size_t last = d.shape.size();
+        bool merge = last > 0;
+        for (int k = 0; k < N && merge; ++k) merge = d.strides[k][last - 1] == strides[k][i] * shape[i];
+        if (merge) { // one longer dim (stride-0 broadcast dims merge with each other too)
+            d.shape[last - 1] *= shape[i];
+            for (int k = 0; k < N; ++k) d.strides[k][last - 1] = strides[k][i];
+            continue;
+        }
+        d.shape.push_back(shape[i]);
+        for (int k = 0; k < N; ++k) d.strides[k].push_back(strides[k][i]);
+    }
+    return d;
+}
+
+std::vector<long> widen(const std::vector<int>& strides) { return {strides.begin(), strides.end()}; }
+
+// Operand offsets of entry `i` (row-major) of the index space over `dims`
+template <int N>
+Offsets<N> offsetsOf(long i, const Dims<N>& d, const std::vector<int>& dims) {
+    Offsets<N> off{};
+    for (int j = (int)dims.size() - 1; j >= 0; --j) {
+        const int dim = dims[j];
+        const long idx = i % d.shape[dim];
+        i /= d.shape[dim];
+        for (int k = 0; k < N; ++k) off[k] += idx * d.strides[k][dim];
+    }
+    return off;
+}
+
+// Runs fn(offsets) for every entry of the index space over `dims`, in chunks of at least
+// `grain` entries across the pool
+template <int N, typename Fn>
+void forEachOffset(const Dims<N>& d, const std::vector<int>& dims, int grain, Fn fn) {
+    long count = 1;
+    for (int dim : dims) count *= d.shape[dim];
+    ThreadPool::getInstance().parallelFor(0, (int)count, std::max(1, grain), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) fn(offsetsOf<N>(i, d, dims));
+    });
+}
+
+std::vector<long> rowMajorStrides(const std::vector<int>& shape) {
+    std::vector<long> strides(shape.size());
+    long stride = 1;
+    for (int i = (int)shape.size() - 1; i >= 0; --i) {
+        strides[i] = stride;
+        stride *= shape[i];
+    }
+    return strides;
+}
+
+constexpr int kRowChunk = 1024; // binary-op row piece: 4 KB of scratch per strided side, L1 resident
+
+void applyRow(strided::BinaryOp op, float* x, const float* y, int n) {
+    switch (op) {
+        case strided::BinaryOp::Add: kernels::add(x, y, n); break;
+        case strided::BinaryOp::Sub: kernels::sub(x, y, n); break;
+        case strided::BinaryOp::Mul: kernels::mul(x, y, n); break;
+        case strided::BinaryOp::Div: kernels::div(x, y, n); break;
+    }
+}
+
+void applyScalar(strided::BinaryOp op, float* x, int n, float s) {
+    switch (op) {
+        case strided::BinaryOp::Add: kernels::addScalar(x, n, s); break;
+        case strided::BinaryOp::Sub: kernels::subScalar(x, n, s); break;
+        case strided::BinaryOp::Mul: kernels::mulScalar(x, n, s); break;
+        case strided::BinaryOp::Div: kernels::divScalar(x, n, s); break;
+    }
+}
+
+// out[i * os] = a[i * as] op b[i * bs] for i < n <= kRowChunk. The a side is laid down in the
+// output row (copied, filled from a broadcast scalar or gathered), then b is applied to it as
+// a row or, when b is broadcast along the row, as a scalar; scratch only for strided sides.
+void binaryRow(strided::BinaryOp op, int n, float* out, long os, const float* a, long as, const float* b, long bs) {
+    float rowScratch[kRowChunk];
+    float* row = os == 1 ? out : rowScratch;
+    if (as == 1) {
+        if (row != a) std::copy(a, a + n, row);
+    } else if (as == 0) {
+        simd::fill(row, n, a[0]);
+    } else {
+        for (int i = 0; i < n; ++i) row[i] = a[i * as];
+    }
+
+    if (bs == 0) {
+        applyScalar(op, row, n, b[0]);
+    } else if (bs == 1) {
+        applyRow(op, row, b, n);
+    } else {
+        float bScratch[kRowChunk];
+        for (int i = 0; i < n; ++i) bScratch[i] = b[i * bs];
+        applyRow(op, row, bScratch, n);
+    }
+
+    if (row != out) {
+        for (int i = 0; i < n; ++i) out[i * os] = row[i];
+    }
+}
+
+// One tile of pack()'s batched transposes: float tiles go through the SIMD register blocks,
+// FP16 / INT8 tiles are plain loops (a tile already keeps both sides in cache)
+void transposeTile(const float* src, int srcLd, float* dst, int dstLd, int rows, int cols) {
+    strided::transpose2d(src, srcLd, dst, dstLd, rows, cols);
+}
+
+template <typename T>
+void transposeTile(const T* src, int srcLd, T* dst, int dstLd, int rows, int cols) {
+    for (int c = 0; c < cols; ++c) {
+        for (int r = 0; r < rows; ++r) dst[(size_t)c * dstLd + r] = src[(size_t)r * srcLd + c];
+    }
+}
+
+// pack() for any element type; only float tiles have a SIMD transpose
+template <typename T>
+void packElements(const T* src, const std::vector<int>& shape, const std::vector<int>& strides, T* dst) {
+    long total = 1;
+    for (int s : shape) total *= s;
+    if (total == 0) return;
+
+    const Dims<2> d = simplify<2>(shape, {widen(strides), rowMajorStrides(shape)});
+    const std::vector<long>& srcStrides = d.strides[0];
+    const std::vector<long>& dstStrides = d.strides[1];
+    const int rank = (int)d.shape.size();
+    if (rank == 0) { // a single element
+        dst[0] = src[0];
+        return;
+    }
+
+    const int last = rank - 1;
+    const int inner = d.shape[last];
+    if (srcStrides[last] == 1 && rank == 1) { // already packed
+        ThreadPool::getInstance().parallelFor(0, inner, kDefaultGrainSize, [&](int b, int e) {
+            std::copy(src + b, src + e, dst + b);
+        });
+        return;
+    }
+
+    std::vector<int> outer(last);
+    for (int i = 0; i < last; ++i) outer[i] = i;
+    if (srcStrides[last] == 1) { // contiguous rows
+        forEachOffset<2>(d, outer, kDefaultGrainSize / inner, [&](const Offsets<2>& o) {
+            std::copy(src + o[0], src + o[0] + inner, dst + o[1]);
+        });
+        return;
+    }
+
+    int k = -1; // the source's stride-1 dim, if any
+    for (int i = 0; i < last; ++i) {
+        if (srcStrides[i] == 1) k = i;
+    }
+    if (k >= 0) { // batched transposes: rows along `last`, columns along k, split into column blocks
+        std::vector<int> batch;
+        for (int i = 0; i < last; ++i) {
+            if (i != k) batch.push_back(i);
+        }
+        long batchCount = 1;
+        for (int dim : batch) batchCount *= d.shape[dim];
+        const int rows = inner, cols = d.shape[k];
+        // About kBlock^2 elements per tile; a short side (e.g. 3 channels) lengthens the other
+        const int tileRows = rows < kBlock ? rows : kBlock * std::max(1, kBlock / std::min(cols, kBlock));
+        const int tileCols = cols < kBlock ? cols : kBlock * std::max(1, kBlock / std::min(rows, kBlock));
+        const int rowBlocks = (rows + tileRows - 1) / tileRows, colBlocks = (cols + tileCols - 1) / tileCols;
+        const int srcLd = (int)srcStrides[last], dstLd = (int)dstStrides[k];
+        ThreadPool::getInstance().parallelFor(0, (int)(batchCount * rowBlocks * colBlocks),
+                                              std::max(1, kDefaultGrainSize / (tileRows * tileCols)), [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) { // columns fastest
+                const int c0 = (i % colBlocks) * tileCols, r0 = (i / colBlocks % rowBlocks) * tileRows;
+                const Offsets<2> o = offsetsOf<2>(i / colBlocks / rowBlocks, d, batch);
+                transposeTile(src + o[0] + (long)r0 * srcLd + c0, srcLd, dst + o[1] + r0 + c0 * dstStrides[k], dstLd,
+                            std::min(tileRows, rows - r0), std::min(tileCols, cols - c0));
+            }
+        });
+        return;
+    }
+
+    // Gather: no unit-stride dim on the source side (stepped slices, broadcasts)
+    const long innerStride = srcStrides[last];
+    forEachOffset<2>(d, outer, kDefaultGrainSize / inner, [&](const Offsets<2>& o) {
+        for (int i = 0; i < inner; ++i) dst[o[1] + i] = src[o[0] + i * innerStride];
+    });
+}
+
+// The inverse of pack(): row-major src written through (shape, strides) rooted at dst
+template <typename T>
+void scatterElements(const T* src, const std::vector<int>& shape, const std::vector<int>& strides, T* dst) {
+    long total = 1;
+    for (int s : shape) total *= s;
+    if (total == 0) return;
+
+    const Dims<2> d = simplify<2>(shape, {widen(strides), rowMajorStrides(shape)});
+    const int rank = (int)d.shape.size();
+    if (rank == 0) {
+        dst[0] = src[0];
+        return;
+    }
+    const int last = rank - 1;
+    const int inner = d.shape[last];
+    const long innerStride = d.strides[0][last];
+    std::vector<int> outer(last);
+    for (int i = 0; i < last; ++i) outer[i] = i;
+    forEachOffset<2>(d, outer, kDefaultGrainSize / inner, [&](const Offsets<2>& o) {
+        if (innerStride == 1) std::copy(src + o[1], src + o[1] + inner, dst + o[0]);
+        else for (int i = 0; i < inner; ++i) dst[o[0] + i * innerStride] = src[o[1] + i];
+    });
+}
+
+} // namespace
+
+namespace strided {
+
+void transpose2d(const float* src, int srcLd, float* dst, int dstLd, int rows, int cols) {
+    constexpr int W = simd::kWidth;
+    if (rows < W) { // too few rows for a register block: keep the destination writes sequential
+        for (int c = 0; c < cols; ++c) {
+            for (int r = 0; r < rows; ++r) dst[(size_t)c * dstLd + r] = src[(size_t)r * srcLd + c];
+        }
+        return;
+    }
+    for (int c0 = 0; c0 < cols; c0 += kBlock) {
+        const int c1 = std::min(cols, c0 + kBlock);
+        for (int r0 = 0; r0 < rows; r0 += kBlock) {
+            const int r1 = std::min(rows, r0 + kBlock);
+            int r = r0;
+            for (; r + W <= r1; r += W) {
+                int c = c0;
+                for (; c + W <= c1; c += W) {
+                    simd::transposeBlock(src + (size_t)r * srcLd + c, srcLd, dst + (size_t)c * dstLd + r, dstLd);
+                }
+                for (; c < c1; ++c) {
+                    for (int i = r; i < r + W; ++i) dst[(size_t)c * dstLd + i] = src[(size_t)i * srcLd + c];
+                }
+            }
+            for (; r < r1; ++r) {
+                for (int c = c0; c < c1; ++c) dst[(size_t)c * dstLd + r] = src[(size_t)r * srcLd + c];
+            }
+        }
+    }
+}
+
+void pack(const float* src, const std::vector<int>& shape, const std::vector<int>& strides, float* dst) {
+    packElements(src, shape, strides, dst);
+}
+
+void pack(const uint16_t* src, const std::vector<int>& shape, const std::vector<int>& strides, uint16_t* dst) {
+    packElements(src, shape, strides, dst);
+}
+
+void pack(const int8_t* src, const std::vector<int>& shape, const std::vector<int>& strides, int8_t* dst) {
+    packElements(src, shape, strides, dst);
+}
+
+void scatter(const int8_t* src, const std::vector<int>& shape, const std::vector<int>& strides, int8_t* dst) {
+    scatterElements(src, shape, strides, dst);
+}
+
+void binary(BinaryOp op, const std::vector<int>& shape, float* out, const std::vector<int>& outStrides,
+            const float* a, const std::vector<int>& aStrides, const float* b, const std::vector<int>& bStrides) {
+    long total = 1;
+    for (int s : shape) total *= s;
+    if (total == 0) return;
+
+    const Dims<3> d = simplify<3>(shape, {widen(outStrides), widen(aStrides), widen(bStrides)});
+    const int rank = (int)d.shape.size();
+    if (rank == 0) {
+        binaryRow(op, 1, out, 1, a, 1, b, 1);
+        return;
+    }
+
+    // Rows along the innermost dim; a long row (a flat or scalar-broadcast op coalesces to one)
+    // is cut into pieces so the pool still gets enough tasks.
+    const int last = rank - 1;
+    const int inner = d.shape[last];
+    const long os = d.strides[0][last], as = d.strides[1][last], bs = d.strides[2][last];
+    std::vector<int> outer(last);
+    for (int i = 0; i < last; ++i) outer[i] = i;
+    long rows = 1;
+    for (int dim : outer) rows *= d.shape[dim];
+    const int pieces = std::max(1, inner / kDefaultGrainSize);
+    const int pieceLen = (inner + pieces - 1) / pieces;
+    ThreadPool::getInstance().parallelFor(0, (int)(rows * pieces), std::max(1, kDefaultGrainSize / pieceLen),
+                                          [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const Offsets<3> o = offsetsOf<3>(i / pieces, d, outer);
+            const int j1 = std::min(inner, (i % pieces + 1) * pieceLen);
+            for (int j = (i % pieces) * pieceLen; j < j1; j += kRowChunk) {
+                binaryRow(op, std::min(kRowChunk, j1 - j), out + o[0] + j * os, os, a + o[1] + j * as, as, b + o[2] + j * bs, bs);
+            }
+        }
+    });
+}
+
+void unary(const std::vector<int>& shape, float* x, const std::vector<int>& strides,
+           const std::function<void(float*, int)>& fn) {
+    long total = 1;
+    for (int s : shape) total *= s;
+    if (total == 0) return;
+
+    const Dims<1> d = simplify<1>(shape, {widen(strides)});
+    const int rank = (int)d.shape.size();
+    if (rank == 0) {
+        fn(x, 1);
+        return;
+    }
+
+    // Rows along the innermost dim, long rows cut into pieces as in binary()
+    const int last = rank - 1;
+    const int inner = d.shape[last];
+    const long xs = d.strides[0][last];
+    std::vector<int> outer(last);
+    for (int i = 0; i < last; ++i) outer[i] = i;
+    long rows = 1;
+    for (int dim : outer) rows *= d.shape[dim];
+    const int pieces = std::max(1, inner / kDefaultGrainSize);
+    const int pieceLen = (inner + pieces - 1) / pieces;
+    ThreadPool::getInstance().parallelFor(0, (int)(rows * pieces), std::max(1, kDefaultGrainSize / pieceLen),
+                                          [&](int begin, int end) {
+        float scratch[kRowChunk];
+        for (int i = begin; i < end; ++i) {
+            float* row = x + offsetsOf<1>(i / pieces, d, outer)[0];
+            const int j0 = (i % pieces) * pieceLen, j1 = std::min(inner, j0 + pieceLen);
+            if (xs == 1) {
+                fn(row + j0, j1 - j0);
+                continue;
+            }
+            for (int j = j0; j < j1; j += kRowChunk) {
+                const int n = std::min(kRowChunk, j1 - j);
+                float* p = row + j * xs;
+                for (int k = 0; k < n; ++k) scratch[k] = p[k * xs];
+                fn(scratch, n);
+                for (int k = 0; k < n; ++k) p[k * xs] = scratch[k];
+            }
+        }
+    });
+}
+
+} // namespace strided
@@ -1,24 +1,32 @@
 #include "tensor.hpp"
+#include "gemm.hpp"
+#include "kernels.hpp"
+#include "layout.hpp"
 #include "logger.hpp"
+#include "memory_tracker.hpp"
+#include "strided_copy.hpp"
+#include "tensor_expr.hpp"
+#include "thread_pool.hpp"
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <ostream>
 #include <set>
+#include <stdexcept>
 #include <cmath>
+#include <utility>
 
-Tensor::Tensor() : device(Device::CPU) {}
+Tensor::Tensor() : device(Device::CPU), totalSize(0), contiguous(true) {}
 
 Tensor::Tensor(const std::vector<int>& shape_, Device dev) : shape(shape_), device(dev) {
     totalSize = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
     contiguous = true;
-    cpuData.resize(totalSize, 0.0f);
-    cpuGrad.resize(totalSize, 0.0f);
+    storage = Storage::allocate(totalSize);
     computeStrides();
 
     // Log tensor creation
-    std::string deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
+    const char* deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
     LOG_TENSOR_OP("CREATE", deviceStr, shape, true, "");
-    LOG_MEMORY_ALLOC("CPU", totalSize * sizeof(float) * 2, "Tensor data and gradients");
 
 #ifdef USE_CUDA
     if (device == Device::GPU) {
@@ -27,11 +35,384 @@ Tensor::Tensor(const std::vector<int>& shape_, Device dev) : shape(shape_), devi
 #endif
 }
 
+namespace {
+
+// The typed accessors gate every kernel on the element type, so this stays on in release builds:
+// reading INT8 / FP16 storage as floats would silently produce garbage
+void requireDType(DType actual, DType expected, const char* accessor) {
+    if (actual == expected) return;
+    const std::string message = std::string("Tensor::") + accessor + " needs " + dtypeName(expected) + ", tensor is " +
+                                dtypeName(actual) + "; convert with toDType() first";
+    LOG_ERROR(message);
+    throw std::invalid_argument(message);
+}
+
+// Gradient buffers are plain vectors rather than Storage, so they are reported here
+void trackGradient(const std::vector<float>& grad, bool allocated) {
+    if (grad.empty()) return;
+    if (allocated) MemoryTracker::getInstance().recordAlloc(Device::CPU, MemoryTag::Gradient, grad.size() * sizeof(float));
+    else MemoryTracker::getInstance().recordFree(Device::CPU, MemoryTag::Gradient, grad.size() * sizeof(float));
+}
+
+// Splits an elementwise loop over n elements across the shared pool; small tensors stay inline
+template <typename Kernel>
+inline void parallelElementwise(int n, Kernel kernel) {
+    ThreadPool::getInstance().parallelFor(0, n, kDefaultGrainSize, [&](int b, int e) { kernel(b, e - b); });
+}
+
+// Storage is counted in floats; narrower dtypes round the byte size up to whole floats
+size_t storageFloats(int n, DType dtype) {
+    return ((size_t)n * dtypeSize(dtype) + sizeof(float) - 1) / sizeof(float);
+}
+
+// Row-major copy of `dtype` elements read through (shape, strides) from src into dst
+void packAs(DType dtype, const void* src, const std::vector<int>& shape, const std::vector<int>& strides, void* dst) {
+    switch (dtype) {
+        case DType::FP16:
+            strided::pack(static_cast<const uint16_t*>(src), shape, strides, static_cast<uint16_t*>(dst));
+            break;
+        case DType::INT8:
+            strided::pack(static_cast<const int8_t*>(src), shape, strides, static_cast<int8_t*>(dst));
+            break;
+        default:
+            strided::pack(static_cast<const float*>(src), shape, strides, static_cast<float*>(dst));
+            break;
+    }
+}
+
+// Per-channel params of a view: the channels move to `axis`, and channel i of the view is
+// channel first + i * step of the source (step 0 repeats one channel along a broadcast)
+std::shared_ptr<const QuantParams> remapChannels(const QuantParams& params, int axis, int count, int first, int step) {
+    std::vector<float> scale(count);
+    std::vector<int> zeroPoint(count);
+    for (int i = 0; i < count; ++i) {
+        scale[i] = params.scale[first + i * step];
+        zeroPoint[i] = params.zeroPoint[first + i * step];
+    }
+    return std::make_shared<const QuantParams>(QuantParams::perChannel(std::move(scale), std::move(zeroPoint), axis));
+}
+
+// [outer, channels, inner] split of a packed tensor around `axis` (channels = 1 when axis < 0)
+void quantSplit(const std::vector<int>& shape, int axis, int& outer, int& channels, int& inner) {
+    outer = channels = inner = 1;
+    for (int d = 0; d < (int)shape.size(); ++d) {
+        if (axis < 0 || d > axis) inner *= shape[d];
+        else if (d < axis) outer *= shape[d];
+        else channels = shape[d];
+    }
+}
+
+// Calls kernel(begin, count, scale, zeroPoint) for each run of a packed tensor that shares one
+// quantization pair: the whole tensor per tensor, one inner plane per channel otherwise
+template <typename Kernel>
+void forEachQuantRun(const std::vector<int>& shape, const QuantParams& params, Kernel kernel) {
+    int outer, channels, inner;
+    quantSplit(shape, params.axis, outer, channels, inner);
+    if (!params.isPerChannel()) {
+        parallelElementwise(inner, [&](int i, int n) { kernel(i, n, params.scale[0], params.zeroPoint[0]); });
+        return;
+    }
+    assert(channels == params.channels());
+    const int grain = std::max(1, kDefaultGrainSize / std::max(1, inner));
+    ThreadPool::getInstance().parallelFor(0, outer * channels, grain, [&](int b, int e) {
+        for (int p = b; p < e; ++p) kernel(p * inner, inner, params.scale[p % channels], params.zeroPoint[p % channels]);
+    });
+}
+
+// Whether the trailing [rows, cols] matrix of a tensor with these strides can go to sgemm
+// as-is: row-major (trans = false) or column-major (trans = true), with its leading dimension.
+bool gemmLayout(const std::vector<int>& shape, const std::vector<int>& strides, bool& trans, int& ld) {
+    const size_t r = shape.size();
+    const int rows = shape[r - 2], cols = shape[r - 1];
+    const int rowStride = strides[r - 2], colStride = strides[r - 1];
+    if ((colStride == 1 || cols == 1) && rowStride >= std::max(1, cols)) {
+        trans = false;
+        ld = rowStride;
+        return true;
+    }
+    if ((rowStride == 1 || rows == 1) && colStride >= std::max(1, rows)) {
+        trans = true;
+        ld = colStride;
+        return true;
+    }
+    return false;
+}
+
+// Element offset of matrix `b` (row-major index over the leading batch dims) in a tensor.
+int batchOffset(const std::vector<int>& shape, const std::vector<int>& strides, int b) {
+    int offset = 0;
+    for (int d = (int)shape.size() - 3; d >= 0; --d) {
+        offset += (b % shape[d]) * strides[d];
+        b /= shape[d];
+    }
+    return offset;
+}
+
+} // namespace
+
+Tensor Tensor::clone() const {
+    Tensor t;
+    t.shape = shape;
+    t.totalSize = totalSize;
+    t.computeStrides();
+    t.storage = Storage::allocate(storageFloats(totalSize, dtype), nullptr, !storage); // the copy below fills it
+    t.dtype = dtype;
+    t.quant = quant;
+    if (totalSize > 0 && storage) {
+        if (!contiguous) packAs(dtype, rawData(), shape, strides, t.storage->data());
+        else if (dtype != DType::FP32) std::memcpy(t.storage->data(), rawData(), (size_t)totalSize * dtypeSize(dtype));
+        else std::copy(data(), data() + totalSize, t.data()); // NHWC/blocked inner dims are tiny
+    }
+    t.cpuGrad = cpuGrad;
+    trackGradient(t.cpuGrad, true);
+    t.gradEnabled = gradEnabled;
+    t.format = format;
+    t.blockedChannels = blockedChannels;
+
+#ifdef USE_CUDA
+    if (device == Device::GPU) {
+        cloneGpu(t);
+    }
+#endif
+    return t;
+}
+
+Tensor::Tensor(Tensor&& other) noexcept
+    : device(other.device), totalSize(other.totalSize), contiguous(other.contiguous),
+      shape(std::move(other.shape)), strides(std::move(other.strides)),
+      storage(std::move(other.storage)), offset(other.offset), cpuGrad(std::move(other.cpuGrad)),
+      gradEnabled(other.gradEnabled), format(other.format), blockedChannels(other.blockedChannels),
+      dtype(other.dtype), quant(std::move(other.quant)) {
+#ifdef USE_CUDA
+    gpuData = other.gpuData;
+    gpuGrad = other.gpuGrad;
+    gpuTag = other.gpuTag;
+    other.gpuData = nullptr;
+    other.gpuGrad = nullptr;
+#endif
+    other.totalSize = 0;
+    other.offset = 0;
+}
+
+Tensor& Tensor::operator=(Tensor&& other) noexcept {
+    if (this == &other) return *this;
+#ifdef USE_CUDA
+    freeGpuMemory();
+    gpuData = other.gpuData;
+    gpuGrad = other.gpuGrad;
+    gpuTag = other.gpuTag;
+    other.gpuData = nullptr;
+    other.gpuGrad = nullptr;
+#endif
+    device = other.device;
+    totalSize = other.totalSize;
+    contiguous = other.contiguous;
+    shape = std::move(other.shape);
+    strides = std::move(other.strides);
+    storage = std::move(other.storage);
+    offset = other.offset;
+    trackGradient(cpuGrad, false);
+    cpuGrad = std::move(other.cpuGrad);
+    gradEnabled = other.gradEnabled;
+    format = other.format;
+    blockedChannels = other.blockedChannels;
+    dtype = other.dtype;
+    quant = std::move(other.quant);
+    other.totalSize = 0;
+    other.offset = 0;
+    return *this;
+}
+
+Tensor Tensor::fromBuffer(float* data, const std::vector<int>& shape_) {
+    assert(data != nullptr);
+    Tensor t;
+    t.shape = shape_;
+    t.totalSize = std::accumulate(t.shape.begin(), t.shape.end(), 1, std::multiplies<int>());
+    t.storage = Storage::wrap(data, t.totalSize);
+    t.computeStrides();
+
+    LOG_TENSOR_OP("VIEW", "CPU", t.shape, true, "");
+    return t;
+}
+
+Tensor Tensor::empty(const std::vector<int>& shape_) {
+    Tensor t;
+    t.shape = shape_;
+    t.totalSize = std::accumulate(t.shape.begin(), t.shape.end(), 1, std::multiplies<int>());
+    t.storage = Storage::allocate(t.totalSize, nullptr, false);
+    t.computeStrides();
+
+    LOG_TENSOR_OP("CREATE", "CPU", t.shape, true, "");
+    return t;
+}
+
+Tensor Tensor::view() const {
+    assert(device == Device::CPU);
+    Tensor t;
+    t.shape = shape;
+    t.strides = strides;
+    t.totalSize = totalSize;
+    t.contiguous = contiguous;
+    t.storage = storage;
+    t.offset = offset;
+    t.format = format;
+    t.blockedChannels = blockedChannels;
+    t.dtype = dtype;
+    t.quant = quant;
+    return t;
+}
+
+Tensor Tensor::slice(int dim, int start, int end, int step) const {
+    assert(dim >= 0 && dim < (int)shape.size());
+    assert(step > 0 && start >= 0 && start <= end && end <= shape[dim]);
+
+    Tensor t = view();
+    t.offset += start * strides[dim];
+    t.shape[dim] = (end - start + step - 1) / step;
+    t.strides[dim] *= step;
+    t.totalSize = std::accumulate(t.shape.begin(), t.shape.end(), 1, std::multiplies<int>());
+    t.contiguous = t.hasContiguousStrides();
+    if (channelBlock(format) > 1 && (dim == 1 || dim == 4)) t.format = MemoryFormat::NCHW; // cuts through channel blocks
+    if (quant && dim == quant->axis) t.quant = remapChannels(*quant, dim, t.shape[dim], start, step);
+    return t;
+}
+
+Tensor Tensor::narrow(int dim, int start, int length) const {
+    return slice(dim, start, start + length);
+}
+
+Tensor Tensor::select(int dim, int index) const {
+    assert(dim >= 0 && dim < (int)shape.size());
+    assert(index >= 0 && index < shape[dim]);
+
+    Tensor t = view();
+    t.offset += index * strides[dim];
+    t.shape.erase(t.shape.begin() + dim);
+    t.strides.erase(t.strides.begin() + dim);
+    t.format = MemoryFormat::NCHW;
+    t.totalSize = std::accumulate(t.shape.begin(), t.shape.end(), 1, std::multiplies<int>());
+    t.contiguous = t.hasContiguousStrides();
+    if (quant && dim == quant->axis) {
+        t.quant = std::make_shared<const QuantParams>(QuantParams::perTensor(quant->scale[index], quant->zeroPoint[index]));
+    } else if (quant && dim < quant->axis) {
+        t.quant = remapChannels(*quant, quant->axis - 1, quant->channels(), 0, 1);
+    }
+    return t;
+}
+
+Tensor Tensor::toContiguous() const {
+    Tensor t = view();
+    t.makeContiguous();
+    return t;
+}
+
+int channelBlock(MemoryFormat format) {
+    switch (format) {
+        case MemoryFormat::NCHWc4: return 4;
+        case MemoryFormat::NCHWc8: return 8;
+        default: return 1;
+    }
+}
+
+const char* memoryFormatName(MemoryFormat format) {
+    switch (format) {
+        case MemoryFormat::NHWC: return "NHWC";
+        case MemoryFormat::NCHWc4: return "NCHWc4";
+        case MemoryFormat::NCHWc8: return "NCHWc8";
+        default: return "NCHW";
+    }
+}
+
+Tensor Tensor::withMemoryFormat(const std::vector<int>& nchwShape, MemoryFormat format) {
+    assert(nchwShape.size() == 4);
+    const int N = nchwShape[0], C = nchwShape[1], H = nchwShape[2], W = nchwShape[3];
+    const int block = channelBlock(format);
+    std::vector<int> physical = nchwShape;
+    if (format == MemoryFormat::NHWC) physical = {N, H, W, C};
+    else if (block > 1) physical = {N, (C + block - 1) / block, H, W, block};
+
+    Tensor t(physical);
+    t.format = format;
+    t.blockedChannels = block > 1 ? C : 0;
+    return t;
+}
+
+Tensor Tensor::toMemoryFormat(MemoryFormat target) const {
+    assert(device == Device::CPU && isImageShaped());
+    if (target == format) return toContiguous();
+
+    const std::vector<int> nchw = getLogicalShape();
+    const int N = nchw[0], C = nchw[1], HW = nchw[2] * nchw[3];
+    const int from = channelBlock(format), to = channelBlock(target);
+    Tensor src = toContiguous();
+    if (from > 1 && to > 1) src = src.toMemoryFormat(MemoryFormat::NCHW); // c4 <-> c8 goes through NCHW
+
+    Tensor out = withMemoryFormat(nchw, target);
+    const float* s = src.data();
+    float* d = out.data();
+    switch (src.format) {
+        case MemoryFormat::NCHW:
+            if (target == MemoryFormat::NHWC) layout::nchwToNhwc(s, d, N, C, HW);
+            else layout::nchwToBlocked(s, d, N, C, HW, to);
+            break;
+        case MemoryFormat::NHWC:
+            if (target == MemoryFormat::NCHW) layout::nhwcToNchw(s, d, N, C, HW);
+            else layout::nhwcToBlocked(s, d, N, C, HW, to);
+            break;
+        default:
+            if (target == MemoryFormat::NCHW) layout::blockedToNchw(s, d, N, C, HW, from);
+            else layout::blockedToNhwc(s, d, N, C, HW, from);
+            break;
+    }
+
+    LOG_TENSOR_OP("TO_FORMAT", "CPU", out.shape, true,
+                  std::string(memoryFormatName(format)) + " -> " + memoryFormatName(target));
+    return out;
+}
+
+void Tensor::setMemoryFormat(MemoryFormat format_, int channels) {
+    const int block = channelBlock(format_);
+    format = format_;
+    blockedChannels = block > 1 ? (channels > 0 ? channels : shape[1] * block) : 0;
+    assert(isImageShaped());
+    assert(block == 1 || (shape[4] == block && blockedChannels > (shape[1] - 1) * block && blockedChannels <= shape[1] * block));
+}
+
+MemoryFormat Tensor::getMemoryFormat() const {
+    return format;
+}
+
+int Tensor::getChannels() const {
+    assert(isImageShaped());
+    if (format == MemoryFormat::NHWC) return shape[3];
+    return channelBlock(format) > 1 ? blockedChannels : shape[1];
+}
+
+std::vector<int> Tensor::getLogicalShape() const {
+    assert(isImageShaped());
+    if (format == MemoryFormat::NHWC) return {shape[0], shape[3], shape[1], shape[2]};
+    if (channelBlock(format) > 1) return {shape[0], blockedChannels, shape[2], shape[3]};
+    return shape;
+}
+
+bool Tensor::isImageShaped() const {
+    return shape.size() == (channelBlock(format) > 1 ? 5u : 4u);
+}
+
+int Tensor::elementOffset(int n, int c, int h, int w) const {
+    const int block = channelBlock(format);
+    if (format == MemoryFormat::NHWC) return n * strides[0] + h * strides[1] + w * strides[2] + c * strides[3];
+    if (block > 1) return n * strides[0] + (c / block) * strides[1] + h * strides[2] + w * strides[3] + (c % block) * strides[4];
+    return n * strides[0] + c * strides[1] + h * strides[2] + w * strides[3];
+}
+
 Tensor::~Tensor() {
-    // Log tensor destruction
-    std::string deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
-    LOG_TENSOR_OP("DESTROY", deviceStr, shape, true, "");
-    LOG_MEMORY_DEALLOC("CPU", totalSize * sizeof(float) * 2, "Tensor data and gradients");
+    // Log tensor destruction once the last tensor owning the storage goes away
+    if (storage && !storage->isExternal() && storage.use_count() == 1) {
+        const char* deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
+        LOG_TENSOR_OP("DESTROY", deviceStr, shape, true, "");
+    }
+    trackGradient(cpuGrad, false);
 
 #ifdef USE_CUDA
     freeGpuMemory();
@@ -47,6 +428,33 @@ void Tensor::computeStrides() { // contiguous!!
     }
 }
 
+bool Tensor::hasContiguousStrides() const {
+    int expected = 1;
+    for (int i = (int)shape.size() - 1; i >= 0; --i) {
+        if (shape[i] == 1) continue; // stride of a size-1 dim never matters
+        if (strides[i] != expected) return false;
+        expected *= shape[i];
+    }
+    return true;
+}
+
+bool Tensor::isDense() const {
+    if (contiguous) return true;
+    // Sorting dims by stride must give back a packed layout (transposes qualify, stride-0
+    // broadcasts and strided slices do not); then index 0 is the lowest address.
+    std::vector<std::pair<int, int>> dims;
+    for (std::size_t i = 0; i < shape.size(); ++i) {
+        if (shape[i] != 1) dims.emplace_back(strides[i], shape[i]);
+    }
+    std::sort(dims.begin(), dims.end());
+    int expected = 1;
+    for (const auto& d : dims) {
+        if (d.first != expected) return false;
+        expected *= d.second;
+    }
+    return true;
+}
+
 float& Tensor::at(const std::vector<int>& index) {
     assert(index.size() == shape.size());
 #ifdef USE_CUDA
@@ -57,7 +465,7 @@ float& Tensor::at(const std::vector<int>& index) {
         assert(index[i] >= 0 && index[i] < shape[i]);
         local += index[i] * strides[i];
     }
-    return cpuData[local];
+    return data()[local];
 }
 
 void Tensor::edit(const std::vector<int>& index, float val) {
@@ -70,12 +478,161 @@ void Tensor::edit(const std::vector<int>& index, float val) {
         assert(index[i] >= 0 && index[i] < shape[i]);
         local += index[i] * strides[i];
     }
-    cpuData[local] = val;
+    data()[local] = val;
 #ifdef USE_CUDA
     if (device == Device::GPU) copyGpu();
 #endif
 }
 
+float* Tensor::data() {
+    requireDType(dtype, DType::FP32, "data()");
+    return storage ? storage->data() + offset : nullptr;
+}
+
+const float* Tensor::data() const {
+    requireDType(dtype, DType::FP32, "data()");
+    return storage ? storage->data() + offset : nullptr;
+}
+
+const void* Tensor::rawData() const {
+    return storage ? reinterpret_cast<const char*>(storage->data()) + (size_t)offset * dtypeSize(dtype) : nullptr;
+}
+
+int8_t* Tensor::dataInt8() {
+    requireDType(dtype, DType::INT8, "dataInt8()");
+    return static_cast<int8_t*>(const_cast<void*>(rawData()));
+}
+
+const int8_t* Tensor::dataInt8() const {
+    requireDType(dtype, DType::INT8, "dataInt8()");
+    return static_cast<const int8_t*>(rawData());
+}
+
+uint16_t* Tensor::dataHalf() {
+    requireDType(dtype, DType::FP16, "dataHalf()");
+    return static_cast<uint16_t*>(const_cast<void*>(rawData()));
+}
+
+const uint16_t* Tensor::dataHalf() const {
+    requireDType(dtype, DType::FP16, "dataHalf()");
+    return static_cast<const uint16_t*>(rawData());
+}
+
+DType Tensor::getDType() const {
+    return dtype;
+}
+
+const QuantParams& Tensor::getQuantParams() const {
+    static const QuantParams kNone;
+    return quant ? *quant : kNone;
+}
+
+Tensor Tensor::withDType(const std::vector<int>& shape_, DType dtype_, const QuantParams& params) {
+    Tensor t;
+    t.shape = shape_;
+    t.totalSize = std::accumulate(t.shape.begin(), t.shape.end(), 1, std::multiplies<int>());
+    t.computeStrides();
+    t.storage = Storage::allocate(storageFloats(t.totalSize, dtype_));
+    t.dtype = dtype_;
+    if (dtype_ == DType::INT8) {
+        assert(!params.empty());
+        assert(params.isPerChannel() ? params.axis < (int)shape_.size() && params.channels() == shape_[params.axis]
+                                     : params.channels() == 1);
+        t.quant = std::make_shared<const QuantParams>(params);
+    }
+
+    LOG_TENSOR_OP("CREATE", "CPU", t.shape, true, dtypeName(dtype_));
+    return t;
+}
+
+Tensor Tensor::toDType(DType target, const QuantParams& params) const {
+    assert(device == Device::CPU);
+    if (target == dtype && (target != DType::INT8 || params.empty() ||
+                            (params.scale == quant->scale && params.zeroPoint == quant->zeroPoint && params.axis == quant->axis))) {
+        return toContiguous();
+    }
+    if (dtype != DType::FP32 && target != DType::FP32) return toDType(DType::FP32).toDType(target, params); // e.g. requantize
+
+    Tensor out;
+    if (dtype == DType::FP32) {
+        const Tensor src = toContiguous();
+        out = withDType(shape, target, target == DType::INT8 && params.empty() ? src.calibrate() : params);
+        const float* s = src.data();
+        if (target == DType::FP16) {
+            uint16_t* h = out.dataHalf();
+            parallelElementwise(totalSize, [=](int i, int n) { quant::toHalf(s + i, h + i, n); });
+        } else {
+            int8_t* q = out.dataInt8();
+            forEachQuantRun(shape, *out.quant, [=](int i, int n, float scale, int zeroPoint) {
+                quant::quantize(s + i, q + i, n, scale, zeroPoint);
+            });
+        }
+    } else {
+        const Tensor src = toContiguous();
+        out = empty(shape);
+        float* d = out.data();
+        if (dtype == DType::FP16) {
+            const uint16_t* h = src.dataHalf();
+            parallelElementwise(totalSize, [=](int i, int n) { quant::fromHalf(h + i, d + i, n); });
+        } else {
+            const int8_t* q = src.dataInt8();
+            forEachQuantRun(shape, *quant, [=](int i, int n, float scale, int zeroPoint) {
+                quant::dequantize(q + i, d + i, n, scale, zeroPoint);
+            });
+        }
+    }
+    out.format = format;
+    out.blockedChannels = blockedChannels;
+
+    LOG_TENSOR_OP("TO_DTYPE", "CPU", out.shape, true, std::string(dtypeName(dtype)) + " -> " + dtypeName(target));
+    return out;
+}
+
+QuantParams Tensor::calibrate(int axis) const {
+    assert(device == Device::CPU && axis < (int)shape.size());
+    const Tensor src = toContiguous();
+    int outer, channels, inner;
+    quantSplit(shape, axis, outer, channels, inner);
+
+    std::vector<float> lo(channels, 0.0f), hi(channels, 0.0f); // the range always covers 0
+    const float* d = src.data();
+    for (int p = 0; p < outer * channels; ++p) quant::minMax(d + (size_t)p * inner, inner, lo[p % channels], hi[p % channels]);
+
+    std::vector<float> scale(channels);
+    std::vector<int> zeroPoint(channels);
+    for (int c = 0; c < channels; ++c) quant::chooseParams(lo[c], hi[c], scale[c], zeroPoint[c]);
+    if (axis < 0) return QuantParams::perTensor(scale[0], zeroPoint[0]);
+    return QuantParams::perChannel(std::move(scale), std::move(zeroPoint), axis);
+}
+
+int Tensor::getOffset() const {
+    return offset;
+}
+
+const std::vector<int>& Tensor::getStrides() const {
+    return strides;
+}
+
+bool Tensor::sharesStorage() const {
+    return storage && (storage->isExternal() || storage.use_count() > 1);
+}
+
+const std::vector<int>& Tensor::getShape() const {
+    return shape;
+}
+
+int Tensor::size() const {
+    return totalSize;
+}
+
+bool Tensor::isContiguous() const {
+    return contiguous;
+}
+
+Device Tensor::getDevice() const {
+    return device;
+}
+
 void Tensor::printShape() {
     std::cout << "Tensor shape: [";
     for (size_t i = 0; i < shape.size(); ++i) {
@@ -89,23 +646,27 @@ void Tensor::printData() {
 #ifdef USE_CUDA
     if (device == Device::GPU) copyCpu();
 #endif
+    const Tensor packed = toContiguous();
+    const float* d = packed.data();
     std::cout << "Tensor data: [";
-    for (size_t i = 0; i < cpuData.size(); ++i) {
-        std::cout << cpuData[i];
-        if (i != cpuData.size() - 1) std::cout << ", ";
+    for (int i = 0; i < totalSize; ++i) {
+        std::cout << d[i];
+        if (i != totalSize - 1) std::cout << ", ";
     }
     std::cout << "]" << std::endl;
 }
 
 void Tensor::printImageTensor() {
-    assert(shape.size() == 4);
+    assert(isImageShaped());
 #ifdef USE_CUDA
     if (device == Device::GPU) copyCpu();
 #endif
-    int N = shape[0];
-    int C = shape[1];
-    int H = shape[2];
-    int W = shape[3];
+    const std::vector<int> nchw = getLogicalShape();
+    int N = nchw[0];
+    int C = nchw[1];
+    int H = nchw[2];
+    int W = nchw[3];
+    const float* d = data();
 
     for (int n = 0; n < N; ++n) {
         std::cout << "Batch " << n << ":\n";
@@ -113,7 +674,7 @@ void Tensor::printImageTensor() {
             std::cout << " Channel " << c << ":\n";
             for (int h = 0; h < H; ++h) {
                 for (int w = 0; w < W; ++w) {
-                    std::cout << cpuData[n * strides[0] + c * strides[1] + h * strides[2] + w * strides[3]] << " ";
+                    std::cout << d[elementOffset(n, c, h, w)] << " ";
                 }
                 std::cout << "\n";
             }
@@ -128,15 +689,26 @@ void Tensor::reshape(const std::vector<int>& shape_) {
 
     int newSize = std::accumulate(shape_.begin(), shape_.end(), 1, std::multiplies<int>());
     assert(totalSize == newSize);
+    if (quant && quant->isPerChannel()) { // the channel dim must survive as a dim of its own
+        int before = 1, newBefore = 1, axis = 0;
+        for (int d = 0; d < quant->axis; ++d) before *= shape[d];
+        while (axis < (int)shape_.size() && (newBefore < before || shape_[axis] != quant->channels())) newBefore *= shape_[axis++];
+        assert(axis < (int)shape_.size() && newBefore == before);
+        if (axis != quant->axis) quant = remapChannels(*quant, axis, quant->channels(), 0, 1);
+    }
     shape = shape_;
     computeStrides();
+    format = MemoryFormat::NCHW;
 }
 
 void Tensor::flatten() {
     if (!contiguous) makeContiguous();
+    assert(!quant || !quant->isPerChannel() || quant->channels() == totalSize);
+    if (quant && quant->isPerChannel()) quant = remapChannels(*quant, 0, quant->channels(), 0, 1);
 
     shape = {totalSize};
     strides = {1};
+    format = MemoryFormat::NCHW;
 }
 
 void Tensor::transpose(const std::vector<int>& order) {
@@ -156,49 +728,34 @@ void Tensor::transpose(const std::vector<int>& order) {
 
     shape = newShape;
     strides = newStrides;
-    contiguous = false;
+    contiguous = hasContiguousStrides(); // identity (or size-1-only) permutations stay packed
+    format = MemoryFormat::NCHW;
+    if (quant && quant->isPerChannel()) {
+        const int axis = (int)(std::find(order.begin(), order.end(), quant->axis) - order.begin());
+        if (axis != quant->axis) quant = remapChannels(*quant, axis, quant->channels(), 0, 1);
+    }
 }
 
-Tensor Tensor::broadcast(const std::vector<int>& newShape) {
+Tensor Tensor::broadcast(const std::vector<int>& newShape) const {
     assert(newShape.size() >= shape.size());
 
-    for (int i = 0; i < (int)shape.size(); ++i) {
-        int dim = shape[shape.size() - 1 - i];
-        int newDim = newShape[newShape.size() - 1 - i];
+    // Broadcast dims get stride 0, so every output index along them reads the same element
+    Tensor result = view();
+    const int lead = (int)newShape.size() - (int)shape.size();
+    result.shape = newShape;
+    result.strides.assign(newShape.size(), 0);
+    for (int j = 0; j < (int)shape.size(); ++j) {
+        int dim = shape[j];
+        int newDim = newShape[lead + j];
         assert(newDim == dim || dim == 1); // check if shape is broadcastable
+        result.strides[lead + j] = (dim == 1) ? 0 : strides[j];
     }
-
-    // Ensure contiguous layout before broadcasting
-    if (!contiguous) makeContiguous();
-
-    Tensor result(newShape, device);
-
-    // Compute contiguous strides for the source tensor
-    std::vector<int> mult(shape.size(), 0);
-    if (!shape.empty()) {
-        mult[shape.size() - 1] = 1;
-        for (int i = (int)shape.size() - 2; i >= 0; --i) {
-            mult[i] = mult[i + 1] * shape[i + 1];
-        }
-    }
-
-    std::vector<int> index(newShape.size(), 0);
-    for (int i = 0; i < result.totalSize; ++i) {
-        int lin = 0;
-        for (int j = 0; j < (int)shape.size(); ++j) {
-            int target = (int)newShape.size() - (int)shape.size() + j;
-            int idx = (shape[j] == 1) ? 0 : index[target];
-            lin += idx * mult[j];
-        }
-
-        result.cpuData[i] = cpuData[lin];
-
-        // Advance index in the OUTPUT (newShape) space — was previously wrong (used shape[j])
-        for (int j = (int)newShape.size() - 1; j >= 0; --j) {
-            index[j]++;
-            if (index[j] < newShape[j]) break;
-            index[j] = 0;
-        }
+    result.totalSize = std::accumulate(newShape.begin(), newShape.end(), 1, std::multiplies<int>());
+    result.contiguous = result.hasContiguousStrides();
+    result.format = MemoryFormat::NCHW;
+    if (quant && quant->isPerChannel()) { // a single channel stretched along its axis repeats its params
+        const int axis = lead + quant->axis;
+        result.quant = remapChannels(*quant, axis, newShape[axis], 0, shape[quant->axis] == 1 ? 0 : 1);
     }
 
     return result;
@@ -219,179 +776,394 @@ void Tensor::makeContiguous() {
 void Tensor::makeContiguousCpu() {
     if (contiguous) return;
 
-    std::vector<float> newData(totalSize);
-
-    std::vector<int> index(shape.size(), 0);
-    for (int i = 0; i < totalSize; ++i) {
-        int linIdx = 0;
-        for (int j = 0; j < shape.size(); ++j) { // allows for multi dimensional work!!
-            linIdx += index[j] * strides[j];
-        }
+    // The packed copy gets fresh storage; the source (and any other views of it) is left untouched
+    std::shared_ptr<Storage> packed = Storage::allocate(storageFloats(totalSize, dtype), nullptr, false);
+    if (totalSize > 0) packAs(dtype, rawData(), shape, strides, packed->data());
 
-        newData[i] = cpuData[linIdx];
+    storage = std::move(packed);
+    offset = 0;
+    contiguous = true;
+    computeStrides();
+}
 
-        for (int j = shape.size() - 1; j >= 0; --j) {
-            index[j]++;
-            if (index[j] < shape[j]) break;
-            index[j] = 0;
-        }
+bool Tensor::repeatsElements() const {
+    for (size_t i = 0; i < shape.size(); ++i) {
+        if (strides[i] == 0 && shape[i] > 1) return true;
     }
+    return false;
+}
 
-    cpuData = newData;
-    contiguous = true;
-    computeStrides();
+template <typename Kernel>
+void Tensor::unaryCpu(Kernel kernel) {
+    if (repeatsElements()) makeContiguousCpu(); // one element per result: broadcast views get their own copy
+    float* d = data();
+    if (isDense()) parallelElementwise(totalSize, [&](int i, int n) { kernel(d + i, n); });
+    else strided::unary(shape, d, strides, kernel); // slices write through to the shared storage
 }
 
 
 void Tensor::fillCpu(float val) {
-    std::fill(cpuData.begin(), cpuData.end(), val);
+    unaryCpu([=](float* x, int n) { std::fill(x, x + n, val); });
 }
 
 void Tensor::addTensorCpu(const Tensor &other) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] += other.cpuData[i];
-    }
+    binaryCpu(other, strided::BinaryOp::Add);
 }
 
 void Tensor::addScalarCpu(const float val) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] += val;
-    }
+    unaryCpu([=](float* x, int n) { kernels::addScalar(x, n, val); });
 }
 
 void Tensor::addBiasCpu(const Tensor &bias) {
-    int N = shape[0], C = shape[1], H = shape[2], W = shape[3];
-    for (int n = 0; n < N; ++n) {
-        for (int c = 0; c < C; ++c) {
-            float b = bias.cpuData[c];
-            for (int h = 0; h < H; ++h) {
-                for (int w = 0; w < W; ++w) {
-                    int idx = n * strides[0] + c * strides[1] + h * strides[2] + w * strides[3];
-                    cpuData[idx] += b;
-                }
-            }
-        }
-    }
+    channelAffineCpu(nullptr, &bias, 1);
 }
 
 void Tensor::subtractTensorCpu(const Tensor &other) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] -= other.cpuData[i];
-    }
+    binaryCpu(other, strided::BinaryOp::Sub);
 }
 
 void Tensor::subtractScalarCpu(const float val) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] -= val;
-    }
+    unaryCpu([=](float* x, int n) { kernels::subScalar(x, n, val); });
 }
 
 void Tensor::multiplyTensorCpu(const Tensor &other) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] *= other.cpuData[i];
-    }
+    binaryCpu(other, strided::BinaryOp::Mul);
 }
 
 void Tensor::multiplyScalarCpu(const float val) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] *= val;
-    }
+    unaryCpu([=](float* x, int n) { kernels::mulScalar(x, n, val); });
 }
 
 void Tensor::multiplyBiasCpu(const Tensor &bias) {
-    int N = shape[0], C = shape[1], H = shape[2], W = shape[3];
-    for (int n = 0; n < N; ++n) {
-        for (int c = 0; c < C; ++c) {
-            float b = bias.cpuData[c];
-            for (int h = 0; h < H; ++h) {
-                for (int w = 0; w < W; ++w) {
-                    int idx = n * strides[0] + c * strides[1] + h * strides[2] + w * strides[3];
-                    cpuData[idx] *= b;
-                }
-            }
+    channelAffineCpu(&bias, nullptr, 1);
+}
+
+void Tensor::channelAffineCpu(const Tensor* scale, const Tensor* shift, int axis) {
+    float* d = data();
+    const float* sd = scale ? scale->data() : nullptr;
+    const float* bd = shift ? shift->data() : nullptr;
+    const int sStride = scale ? scale->strides[0] : 0;
+    const int bStride = shift ? shift->strides[0] : 0;
+
+    if (contiguous) { // packed: the values expanded to the element pattern
+        MemoryFormat patternFormat = format;
+        int channels, plane;
+        if (format != MemoryFormat::NCHW) {
+            const std::vector<int> nchw = getLogicalShape();
+            channels = nchw[1];
+            plane = nchw[2] * nchw[3];
+        } else {
+            channels = shape[axis];
+            plane = 1;
+            for (size_t i = axis + 1; i < shape.size(); ++i) plane *= shape[i];
+            if (plane == 1) patternFormat = MemoryFormat::NHWC; // channel-last rows repeat one lane pattern
+        }
+        if (sd && bd) {
+            const layout::ChannelPattern scales(sd, sStride, patternFormat, channels, plane, 1.0f);
+            const layout::ChannelPattern shifts(bd, bStride, patternFormat, channels, plane, 0.0f);
+            parallelElementwise(totalSize, [&](int i, int n) { scales.applyAffine(d + i, i, n, shifts); });
+        } else {
+            const layout::ChannelPattern values(sd ? sd : bd, sd ? sStride : bStride, patternFormat, channels, plane,
+                                                sd ? 1.0f : 0.0f);
+            const layout::ChannelOp op = sd ? layout::ChannelOp::Mul : layout::ChannelOp::Add;
+            parallelElementwise(totalSize, [&](int i, int n) { values.apply(d + i, i, n, op); });
+        }
+        return;
+    }
+
+    // Strided view: walk the index space with the last dim as the tight loop. The channel is
+    // the last dim for NHWC and block * c-block + lane for blocked views, whose padding lanes stay.
+    const int dims = (int)shape.size();
+    const int inner = shape[dims - 1], innerStride = strides[dims - 1];
+    const int block = channelBlock(format);
+    const int channelDim = format == MemoryFormat::NHWC ? 3 : axis;
+    const int channels = format == MemoryFormat::NCHW ? shape[axis] : getChannels();
+    std::vector<int> index(dims, 0);
+    for (;;) {
+        int base = 0;
+        for (int j = 0; j < dims - 1; ++j) base += index[j] * strides[j];
+        float* x = d + base;
+        for (int i = 0; i < inner; ++i) {
+            const int c = block > 1 ? index[1] * block + i : channelDim == dims - 1 ? i : index[channelDim];
+            if (c >= channels) continue;
+            float v = x[i * innerStride];
+            if (sd) v *= sd[c * sStride];
+            if (bd) v += bd[c * bStride];
+            x[i * innerStride] = v;
+        }
+
+        int j = dims - 2;
+        for (; j >= 0; --j) {
+            if (++index[j] < shape[j]) break;
+            index[j] = 0;
         }
+        if (j < 0) return;
     }
 }
 
 void Tensor::divideTensorCpu(const Tensor &other) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] /= other.cpuData[i];
-    }
+    binaryCpu(other, strided::BinaryOp::Div);
 }
 
 void Tensor::divideScalarCpu(const float val) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] /= val;
-    }
+    unaryCpu([=](float* x, int n) { kernels::divScalar(x, n, val); });
+}
+
+void Tensor::binaryCpu(const Tensor& other, strided::BinaryOp op) {
+    assert(broadcastShape(shape, other.shape) == shape); // other stretches to this shape, never the reverse
+    assert((format == MemoryFormat::NCHW && other.format == MemoryFormat::NCHW) ||
+           (shape == other.shape && format == other.format)); // packed formats pair up element for element
+
+    // Results are written through this tensor's strides, unless it repeats elements (a broadcast view)
+    if (repeatsElements()) makeContiguousCpu();
+    // An operand reading this storage through another mapping would see half-updated values
+    const bool aliased = storage && other.storage == storage && (other.offset != offset || other.strides != strides);
+    const Tensor operand = aliased ? other.clone().broadcast(shape) : other.broadcast(shape);
+    strided::binary(op, shape, data(), strides, data(), strides, operand.data(), operand.strides);
 }
 
 void Tensor::negateCpu() { // bitwise hacking not allowed
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = -cpuData[i];
-    }
+    unaryCpu([=](float* x, int n) { kernels::negate(x, n); });
 }
 
 void Tensor::ReLUCpu() {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = fmaxf(cpuData[i], 0.0f);
-    }
+    unaryCpu([=](float* x, int n) { kernels::relu(x, n); });
 }
 
 void Tensor::sigmoidCpu() {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = 1.0f / (1.0f + expf(-cpuData[i]));
-    }
+    unaryCpu([=](float* x, int n) { kernels::sigmoid(x, n); });
 }
 
 void Tensor::tanhCpu() {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = tanhf(cpuData[i]);
-    }
+    unaryCpu([=](float* x, int n) { kernels::tanh(x, n); });
 }
 
 void Tensor::LReLUCpu(const float alpha) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = cpuData[i] < 0 ? alpha * cpuData[i] : cpuData[i];
-    }
+    unaryCpu([=](float* x, int n) { kernels::lrelu(x, n, alpha); });
 }
 
 void Tensor::ELUCpu(const float alpha) {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = cpuData[i] < 0 ? alpha * (expf(cpuData[i]) - 1) : cpuData[i];
-    }
+    unaryCpu([=](float* x, int n) { kernels::elu(x, n, alpha); });
 }
 
 void Tensor::squareCpu() {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = cpuData[i] * cpuData[i];
-    }
+    unaryCpu([=](float* x, int n) { kernels::square(x, n); });
 }
 
 void Tensor::sqrtCpu() {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = sqrtf(cpuData[i]);
-    }
+    unaryCpu([=](float* x, int n) { kernels::sqrt(x, n); });
 }
 
 void Tensor::expCpu() {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = expf(cpuData[i]);
-    }
+    unaryCpu([=](float* x, int n) { kernels::exp(x, n); });
 }
 
 void Tensor::logCpu() {
-    for (std::size_t i = 0; i < cpuData.size(); ++i) {
-        cpuData[i] = logf(cpuData[i]);
+    unaryCpu([=](float* x, int n) { kernels::log(x, n); });
+}
+
+template <typename Kernel>
+void Tensor::int8Cpu(Kernel kernel) {
+    if (repeatsElements()) makeContiguousCpu(); // broadcast views get their own copy, like the float ops
+    if (contiguous) {
+        kernel(*this);
+        return;
     }
+    Tensor packed = toContiguous(); // strided view: run on a packed copy and write the results back
+    kernel(packed);
+    strided::scatter(packed.dataInt8(), shape, strides, dataInt8());
+}
+
+// In place with this tensor's params as the output params, like the float ops
+void Tensor::addTensorInt8(const Tensor& other) {
+    assert(other.dtype == DType::INT8 && other.shape == shape && contiguous);
+    assert(!quant->isPerChannel() && !other.quant->isPerChannel());
+    const float scaleA = quant->scale[0], scaleB = other.quant->scale[0];
+    const int zeroA = quant->zeroPoint[0], zeroB = other.quant->zeroPoint[0];
+    const Tensor operand = other.toContiguous();
+    int8_t* a = dataInt8();
+    const int8_t* b = operand.dataInt8();
+    parallelElementwise(totalSize, [=](int i, int n) {
+        quant::add(a + i, b + i, n, scaleA, zeroA, scaleB, zeroB, scaleA, zeroA);
+    });
+}
+
+// The FP32 bias is rounded to whole quantization steps of its channel and added with saturation
+void Tensor::addBiasInt8(const Tensor& bias) {
+    assert(bias.dtype == DType::FP32 && contiguous && format == MemoryFormat::NCHW);
+    assert(!quant->isPerChannel() || quant->axis == 1);
+    const int C = shape[1], HW = shape[2] * shape[3];
+    const Tensor b = bias.toContiguous();
+    std::vector<int> offsets(C);
+    for (int c = 0; c < C; ++c) {
+        const long steps = std::lround(b.data()[c] / quant->scale[quant->isPerChannel() ? c : 0]);
+        offsets[c] = (int)std::max(-255L, std::min(255L, steps));
+    }
+    int8_t* d = dataInt8();
+    ThreadPool::getInstance().parallelFor(0, shape[0] * C, std::max(1, kDefaultGrainSize / std::max(1, HW)), [&](int begin, int end) {
+        for (int p = begin; p < end; ++p) quant::addOffset(d + (size_t)p * HW, HW, offsets[p % C]);
+    });
+}
+
+void Tensor::ReLUInt8() {
+    assert(contiguous);
+    int8_t* d = dataInt8();
+    forEachQuantRun(shape, *quant, [=](int i, int n, float, int zeroPoint) { quant::relu(d + i, n, zeroPoint); });
 }
 
 void Tensor::zeroGradCpu() {
-    std::fill(cpuGrad.begin(), cpuGrad.end(), 0.0f);
+    std::fill(cpuGrad.begin(), cpuGrad.end(), 0.0f); // empty when no gradient was ever requested
+}
+
+
+TensorExpr Tensor::expr() {
+    return TensorExpr(*this);
+}
+
+Tensor Tensor::matmul(const Tensor& other) const {
+    assert(device == Device::CPU && other.device == Device::CPU);
+    const size_t ra = shape.size(), rb = other.shape.size();
+    assert(ra >= 2 && rb >= 2);
+    const int M = shape[ra - 2], K = shape[ra - 1], N = other.shape[rb - 1];
+    assert(other.shape[rb - 2] == K);
+    if (ra > 2 && rb > 2) {
+        assert(std::equal(shape.begin(), shape.end() - 2, other.shape.begin(), other.shape.end() - 2));
+    }
+
+    std::vector<int> outShape(ra > 2 ? shape.begin() : other.shape.begin(), ra > 2 ? shape.end() - 2 : other.shape.end() - 2);
+    const int batches = std::accumulate(outShape.begin(), outShape.end(), 1, std::multiplies<int>());
+    outShape.push_back(M);
+    outShape.push_back(N);
+    Tensor result = K > 0 ? empty(outShape) : Tensor(outShape); // sgemm overwrites C
+
+    // Operands whose trailing matrix is neither row- nor column-major get packed once
+    bool transA, transB;
+    int lda, ldb;
+    Tensor packedA, packedB;
+    const Tensor* a = this;
+    const Tensor* b = &other;
+    if (!gemmLayout(shape, strides, transA, lda)) {
+        packedA = toContiguous();
+        a = &packedA;
+        gemmLayout(a->shape, a->strides, transA, lda);
+    }
+    if (!gemmLayout(other.shape, other.strides, transB, ldb)) {
+        packedB = other.toContiguous();
+        b = &packedB;
+        gemmLayout(b->shape, b->strides, transB, ldb);
+    }
+
+    // Many small products run one per task; a single large one threads inside sgemm instead
+    const long macs = std::max(1L, (long)M * N * K);
+    float* out = result.data();
+    ThreadPool::getInstance().parallelFor(0, batches, (int)std::max(1L, (1L << 18) / macs), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const float* pa = a->data() + (ra > 2 ? batchOffset(a->shape, a->strides, i) : 0);
+            const float* pb = b->data() + (rb > 2 ? batchOffset(b->shape, b->strides, i) : 0);
+            sgemm(transA, transB, M, N, K, pa, lda, pb, ldb, out + (size_t)i * M * N, N);
+        }
+    });
+
+    LOG_TENSOR_OP("MATMUL", "CPU", outShape, true, "");
+    return result;
+}
+
+Tensor Tensor::reductionInput(int& axis, int& outer, int& n, int& inner) const {
+    assert(device == Device::CPU);
+    Tensor src = format == MemoryFormat::NCHW ? toContiguous() : toMemoryFormat(MemoryFormat::NCHW);
+    const int rank = (int)src.shape.size();
+    if (axis < 0) axis += rank;
+    assert(axis >= 0 && axis < rank);
+    outer = std::accumulate(src.shape.begin(), src.shape.begin() + axis, 1, std::multiplies<int>());
+    n = src.shape[axis];
+    inner = std::accumulate(src.shape.begin() + axis + 1, src.shape.end(), 1, std::multiplies<int>());
+    assert(n > 0);
+    return src;
+}
+
+std::vector<int> Tensor::reducedShape(std::vector<int> shape, int axis, bool keepDims, int size) {
+    if (keepDims || size != 1) shape[axis] = size;
+    else shape.erase(shape.begin() + axis);
+    if (shape.empty()) shape.push_back(1);
+    return shape;
+}
+
+Tensor Tensor::sum(int axis, bool keepDims, reduce::Summation mode) const {
+    int outer, n, inner;
+    const Tensor src = reductionInput(axis, outer, n, inner);
+    Tensor result = empty(reducedShape(src.shape, axis, keepDims));
+    reduce::sum(src.data(), outer, n, inner, result.data(), mode);
+    LOG_TENSOR_OP("SUM", "CPU", result.shape, true, "axis " + std::to_string(axis));
+    return result;
 }
 
+Tensor Tensor::mean(int axis, bool keepDims, reduce::Summation mode) const {
+    int outer, n, inner;
+    const Tensor src = reductionInput(axis, outer, n, inner);
+    Tensor result = empty(reducedShape(src.shape, axis, keepDims));
+    reduce::sum(src.data(), outer, n, inner, result.data(), mode);
+    result.divideScalarCpu((float)n);
+    LOG_TENSOR_OP("MEAN", "CPU", result.shape, true, "axis " + std::to_string(axis));
+    return result;
+}
+
+Tensor Tensor::max(int axis, bool keepDims) const {
+    int outer, n, inner;
+    const Tensor src = reductionInput(axis, outer, n, inner);
+    Tensor result = empty(reducedShape(src.shape, axis, keepDims));
+    reduce::max(src.data(), outer, n, inner, result.data());
+    LOG_TENSOR_OP("MAX", "CPU", result.shape, true, "axis " + std::to_string(axis));
+    return result;
+}
+
+Tensor Tensor::argmax(int axis, bool keepDims) const {
+    int outer, n, inner;
+    const Tensor src = reductionInput(axis, outer, n, inner);
+    Tensor result = empty(reducedShape(src.shape, axis, keepDims));
+    reduce::argmax(src.data(), outer, n, inner, result.data());
+    LOG_TENSOR_OP("ARGMAX", "CPU", result.shape, true, "axis " + std::to_string(axis));
+    return result;
+}
+
+Tensor Tensor::logSumExp(int axis, bool keepDims) const {
+    int outer, n, inner;
+    const Tensor src = reductionInput(axis, outer, n, inner);
+    Tensor result = empty(reducedShape(src.shape, axis, keepDims));
+    reduce::logSumExp(src.data(), outer, n, inner, result.data());
+    LOG_TENSOR_OP("LOGSUMEXP", "CPU", result.shape, true, "axis " + std::to_string(axis));
+    return result;
+}
+
+void Tensor::topK(int k, int axis, Tensor& values, Tensor& indices) const {
+    int outer, n, inner;
+    const Tensor src = reductionInput(axis, outer, n, inner);
+    assert(k > 0 && k <= n);
+    values = Tensor(reducedShape(src.shape, axis, true, k));
+    indices = Tensor(values.shape);
+    reduce::topK(src.data(), outer, n, inner, k, values.data(), indices.data());
+    LOG_TENSOR_OP("TOPK", "CPU", values.shape, true, "k " + std::to_string(k) + ", axis " + std::to_string(axis));
+}
+
+Tensor Tensor::softmax(int axis) const {
+    int outer, n, inner;
+    Tensor result = reductionInput(axis, outer, n, inner);
+    if (result.storage == storage) result = result.clone(); // a view of this tensor, not a fresh copy
+    reduce::softmax(result.data(), outer, n, inner);
+    LOG_TENSOR_OP("SOFTMAX", "CPU", result.shape, true, "axis " + std::to_string(axis));
+    return result;
+}
+
+Tensor Tensor::logSoftmax(int axis) const {
+    int outer, n, inner;
+    Tensor result = reductionInput(axis, outer, n, inner);
+    if (result.storage == storage) result = result.clone();
+    reduce::logSoftmax(result.data(), outer, n, inner);
+    LOG_TENSOR_OP("LOG_SOFTMAX", "CPU", result.shape, true, "axis " + std::to_string(axis));
+    return result;
+}
 
 void Tensor::fill(const float val) {
-    std::string deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
+    const char* deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
     LOG_DEBUG("Filling tensor with value: " + std::to_string(val));
 
     if (device == Device::CPU) {
@@ -407,14 +1179,15 @@ void Tensor::fill(const float val) {
 }
 
 void Tensor::addTensor(const Tensor& other) {
-    assert(shape == other.shape);
-    std::string deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
+    const char* deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
 
     if (device == Device::CPU) {
-        addTensorCpu(other);
+        if (dtype == DType::INT8) int8Cpu([&](Tensor& t) { t.addTensorInt8(other); });
+        else addTensorCpu(other);
     }
 #ifdef USE_CUDA
     else {
+        assert(shape == other.shape);
         addTensorGpu(other);
     }
 #endif
@@ -434,18 +1207,24 @@ void Tensor::addScalar(const float val) {
 }
 
 void Tensor::addBias(const Tensor& bias) {
-    assert(shape.size() == 4); // image channeled bias
+    assert(isImageShaped()); // image channeled bias
     assert(bias.shape.size() == 1); // bias application
-    assert(shape[1] == bias.shape[0]); // bias can be properly added
+    assert(getChannels() == bias.shape[0]); // bias can be properly added
 
-    std::string deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
-    LOG_DEBUG("Adding bias to tensor with shape " + std::to_string(shape[1]) + " channels");
+    const char* deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
+    LOG_DEBUG("Adding bias to tensor with shape " + std::to_string(getChannels()) + " channels");
 
     if (device == Device::CPU) {
-        addBiasCpu(bias);
+        if (dtype == DType::INT8) {
+            int8Cpu([&](Tensor& t) { t.addBiasInt8(bias); });
+        } else {
+            if (repeatsElements()) makeContiguousCpu();
+            addBiasCpu(bias);
+        }
     }
 #ifdef USE_CUDA
     else {
+        assert(format == MemoryFormat::NCHW); // the CUDA kernels index NCHW planes
         addBiasGpu(bias);
     }
 #endif
@@ -454,12 +1233,12 @@ void Tensor::addBias(const Tensor& bias) {
 }
 
 void Tensor::subtractTensor(const Tensor& other) {
-    assert(shape == other.shape);
     if (device == Device::CPU) {
         subtractTensorCpu(other);
     }
 #ifdef USE_CUDA
     else {
+        assert(shape == other.shape);
         subtractTensorGpu(other);
     }
 #endif
@@ -477,12 +1256,12 @@ void Tensor::subtractScalar(const float val) {
 }
 
 void Tensor::multiplyTensor(const Tensor& other) {
-    assert(shape == other.shape);
     if (device == Device::CPU) {
         multiplyTensorCpu(other);
     }
 #ifdef USE_CUDA
     else {
+        assert(shape == other.shape);
         multiplyTensorGpu(other);
     }
 #endif
@@ -500,26 +1279,51 @@ void Tensor::multiplyScalar(const float val) {
 }
 
 void Tensor::multiplyBias(const Tensor& bias) { // image only
-    assert(shape.size() == 4);
+    assert(isImageShaped());
     assert(bias.shape.size() == 1);
-    assert(shape[1] == bias.shape[0]);
+    assert(getChannels() == bias.shape[0]);
     if (device == Device::CPU) {
+        if (repeatsElements()) makeContiguousCpu();
         multiplyBiasCpu(bias);
     }
 #ifdef USE_CUDA
     else {
+        assert(format == MemoryFormat::NCHW);
         multiplyBiasGpu(bias);
     }
 #endif
 }
 
+void Tensor::channelAffine(const Tensor& scale, const Tensor& shift, int axis) {
+    assert(scale.shape.size() == 1 && shift.shape.size() == 1);
+    assert(axis >= 0 && axis < (int)shape.size());
+    assert(format == MemoryFormat::NCHW || (axis == 1 && isImageShaped())); // logical channels only
+    assert(scale.shape[0] == (format == MemoryFormat::NCHW ? shape[axis] : getChannels()));
+    assert(shift.shape[0] == scale.shape[0]);
+
+    const char* deviceStr = (device == Device::CPU) ? "CPU" : "GPU";
+    if (device == Device::CPU) {
+        if (repeatsElements()) makeContiguousCpu();
+        channelAffineCpu(&scale, &shift, axis);
+    }
+#ifdef USE_CUDA
+    else {
+        assert(format == MemoryFormat::NCHW && axis == 1 && shape.size() == 4); // the CUDA bias kernels index NCHW planes
+        multiplyBiasGpu(scale);
+        addBiasGpu(shift);
+    }
+#endif
+
+    LOG_TENSOR_OP("CHANNEL_AFFINE", deviceStr, shape, true, "axis " + std::to_string(axis));
+}
+
 void Tensor::divideTensor(const Tensor& other) {
-    assert(shape == other.shape);
     if (device == Device::CPU) {
         divideTensorCpu(other);
     }
 #ifdef USE_CUDA
     else {
+        assert(shape == other.shape);
         divideTensorGpu(other);
     }
 #endif
@@ -536,6 +1340,39 @@ void Tensor::divideScalar(const float val) {
 #endif
 }
 
+std::vector<int> Tensor::broadcastShape(const std::vector<int>& a, const std::vector<int>& b) {
+    // Trailing dims line up; each pair must match or have a 1 that stretches to the other
+    std::vector<int> result(std::max(a.size(), b.size()));
+    for (size_t i = 0; i < result.size(); ++i) {
+        const int da = i < a.size() ? a[a.size() - 1 - i] : 1;
+        const int db = i < b.size() ? b[b.size() - 1 - i] : 1;
+        assert(da == db || da == 1 || db == 1);
+        result[result.size() - 1 - i] = da == 1 ? db : da;
+    }
+    return result;
+}
+
+Tensor Tensor::binary(const Tensor& a, const Tensor& b, strided::BinaryOp op, const char* opName) {
+    assert(a.device == Device::CPU && b.device == Device::CPU);
+    assert((a.format == MemoryFormat::NCHW && b.format == MemoryFormat::NCHW) ||
+           (a.shape == b.shape && a.format == b.format));
+
+    const std::vector<int> outShape = broadcastShape(a.shape, b.shape);
+    Tensor result = empty(outShape);
+    result.format = a.format;
+    result.blockedChannels = a.blockedChannels;
+    const Tensor av = a.broadcast(outShape), bv = b.broadcast(outShape);
+    strided::binary(op, outShape, result.data(), result.strides, av.data(), av.strides, bv.data(), bv.strides);
+
+    LOG_TENSOR_OP(opName, "CPU", outShape, true, "");
+    return result;
+}
+
+Tensor Tensor::add(const Tensor& a, const Tensor& b) { return binary(a, b, strided::BinaryOp::Add, "ADD"); }
+Tensor Tensor::subtract(const Tensor& a, const Tensor& b) { return binary(a, b, strided::BinaryOp::Sub, "SUBTRACT"); }
+Tensor Tensor::multiply(const Tensor& a, const Tensor& b) { return binary(a, b, strided::BinaryOp::Mul, "MULTIPLY"); }
+Tensor Tensor::divide(const Tensor& a, const Tensor& b) { return binary(a, b, strided::BinaryOp::Div, "DIVIDE"); }
+
 void Tensor::negate() {
     if (device == Device::CPU) {
         negateCpu();
@@ -549,7 +1386,8 @@ void Tensor::negate() {
 
 void Tensor::ReLU() {
     if (device == Device::CPU) {
-        ReLUCpu();
+        if (dtype == DType::INT8) int8Cpu([](Tensor& t) { t.ReLUInt8(); });
+        else ReLUCpu();
     }
 #ifdef USE_CUDA
     else {
@@ -646,6 +1484,30 @@ void Tensor::log() {
 #endif
 }
 
+void Tensor::setRequiresGrad(bool enabled) {
+    gradEnabled = enabled;
+    if (enabled) return; // allocation waits for the first grad() call
+
+    trackGradient(cpuGrad, false);
+    std::vector<float>().swap(cpuGrad);
+#ifdef USE_CUDA
+    freeGpuGrad();
+#endif
+}
+
+bool Tensor::requiresGrad() const {
+    return gradEnabled;
+}
+
+float* Tensor::grad() {
+    gradEnabled = true;
+    if (cpuGrad.empty() && totalSize > 0) {
+        cpuGrad.assign(totalSize, 0.0f);
+        trackGradient(cpuGrad, true);
+    }
+    return cpuGrad.data();
+}
+
 void Tensor::zeroGrad() {
     if (device == Device::CPU) {
         zeroGradCpu();
@@ -0,0 +1,208 @@
+#include "tensor_expr.hpp"
+#include "kernels.hpp"
+#include "layout.hpp"
+#include "logger.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+
+namespace {
+
+// Elements per fused block: 4 KB of target plus one gathered block per broadcast operand,
+// small enough that every op after the first runs out of L1.
+constexpr int kBlock = 1024;
+
+// Calls run(offset, k, length, step) for the pieces of elements [begin, begin + n) of `t` in
+// row-major logical order: `length` elements from data() + offset, `step` apart, land at block
+// position k. Pieces are whole runs along the last dim.
+template <typename Run>
+void forEachRun(const Tensor& t, int begin, int n, Run run) {
+    const std::vector<int>& shape = t.getShape();
+    const std::vector<int>& strides = t.getStrides();
+    const int dims = (int)shape.size();
+
+    std::vector<int> index(dims, 0);
+    int rem = begin, off = 0;
+    for (int j = dims - 1; j >= 0; --j) {
+        index[j] = rem % shape[j];
+        rem /= shape[j];
+        off += index[j] * strides[j];
+    }
+
+    const int last = dims - 1;
+    for (int k = 0; k < n;) {
+        const int length = std::min(n - k, shape[last] - index[last]);
+        run(off, k, length, strides[last]);
+        k += length;
+        index[last] += length;
+
+        // Carry into the outer dims and rebuild the offset
+        for (int j = last; j > 0 && index[j] == shape[j]; --j) {
+            index[j] = 0;
+            ++index[j - 1];
+        }
+        off = 0;
+        for (int q = 0; q < dims; ++q) off += index[q] * strides[q];
+    }
+}
+
+// Elements [begin, begin + n) of `t` in row-major logical order: a direct pointer when t is
+// contiguous (or the block sits inside one unit-stride row), otherwise gathered through its
+// strides (stride 0 for broadcast dims) into scratch.
+const float* operandBlock(const Tensor& t, int begin, int n, float* scratch) {
+    if (t.isContiguous()) return t.data() + begin;
+
+    const std::vector<int>& shape = t.getShape();
+    const int last = (int)shape.size() - 1;
+    if (t.getStrides()[last] == 1 && n <= shape[last] - begin % shape[last]) {
+        int rem = begin, off = 0;
+        for (int j = last; j >= 0; --j) {
+            off += rem % shape[j] * t.getStrides()[j];
+            rem /= shape[j];
+        }
+        return t.data() + off;
+    }
+
+    const float* src = t.data();
+    forEachRun(t, begin, n, [&](int off, int k, int length, int step) {
+        if (step == 1) {
+            std::copy(src + off, src + off + length, scratch + k);
+        } else if (step == 0) {
+            std::fill(scratch + k, scratch + k + length, src[off]);
+        } else {
+            for (int r = 0; r < length; ++r) scratch[k + r] = src[off + r * step];
+        }
+    });
+    return scratch;
+}
+
+// Writes a block computed in scratch back through the strides of `t` (the inverse of operandBlock)
+void scatterBlock(Tensor& t, int begin, int n, const float* block) {
+    float* dst = t.data();
+    forEachRun(t, begin, n, [&](int off, int k, int length, int step) {
+        for (int r = 0; r < length; ++r) dst[off + r * step] = block[k + r];
+    });
+}
+
+} // namespace
+
+TensorExpr::TensorExpr(Tensor& target) : target(target) {}
+
+TensorExpr& TensorExpr::push(ExprOp op, float scalar, int operand) {
+    nodes.push_back({op, scalar, operand});
+    return *this;
+}
+
+TensorExpr& TensorExpr::pushTensor(ExprOp op, const Tensor& other) {
+    // broadcast() asserts compatibility; for a same-shape operand it is a plain view
+    operands.push_back(other.broadcast(target.getShape()));
+    return push(op, 0.0f, (int)operands.size() - 1);
+}
+
+TensorExpr& TensorExpr::pushBias(ExprOp op, const Tensor& bias) {
+    assert(bias.getShape().size() == 1); // image channeled bias, in any memory format
+    assert(target.getChannels() == bias.getShape()[0]);
+    operands.push_back(bias.view());
+    return push(op, 0.0f, (int)operands.size() - 1);
+}
+
+TensorExpr& TensorExpr::add(float val) { return push(ExprOp::AddScalar, val); }
+TensorExpr& TensorExpr::sub(float val) { return push(ExprOp::SubScalar, val); }
+TensorExpr& TensorExpr::mul(float val) { return push(ExprOp::MulScalar, val); }
+TensorExpr& TensorExpr::div(float val) { return push(ExprOp::DivScalar, val); }
+
+TensorExpr& TensorExpr::add(const Tensor& other) { return pushTensor(ExprOp::AddTensor, other); }
+TensorExpr& TensorExpr::sub(const Tensor& other) { return pushTensor(ExprOp::SubTensor, other); }
+TensorExpr& TensorExpr::mul(const Tensor& other) { return pushTensor(ExprOp::MulTensor, other); }
+TensorExpr& TensorExpr::div(const Tensor& other) { return pushTensor(ExprOp::DivTensor, other); }
+
+TensorExpr& TensorExpr::addBias(const Tensor& bias) { return pushBias(ExprOp::AddBias, bias); }
+TensorExpr& TensorExpr::mulBias(const Tensor& bias) { return pushBias(ExprOp::MulBias, bias); }
+
+TensorExpr& TensorExpr::neg() { return push(ExprOp::Negate); }
+TensorExpr& TensorExpr::relu() { return push(ExprOp::ReLU); }
+TensorExpr& TensorExpr::lrelu(float alpha) { return push(ExprOp::LReLU, alpha); }
+TensorExpr& TensorExpr::elu(float alpha) { return push(ExprOp::ELU, alpha); }
+TensorExpr& TensorExpr::sigmoid() { return push(ExprOp::Sigmoid); }
+TensorExpr& TensorExpr::tanh() { return push(ExprOp::Tanh); }
+TensorExpr& TensorExpr::square() { return push(ExprOp::Square); }
+TensorExpr& TensorExpr::sqrt() { return push(ExprOp::Sqrt); }
+TensorExpr& TensorExpr::exp() { return push(ExprOp::Exp); }
+TensorExpr& TensorExpr::log() { return push(ExprOp::Log); }
+
+Tensor& TensorExpr::eval() {
+    assert(target.getDevice() == Device::CPU);
+    // A strided target (e.g. a narrowed view) is gathered and scattered block by block, so the
+    // results land in its storage; only a broadcast view, which repeats elements, is packed
+    const std::vector<int>& strides = target.getStrides();
+    for (size_t i = 0; i < strides.size(); ++i) {
+        if (strides[i] == 0 && target.getShape()[i] > 1) {
+            target.makeContiguous();
+            break;
+        }
+    }
+
+    const std::vector<int>& shape = target.getShape();
+    const int total = target.size();
+
+    // Bias operands expanded once to the target's per-channel element pattern
+    std::vector<layout::ChannelPattern> patterns;
+    std::vector<int> patternOf(operands.size(), -1);
+    for (const Node& node : nodes) {
+        if (node.op != ExprOp::AddBias && node.op != ExprOp::MulBias) continue;
+        const std::vector<int> nchw = target.getLogicalShape();
+        const Tensor& bias = operands[node.operand];
+        patternOf[node.operand] = (int)patterns.size();
+        patterns.emplace_back(bias.data(), bias.getStrides()[0], target.getMemoryFormat(), nchw[1], nchw[2] * nchw[3],
+                              node.op == ExprOp::MulBias ? 1.0f : 0.0f);
+    }
+
+    // Large tensors are split across the pool; each thread walks its chunk block by block
+    ThreadPool::getInstance().parallelFor(0, total, kDefaultGrainSize, [&](int chunkBegin, int chunkEnd) {
+        static thread_local std::vector<float> scratch;
+        scratch.resize((operands.size() + 1) * kBlock); // the last block stages a strided target
+        float* targetScratch = scratch.data() + operands.size() * kBlock;
+
+        for (int begin = chunkBegin; begin < chunkEnd; begin += kBlock) {
+            const int n = std::min(kBlock, chunkEnd - begin);
+            float* x = const_cast<float*>(operandBlock(target, begin, n, targetScratch));
+
+            for (const Node& node : nodes) {
+                const float s = node.scalar;
+                const Tensor* operand = node.operand >= 0 ? &operands[node.operand] : nullptr;
+                const float* y = nullptr;
+                if (operand != nullptr && node.op != ExprOp::AddBias && node.op != ExprOp::MulBias) {
+                    y = operandBlock(*operand, begin, n, scratch.data() + (size_t)node.operand * kBlock);
+                }
+
+                switch (node.op) {
+                    case ExprOp::AddScalar: kernels::addScalar(x, n, s); break;
+                    case ExprOp::SubScalar: kernels::subScalar(x, n, s); break;
+                    case ExprOp::MulScalar: kernels::mulScalar(x, n, s); break;
+                    case ExprOp::DivScalar: kernels::divScalar(x, n, s); break;
+                    case ExprOp::AddTensor: kernels::add(x, y, n); break;
+                    case ExprOp::SubTensor: kernels::sub(x, y, n); break;
+                    case ExprOp::MulTensor: kernels::mul(x, y, n); break;
+                    case ExprOp::DivTensor: kernels::div(x, y, n); break;
+                    case ExprOp::AddBias: patterns[patternOf[node.operand]].apply(x, begin, n, layout::ChannelOp::Add); break;
+                    case ExprOp::MulBias: patterns[patternOf[node.operand]].apply(x, begin, n, layout::ChannelOp::Mul); break;
+                    case ExprOp::Negate: kernels::negate(x, n); break;
+                    case ExprOp::ReLU: kernels::relu(x, n); break;
+                    case ExprOp::LReLU: kernels::lrelu(x, n, s); break;
+                    case ExprOp::ELU: kernels::elu(x, n, s); break;
+                    case ExprOp::Sigmoid: kernels::sigmoid(x, n); break;
+                    case ExprOp::Tanh: kernels::tanh(x, n); break;
+                    case ExprOp::Square: kernels::square(x, n); break;
+                    case ExprOp::Sqrt: kernels::sqrt(x, n); break;
+                    case ExprOp::Exp: kernels::exp(x, n); break;
+                    case ExprOp::Log: kernels::log(x, n); break;
+                }
+            }
+            if (x == targetScratch) scatterBlock(target, begin, n, x);
+        }
+    });
+
+    LOG_TENSOR_OP("FUSED_EXPR", "CPU", shape, true, std::to_string(nodes.size()) + " ops");
+    nodes.clear();
+    operands.clear();
+    return target;
+}
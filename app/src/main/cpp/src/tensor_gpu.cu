@@ -1,5 +1,6 @@
 #include "../include/tensor.hpp"
 #include "../include/logger.hpp"
+#include "../include/memory_tracker.hpp"
 #include <cuda_runtime.h>
 #include <iostream>
 
@@ -30,7 +31,8 @@ void Tensor::makeContiguousGpu() {
         LOG_CUDA_OP("MALLOC", "makeContiguous", 0, 0, false, cudaGetErrorString(err));
         return;
     }
-    LOG_MEMORY_ALLOC("GPU", totalSize * sizeof(float), "makeContiguous newData");
+    MemoryTracker& tracker = MemoryTracker::getInstance();
+    tracker.recordAlloc(Device::GPU, gpuTag, totalSize * sizeof(float));
 
     int* dShape;
     int* dStrides;
@@ -38,6 +40,7 @@ void Tensor::makeContiguousGpu() {
     if (err != cudaSuccess) {
         LOG_CUDA_OP("MALLOC", "makeContiguous", 0, 0, false, cudaGetErrorString(err));
         cudaFree(newData);
+        tracker.recordFree(Device::GPU, gpuTag, totalSize * sizeof(float));
         return;
     }
 
@@ -46,6 +49,7 @@ void Tensor::makeContiguousGpu() {
         LOG_CUDA_OP("MALLOC", "makeContiguous", 0, 0, false, cudaGetErrorString(err));
         cudaFree(newData);
         cudaFree(dShape);
+        tracker.recordFree(Device::GPU, gpuTag, totalSize * sizeof(float));
         return;
     }
 
@@ -65,10 +69,9 @@ void Tensor::makeContiguousGpu() {
 
     cudaFree(dShape);
     cudaFree(dStrides);
-    LOG_MEMORY_DEALLOC("GPU", (shape.size() + strides.size()) * sizeof(int), "makeContiguous temp arrays");
 
     cudaFree(gpuData);
-    LOG_MEMORY_DEALLOC("GPU", totalSize * sizeof(float), "makeContiguous old data");
+    tracker.recordFree(Device::GPU, gpuTag, totalSize * sizeof(float));
 
     gpuData = newData;
 
@@ -333,6 +336,7 @@ __global__ void zeroGradKernel(float* data, int size) {
 }
 
 void Tensor::zeroGradGpu() {
+    if (gpuGrad == nullptr) return; // gradients were never enabled for this tensor
     int threadsPerBlock = 256;
     int blocks = (totalSize + threadsPerBlock - 1) / threadsPerBlock;
     zeroGradKernel<<<blocks, threadsPerBlock>>>(gpuGrad, totalSize);
@@ -345,17 +349,21 @@ void Tensor::freeGpuMemory() {
         if (err != cudaSuccess) {
             LOG_CUDA_OP("FREE", "gpuData", 0, 0, false, cudaGetErrorString(err));
         } else {
-            LOG_MEMORY_DEALLOC("GPU", totalSize * sizeof(float), "Tensor data");
+            MemoryTracker::getInstance().recordFree(Device::GPU, gpuTag, totalSize * sizeof(float));
         }
         gpuData = nullptr;
     }
 
+    freeGpuGrad();
+}
+
+void Tensor::freeGpuGrad() {
     if (gpuGrad) {
         cudaError_t err = cudaFree(gpuGrad);
         if (err != cudaSuccess) {
             LOG_CUDA_OP("FREE", "gpuGrad", 0, 0, false, cudaGetErrorString(err));
         } else {
-            LOG_MEMORY_DEALLOC("GPU", totalSize * sizeof(float), "Tensor gradients");
+            MemoryTracker::getInstance().recordFree(Device::GPU, MemoryTag::Gradient, totalSize * sizeof(float));
         }
         gpuGrad = nullptr;
     }
@@ -370,21 +378,26 @@ void Tensor::toGpu() {
         LOG_CUDA_OP("MALLOC", "toGpu", 0, 0, false, cudaGetErrorString(err));
         return;
     }
-    LOG_MEMORY_ALLOC("GPU", totalSize * sizeof(float), "Tensor data");
+    gpuTag = currentMemoryTag();
+    MemoryTracker::getInstance().recordAlloc(Device::GPU, gpuTag, totalSize * sizeof(float));
 
-    err = cudaMalloc(&gpuGrad, totalSize * sizeof(float));
-    if (err != cudaSuccess) {
-        LOG_CUDA_OP("MALLOC", "toGpu", 0, 0, false, cudaGetErrorString(err));
-        cudaFree(gpuData);
-        return;
+    // Gradient memory only for tensors that asked for it
+    if (gradEnabled) {
+        err = cudaMalloc(&gpuGrad, totalSize * sizeof(float));
+        if (err != cudaSuccess) {
+            LOG_CUDA_OP("MALLOC", "toGpu", 0, 0, false, cudaGetErrorString(err));
+            gpuGrad = nullptr;
+            freeGpuMemory();
+            return;
+        }
+        cudaMemset(gpuGrad, 0, totalSize * sizeof(float));
+        MemoryTracker::getInstance().recordAlloc(Device::GPU, MemoryTag::Gradient, totalSize * sizeof(float));
     }
-    LOG_MEMORY_ALLOC("GPU", totalSize * sizeof(float), "Tensor gradients");
 
-    err = cudaMemcpy(gpuData, cpuData.data(), totalSize * sizeof(float), cudaMemcpyHostToDevice);
+    err = cudaMemcpy(gpuData, data(), totalSize * sizeof(float), cudaMemcpyHostToDevice);
     if (err != cudaSuccess) {
         LOG_CUDA_OP("MEMCPY", "toGpu", 0, 0, false, cudaGetErrorString(err));
-        cudaFree(gpuData);
-        cudaFree(gpuGrad);
+        freeGpuMemory();
         return;
     }
 
@@ -392,19 +405,31 @@ void Tensor::toGpu() {
     device = Device::GPU;
 }
 
+// Device-side replica of this tensor's GPU buffer (same layout) into a freshly cloned host tensor
+void Tensor::cloneGpu(Tensor& dst) const {
+    dst.strides = strides;
+    dst.contiguous = contiguous;
+    dst.toGpu();
+    if (dst.gpuData == nullptr) return;
+    cudaMemcpy(dst.gpuData, gpuData, totalSize * sizeof(float), cudaMemcpyDeviceToDevice);
+    if (gpuGrad != nullptr && dst.gpuGrad != nullptr) {
+        cudaMemcpy(dst.gpuGrad, gpuGrad, totalSize * sizeof(float), cudaMemcpyDeviceToDevice);
+    }
+}
+
 void Tensor::toCpu() {
     if (gpuData == nullptr) return;
-    cudaMemcpy(cpuData.data(), gpuData, totalSize * sizeof(float), cudaMemcpyDeviceToHost);
+    cudaMemcpy(data(), gpuData, totalSize * sizeof(float), cudaMemcpyDeviceToHost);
     device = Device::CPU;
 }
 
 void Tensor::copyCpu() {
     if (gpuData == nullptr) return;
-    cudaMemcpy(cpuData.data(), gpuData, totalSize * sizeof(float), cudaMemcpyDeviceToHost);
+    cudaMemcpy(data(), gpuData, totalSize * sizeof(float), cudaMemcpyDeviceToHost);
 }
 
 void Tensor::copyGpu() {
     if (gpuData == nullptr) return;
-    cudaMemcpy(gpuData, cpuData.data(), totalSize * sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemcpy(gpuData, data(), totalSize * sizeof(float), cudaMemcpyHostToDevice);
 }
 
@@ -0,0 +1,187 @@
+#include "thread_pool.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+constexpr int kChunkAlign = 16;
+
+// Set on pool workers so nested parallelFor calls run inline instead of queueing behind
+// the task that is waiting for them.
+thread_local bool insidePoolTask = false;
+
+} // namespace
+
+ThreadPool& ThreadPool::getInstance() {
+    static ThreadPool instance;
+    return instance;
+}
+
+ThreadPool::ThreadPool() {
+    start((int)std::max(1u, std::thread::hardware_concurrency()));
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+void ThreadPool::configure(int numThreads, const std::vector<int>& cpus) {
+    stop();
+    affinity = cpus;
+    start(std::max(1, numThreads));
+    LOG_INFO("ThreadPool configured with " + std::to_string(getThreadCount()) + " threads" +
+             (cpus.empty() ? std::string() : ", pinned to " + std::to_string(cpus.size()) + " CPUs"));
+}
+
+int ThreadPool::getThreadCount() const {
+    return (int)workers.size() + 1;
+}
+
+void ThreadPool::start(int numThreads) {
+    stopping = false;
+    queues.clear();
+    for (int i = 0; i < numThreads; ++i) queues.push_back(std::make_unique<TaskQueue>());
+    for (int i = 0; i < numThreads - 1; ++i) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMtx);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) t.join();
+    workers.clear();
+}
+
+bool ThreadPool::popTask(int self, Task& out) {
+    // Own deque from the back (most recently dealt, still warm), then steal from the front of the rest
+    {
+        TaskQueue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mtx);
+        if (!own.tasks.empty()) {
+            out = own.tasks.back();
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    const int n = (int)queues.size();
+    for (int k = 1; k < n; ++k) {
+        TaskQueue& victim = *queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(victim.mtx);
+        if (!victim.tasks.empty()) {
+            out = victim.tasks.front();
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTask(const Task& task) {
+    (*task.job->fn)(task.begin, task.end);
+    // Decrement under the job lock: once the waiting caller sees 0 it may destroy the job
+    std::lock_guard<std::mutex> lock(task.job->mtx);
+    if (--task.job->remaining == 0) task.job->done.notify_all();
+}
+
+void ThreadPool::workerLoop(int index) {
+    insidePoolTask = true;
+    if (!affinity.empty()) pinCurrentThread(affinity);
+
+    Task task;
+    for (;;) {
+        if (popTask(index, task)) {
+            runTask(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wakeMtx);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
+
+void ThreadPool::parallelFor(int begin, int end, int grainSize, const std::function<void(int, int)>& fn) {
+    const int total = end - begin;
+    if (total <= 0) return;
+    const int threads = getThreadCount();
+    if (insidePoolTask || threads == 1 || total < 2 * grainSize) {
+        fn(begin, end);
+        return;
+    }
+
+    // A few chunks per thread so stealing can even out uneven cores, never below the grain
+    int chunk = std::max(grainSize, (total + threads * 4 - 1) / (threads * 4));
+    if (grainSize >= kChunkAlign) chunk = (chunk + kChunkAlign - 1) / kChunkAlign * kChunkAlign;
+    const int numChunks = (total + chunk - 1) / chunk;
+
+    Job job;
+    job.fn = &fn;
+    job.remaining = numChunks;
+
+    const int numQueues = (int)queues.size();
+    unsigned q = nextQueue.fetch_add(1);
+    for (int c = 0; c < numChunks; ++c, ++q) {
+        const int b = begin + c * chunk;
+        TaskQueue& queue = *queues[q % numQueues];
+        std::lock_guard<std::mutex> lock(queue.mtx);
+        queue.tasks.push_back({&job, b, std::min(end, b + chunk)});
+        queued++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMtx);
+    }
+    wake.notify_all();
+
+    // The caller works through the caller queue and steals until nothing is left
+    insidePoolTask = true;
+    Task task;
+    while (popTask(numQueues - 1, task)) runTask(task);
+    insidePoolTask = false;
+
+    std::unique_lock<std::mutex> lock(job.mtx);
+    job.done.wait(lock, [&job] { return job.remaining == 0; });
+}
+
+std::vector<int> ThreadPool::bigCoreIds() {
+    std::vector<std::pair<long, int>> freqs;
+    const int cpus = (int)std::max(1u, std::thread::hardware_concurrency());
+    for (int cpu = 0; cpu < cpus; ++cpu) {
+        std::ifstream f("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq");
+        long khz = 0;
+        if (!(f >> khz)) khz = 0;
+        freqs.emplace_back(khz, cpu);
+    }
+
+    long best = 0;
+    for (const auto& f : freqs) best = std::max(best, f.first);
+    std::vector<int> ids;
+    for (const auto& f : freqs) {
+        if (f.first == best) ids.push_back(f.second);
+    }
+    return ids;
+}
+
+bool ThreadPool::pinCurrentThread(const std::vector<int>& cpus) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        LOG_WARNING("sched_setaffinity failed; thread left unpinned");
+        return false;
+    }
+    return true;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
@@ -0,0 +1,164 @@
+#include "trace.hpp"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace trace {
+
+namespace detail {
+std::atomic<bool> enabled{false};
+} // namespace detail
+
+namespace {
+
+constexpr int kChunkEvents = 1024;
+
+struct Event {
+    const char* name;
+    int64_t begin;
+    int64_t duration;
+};
+
+// Single producer (the owning thread) appends and publishes through `count`; the exporter
+// reads the published prefix and frees a chunk once the owner has linked a successor.
+struct Chunk {
+    Event events[kChunkEvents];
+    std::atomic<int> count{0};
+    std::atomic<Chunk*> next{nullptr};
+    int exported = 0; // exporter only
+};
+
+struct ThreadBuffer {
+    Chunk* head; // oldest unexported chunk, exporter only
+    Chunk* tail; // chunk being filled, owner only
+    long tid;
+};
+
+struct Registry {
+    std::mutex mutex; // guards the lists, taken once per thread and on export
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::unordered_set<std::string> names;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Buffers outlive their threads so spans from finished threads still export
+ThreadBuffer* localBuffer() {
+    static thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        auto owned = std::make_unique<ThreadBuffer>();
+        owned->head = owned->tail = new Chunk;
+        owned->tid = (long)syscall(SYS_gettid);
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffer = owned.get();
+        r.buffers.push_back(std::move(owned));
+    }
+    return buffer;
+}
+
+void appendEscaped(std::string& out, const char* s) {
+    for (; *s != '\0'; ++s) {
+        const unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += (char)c;
+        }
+    }
+}
+
+// Microseconds with three decimals: exact nanoseconds without going through double
+void appendMicros(std::string& out, int64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%lld.%03d", (long long)(ns / 1000), (int)(ns % 1000));
+    out += buf;
+}
+
+} // namespace
+
+void start() {
+    detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop() {
+    detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+void record(const char* name, int64_t beginNs, int64_t endNs) {
+    ThreadBuffer* b = localBuffer();
+    Chunk* c = b->tail;
+    int n = c->count.load(std::memory_order_relaxed);
+    if (n == kChunkEvents) {
+        Chunk* next = new Chunk;
+        c->next.store(next, std::memory_order_release);
+        b->tail = c = next;
+        n = 0;
+    }
+    c->events[n] = {name, beginNs, endNs - beginNs};
+    c->count.store(n + 1, std::memory_order_release);
+}
+
+const char* intern(const std::string& name) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.names.insert(name).first->c_str();
+}
+
+std::string exportChromeJson() {
+    const long pid = (long)getpid();
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (auto& b : r.buffers) {
+        char ids[64];
+        std::snprintf(ids, sizeof(ids), ",\"pid\":%ld,\"tid\":%ld}", pid, b->tid);
+        for (Chunk* c = b->head;;) {
+            // `next` first: once it is set the owner has finished this chunk's count
+            Chunk* next = c->next.load(std::memory_order_acquire);
+            const int n = c->count.load(std::memory_order_acquire);
+            for (int i = c->exported; i < n; ++i) {
+                const Event& e = c->events[i];
+                out += first ? "\n" : ",\n";
+                first = false;
+                out += "{\"name\":\"";
+                appendEscaped(out, e.name);
+                out += "\",\"cat\":\"tsr\",\"ph\":\"X\",\"ts\":";
+                appendMicros(out, e.begin);
+                out += ",\"dur\":";
+                appendMicros(out, e.duration);
+                out += ids;
+            }
+            c->exported = n;
+            if (next == nullptr) break;
+            delete c;
+            b->head = c = next;
+        }
+    }
+    out += "\n],\"displayTimeUnit\":\"ns\"}\n";
+    return out;
+}
+
+bool writeChromeJson(const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) return false;
+    file << exportChromeJson();
+    return file.good();
+}
+
+} // namespace trace
@@ -0,0 +1,117 @@
+#include "yolo_decoder.hpp"
+#include "simd.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include <algorithm>
+
+void DetectionCandidates::clear() {
+    x1.clear();
+    y1.clear();
+    x2.clear();
+    y2.clear();
+    score.clear();
+    classId.clear();
+}
+
+void DetectionCandidates::reserve(size_t n) {
+    x1.reserve(n);
+    y1.reserve(n);
+    x2.reserve(n);
+    y2.reserve(n);
+    score.reserve(n);
+    classId.reserve(n);
+}
+
+void DetectionCandidates::push(float bx1, float by1, float bx2, float by2, float s, int cls) {
+    x1.push_back(bx1);
+    y1.push_back(by1);
+    x2.push_back(bx2);
+    y2.push_back(by2);
+    score.push_back(s);
+    classId.push_back(cls);
+}
+
+namespace {
+
+// Anchors per tile: the running max/argmax for a tile (2 x 1 KB) stays in L1 while
+// every class row streams through it.
+constexpr int kAnchorTile = 256;
+
+} // namespace
+
+size_t decodeYolo(const float* output, int numClasses, int numAnchors, float confThreshold,
+                  const LetterboxInfo& letterbox, DetectionCandidates& out) {
+    TSR_TRACE_SCOPE("decode");
+    TSR_LATENCY_SCOPE("decode");
+    out.clear();
+    if (numClasses <= 0 || numAnchors <= 0) return 0;
+
+    const float* cxRow = output;
+    const float* cyRow = output + (size_t)numAnchors;
+    const float* wRow = output + (size_t)2 * numAnchors;
+    const float* hRow = output + (size_t)3 * numAnchors;
+    const float* scores = output + (size_t)4 * numAnchors;
+
+    const float invScale = 1.0f / letterbox.scale;
+    const float padX = (float)letterbox.padX;
+    const float padY = (float)letterbox.padY;
+    const simd::VecF vThresh = simd::set1(confThreshold);
+
+    alignas(64) float maxScore[kAnchorTile];
+    alignas(64) float argMax[kAnchorTile]; // class ids held as floats so select() can blend them
+
+    for (int base = 0; base < numAnchors; base += kAnchorTile) {
+        const int n = std::min(kAnchorTile, numAnchors - base);
+        const int nVec = n - n % simd::kWidth;
+
+        std::copy(scores + base, scores + base + n, maxScore);
+        std::fill(argMax, argMax + n, 0.0f);
+
+        for (int c = 1; c < numClasses; ++c) {
+            const float* row = scores + (size_t)c * numAnchors + base;
+            const simd::VecF vc = simd::set1((float)c);
+            int i = 0;
+            for (; i < nVec; i += simd::kWidth) {
+                simd::VecF s = simd::load(row + i);
+                simd::VecF m = simd::load(maxScore + i);
+                simd::MaskF gt = simd::cmpGt(s, m);
+                simd::store(maxScore + i, simd::max(s, m));
+                simd::store(argMax + i, simd::select(gt, vc, simd::load(argMax + i)));
+            }
+            for (; i < n; ++i) {
+                if (row[i] > maxScore[i]) {
+                    maxScore[i] = row[i];
+                    argMax[i] = (float)c;
+                }
+            }
+        }
+
+        // Threshold + compaction; whole vectors below threshold are skipped without a scalar look.
+        for (int i = 0; i < n; i += simd::kWidth) {
+            if (i < nVec && !simd::anyTrue(simd::cmpGe(simd::load(maxScore + i), vThresh))) continue;
+            const int end = std::min(i + simd::kWidth, n);
+            for (int k = i; k < end; ++k) {
+                if (maxScore[k] < confThreshold) continue;
+                const int a = base + k;
+                const float halfW = wRow[a] * 0.5f;
+                const float halfH = hRow[a] * 0.5f;
+                out.push((cxRow[a] - halfW - padX) * invScale,
+                         (cyRow[a] - halfH - padY) * invScale,
+                         (cxRow[a] + halfW - padX) * invScale,
+                         (cyRow[a] + halfH - padY) * invScale,
+                         maxScore[k],
+                         (int)argMax[k]);
+            }
+        }
+    }
+
+    return out.size();
+}
+
+size_t decodeYolo(const Tensor& output, float confThreshold, const LetterboxInfo& letterbox,
+                  DetectionCandidates& out) {
+    const std::vector<int>& shape = output.getShape();
+    assert(shape.size() == 3 && shape[0] == 1 && shape[1] > 4);
+    assert(output.isContiguous() && output.getDevice() == Device::CPU);
+    return decodeYolo(output.data(), shape[1] - 4, shape[2], confThreshold, letterbox, out);
+}
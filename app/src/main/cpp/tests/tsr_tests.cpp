@@ -0,0 +1,729 @@
+// Host unit tests for the native core. Each case checks an optimized path against a naive
+// reference or hand-computed values. Run through ctest, or directly with an optional
+// substring filter: tsr_tests [FILTER]
+
+#include "allocator.hpp"
+#include "layers.hpp"
+#include "logger.hpp"
+#include "memory_tracker.hpp"
+#include "metrics.hpp"
+#include "nms.hpp"
+#include "preprocess.hpp"
+#include "tensor.hpp"
+#include "tensor_expr.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct TestCase {
+    const char* name;
+    void (*fn)();
+};
+
+std::vector<TestCase>& registry() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+int failures = 0;
+
+struct Registrar {
+    Registrar(const char* name, void (*fn)()) { registry().push_back({name, fn}); }
+};
+
+#define TEST(name)                                      \
+    void name();                                        \
+    const Registrar name##Registrar(#name, name);       \
+    void name()
+
+#define CHECK(cond)                                                                          \
+    do {                                                                                     \
+        if (!(cond)) {                                                                       \
+            std::cerr << "  " << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed" \
+                      << std::endl;                                                          \
+            ++failures;                                                                      \
+        }                                                                                    \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                                  \
+    do {                                                                                       \
+        const double tsrA = (a), tsrB = (b);                                                   \
+        if (!(std::fabs(tsrA - tsrB) <= (tol) * (1.0 + std::fabs(tsrB)))) {                   \
+            std::cerr << "  " << __FILE__ << ":" << __LINE__ << ": " #a " = " << tsrA << ", " #b \
+                      << " = " << tsrB << std::endl;                                           \
+            ++failures;                                                                        \
+        }                                                                                      \
+    } while (0)
+
+std::mt19937 rng(7);
+
+Tensor randomTensor(const std::vector<int>& shape) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    Tensor t(shape);
+    for (int i = 0; i < t.size(); ++i) t.data()[i] = dist(rng);
+    return t;
+}
+
+void checkAllNear(const Tensor& a, const Tensor& b, double tol) {
+    CHECK(a.getShape() == b.getShape());
+    if (a.getShape() != b.getShape()) return;
+    const Tensor ca = a.toContiguous(), cb = b.toContiguous();
+    int bad = 0;
+    for (int i = 0; i < ca.size() && bad < 5; ++i) {
+        if (!(std::fabs(ca.data()[i] - cb.data()[i]) <= tol * (1.0 + std::fabs(cb.data()[i])))) {
+            std::cerr << "  element " << i << ": " << ca.data()[i] << " vs " << cb.data()[i] << std::endl;
+            ++bad;
+        }
+    }
+    if (bad > 0) ++failures;
+}
+
+TEST(elementwiseOps) {
+    Tensor a = randomTensor({2, 3, 17, 19});
+    const Tensor b = randomTensor({2, 3, 17, 19});
+    const Tensor source = a.clone();
+    a.multiplyScalar(2.0f);
+    a.addTensor(b);
+    a.subtractScalar(0.5f);
+    a.ReLU();
+    for (int i = 0; i < a.size(); ++i) {
+        CHECK_NEAR(a.data()[i], std::max(0.0f, 2.0f * source.data()[i] + b.data()[i] - 0.5f), 1e-6);
+    }
+
+    Tensor s = source.clone();
+    s.sigmoid();
+    Tensor e = source.clone();
+    e.exp();
+    for (int i = 0; i < s.size(); i += 7) {
+        CHECK_NEAR(s.data()[i], 1.0 / (1.0 + std::exp(-source.data()[i])), 1e-5);
+        CHECK_NEAR(e.data()[i], std::exp(source.data()[i]), 1e-5);
+    }
+}
+
+TEST(broadcastBinary) {
+    const Tensor a = randomTensor({2, 3, 1});
+    const Tensor b = randomTensor({1, 4});
+    CHECK(Tensor::broadcastShape(a.getShape(), b.getShape()) == std::vector<int>({2, 3, 4}));
+    const Tensor sum = Tensor::add(a, b);
+    CHECK(sum.getShape() == std::vector<int>({2, 3, 4}));
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            for (int k = 0; k < 4; ++k) {
+                CHECK_NEAR(sum.data()[(i * 3 + j) * 4 + k], a.data()[i * 3 + j] + b.data()[k], 1e-6);
+            }
+        }
+    }
+
+    // In place: channel vector [C, 1, 1] against NCHW
+    Tensor x = randomTensor({1, 5, 6, 7});
+    const Tensor source = x.clone();
+    const Tensor channel = randomTensor({5, 1, 1});
+    x.multiplyTensor(channel);
+    for (int c = 0; c < 5; ++c) {
+        for (int i = 0; i < 42; ++i) {
+            CHECK_NEAR(x.data()[c * 42 + i], source.data()[c * 42 + i] * channel.data()[c], 1e-6);
+        }
+    }
+}
+
+TEST(biasAndFusedExpr) {
+    const Tensor source = randomTensor({2, 8, 9, 11});
+    const Tensor scale = randomTensor({8});
+    const Tensor shift = randomTensor({8});
+
+    Tensor unfused = source.clone();
+    unfused.multiplyBias(scale);
+    unfused.addBias(shift);
+    unfused.ReLU();
+
+    Tensor affine = source.clone();
+    affine.channelAffine(scale, shift);
+    affine.ReLU();
+    checkAllNear(affine, unfused, 1e-6);
+
+    Tensor fused = source.clone();
+    fused.expr().mulBias(scale).addBias(shift).relu().eval();
+    checkAllNear(fused, unfused, 1e-6);
+}
+
+TEST(matmulMatchesNaive) {
+    for (const auto& mnk : std::vector<std::vector<int>>{{1, 1, 1}, {7, 5, 3}, {37, 29, 53}, {128, 96, 200}}) {
+        const int m = mnk[0], n = mnk[1], k = mnk[2];
+        const Tensor a = randomTensor({m, k});
+        const Tensor b = randomTensor({k, n});
+        const Tensor c = a.matmul(b);
+        CHECK(c.getShape() == std::vector<int>({m, n}));
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < n; ++j) {
+                double ref = 0.0;
+                for (int p = 0; p < k; ++p) ref += (double)a.data()[i * k + p] * b.data()[p * n + j];
+                CHECK_NEAR(c.data()[i * n + j], ref, 1e-4);
+            }
+        }
+    }
+}
+
+TEST(reductions) {
+    const Tensor x = randomTensor({3, 47, 10});
+    const Tensor sum = x.sum(1);
+    const Tensor max = x.max(1);
+    const Tensor argmax = x.argmax(1);
+    const Tensor softmax = x.softmax(1);
+    CHECK(sum.getShape() == std::vector<int>({3, 10}));
+    for (int o = 0; o < 3; ++o) {
+        for (int i = 0; i < 10; ++i) {
+            double refSum = 0.0, total = 0.0;
+            float refMax = -INFINITY;
+            int refArg = 0;
+            for (int r = 0; r < 47; ++r) {
+                const float v = x.data()[(o * 47 + r) * 10 + i];
+                refSum += v;
+                if (v > refMax) {
+                    refMax = v;
+                    refArg = r;
+                }
+                total += softmax.data()[(o * 47 + r) * 10 + i];
+            }
+            CHECK_NEAR(sum.data()[o * 10 + i], refSum, 1e-5);
+            CHECK(max.data()[o * 10 + i] == refMax);
+            CHECK((int)argmax.data()[o * 10 + i] == refArg);
+            CHECK_NEAR(total, 1.0, 1e-5);
+        }
+    }
+
+    Tensor values, indices;
+    const Tensor row = randomTensor({1, 43});
+    row.topK(3, 1, values, indices);
+    CHECK(values.data()[0] == row.max(1).data()[0]);
+    CHECK(values.data()[0] >= values.data()[1] && values.data()[1] >= values.data()[2]);
+    for (int i = 0; i < 3; ++i) CHECK(row.data()[(int)indices.data()[i]] == values.data()[i]);
+}
+
+TEST(viewsAndCopies) {
+    const Tensor x = randomTensor({2, 3, 4, 5});
+    Tensor t = x.clone();
+    t.transpose({0, 2, 3, 1});
+    t.makeContiguous();
+    CHECK(t.getShape() == std::vector<int>({2, 4, 5, 3}));
+    for (int n = 0; n < 2; ++n) {
+        for (int c = 0; c < 3; ++c) {
+            for (int h = 0; h < 4; ++h) {
+                for (int w = 0; w < 5; ++w) {
+                    CHECK(t.data()[((n * 4 + h) * 5 + w) * 3 + c] == x.data()[((n * 3 + c) * 4 + h) * 5 + w]);
+                }
+            }
+        }
+    }
+
+    const Tensor s = x.slice(3, 1, 5, 2).toContiguous();
+    CHECK(s.getShape() == std::vector<int>({2, 3, 4, 2}));
+    CHECK(s.data()[1] == x.data()[3]);
+}
+
+// In-place ops on strided views land in the source and leave the elements outside the view alone
+TEST(viewWriteThrough) {
+    const Tensor x = randomTensor({2, 5, 4, 6});
+    Tensor base = x.clone();
+    base.narrow(1, 1, 3).fill(5.0f);    // unit-stride rows
+    base.slice(3, 0, 6, 2).addScalar(1.0f); // stepped rows, gathered and scattered
+    Tensor relu = base.select(0, 1).narrow(2, 2, 3);
+    relu.multiplyScalar(-1.0f);
+    relu.ReLU();
+    Tensor fused = base.narrow(1, 4, 1);
+    fused.expr().mul(2.0f).add(1.0f).eval(); // gathered and scattered per block
+    for (int n = 0; n < 2; ++n) {
+        for (int c = 0; c < 5; ++c) {
+            for (int h = 0; h < 4; ++h) {
+                for (int w = 0; w < 6; ++w) {
+                    const int i = ((n * 5 + c) * 4 + h) * 6 + w;
+                    float expected = c >= 1 && c < 4 ? 5.0f : x.data()[i];
+                    if (w % 2 == 0) expected += 1.0f;
+                    if (n == 1 && w >= 2 && w < 5) expected = std::max(0.0f, -expected);
+                    if (c == 4) expected = expected * 2.0f + 1.0f;
+                    CHECK(base.data()[i] == expected);
+                }
+            }
+        }
+    }
+
+    // Per-channel affine through stepped row views of every format (rows h = 1, 3)
+    const Tensor scale = randomTensor({5}), shift = randomTensor({5});
+    for (MemoryFormat format : {MemoryFormat::NCHW, MemoryFormat::NHWC, MemoryFormat::NCHWc4, MemoryFormat::NCHWc8}) {
+        const Tensor packed = x.clone().toMemoryFormat(format);
+        Tensor rows = packed.slice(format == MemoryFormat::NHWC ? 1 : 2, 1, 4, 2);
+        CHECK(!rows.isContiguous());
+        rows.channelAffine(scale, shift);
+        const Tensor y = packed.toMemoryFormat(MemoryFormat::NCHW);
+        for (int i = 0; i < x.size(); ++i) {
+            const int c = i / 24 % 5, h = i / 6 % 4;
+            const float expected = h % 2 == 1 ? x.data()[i] * scale.data()[c] + shift.data()[c] : x.data()[i];
+            CHECK_NEAR(y.data()[i], expected, 1e-6);
+        }
+    }
+}
+
+TEST(memoryFormatRoundTrip) {
+    const Tensor x = randomTensor({2, 11, 6, 7});
+    for (MemoryFormat format : {MemoryFormat::NHWC, MemoryFormat::NCHWc4, MemoryFormat::NCHWc8}) {
+        const Tensor packed = x.toMemoryFormat(format);
+        CHECK(packed.getMemoryFormat() == format);
+        CHECK(packed.getLogicalShape() == x.getShape());
+        checkAllNear(packed.toMemoryFormat(MemoryFormat::NCHW), x, 0.0);
+    }
+}
+
+TEST(halfConversion) {
+    const std::vector<float> exact = {0.0f, -0.0f, 1.0f, -1.5f, 0.25f, 65504.0f, -65504.0f, 6.103515625e-05f, 5.9604645e-08f};
+    Tensor x({37}); // not a multiple of the vector width
+    x.fill(0.0f);
+    for (size_t i = 0; i < exact.size(); ++i) x.data()[i] = exact[i];
+    x.data()[10] = 1.0f + std::ldexp(1.0f, -11);     // tie, rounds to even: 1
+    x.data()[11] = 1.0f + 3 * std::ldexp(1.0f, -11); // tie, rounds to even: 1 + 2^-9
+    x.data()[12] = 70000.0f;                         // overflows to inf
+    for (int i = 13; i < 37; ++i) x.data()[i] = std::ldexp((float)(i - 25) / 7.0f, i % 9 - 4);
+
+    const Tensor half = x.toDType(DType::FP16);
+    CHECK(half.getDType() == DType::FP16 && half.getShape() == x.getShape());
+    const Tensor back = half.toDType(DType::FP32);
+    for (size_t i = 0; i < exact.size(); ++i) CHECK(back.data()[i] == exact[i]);
+    CHECK(!std::signbit(back.data()[0]) && std::signbit(back.data()[1]));
+    CHECK(back.data()[10] == 1.0f);
+    CHECK(back.data()[11] == 1.0f + std::ldexp(1.0f, -9));
+    CHECK(std::isinf(back.data()[12]));
+    for (int i = 13; i < 37; ++i) CHECK_NEAR(back.data()[i], x.data()[i], std::ldexp(1.0, -11));
+}
+
+TEST(int8Quantization) {
+    Tensor x = randomTensor({2, 5, 3, 7});
+    const QuantParams params = x.calibrate();
+    const Tensor q = x.toDType(DType::INT8);
+    CHECK(q.getDType() == DType::INT8 && !q.getQuantParams().isPerChannel());
+    CHECK(q.getQuantParams().scale == params.scale && q.getQuantParams().zeroPoint == params.zeroPoint);
+    const Tensor back = q.toDType(DType::FP32);
+    for (int i = 0; i < x.size(); ++i) {
+        CHECK(std::fabs(back.data()[i] - x.data()[i]) <= params.scale[0] * 0.5001f);
+    }
+
+    // Per channel along axis 1, channels spanning different ranges
+    for (int i = 0; i < x.size(); ++i) x.data()[i] *= (float)(1 + (i / 21) % 5);
+    const Tensor qc = x.toDType(DType::INT8, x.calibrate(1));
+    const QuantParams& pc = qc.getQuantParams();
+    CHECK(pc.isPerChannel() && pc.channels() == 5 && pc.scale[4] > 4.0f * pc.scale[0]);
+    const Tensor backc = qc.toDType(DType::FP32);
+    for (int i = 0; i < x.size(); ++i) {
+        CHECK(std::fabs(backc.data()[i] - x.data()[i]) <= pc.scale[(i / 21) % 5] * 0.5001f);
+    }
+    CHECK(qc.clone().getQuantParams().scale == pc.scale);
+
+    // One byte per element
+    const int64_t before = MemoryTracker::getInstance().snapshot().total.liveBytes;
+    const Tensor small = Tensor::withDType({1000}, DType::INT8, QuantParams::perTensor(0.1f));
+    CHECK(MemoryTracker::getInstance().snapshot().total.liveBytes - before == 1000);
+}
+
+TEST(int8Kernels) {
+    const Tensor a = randomTensor({1, 4, 9, 5});
+    const Tensor b = randomTensor({1, 4, 9, 5});
+    const Tensor bias = randomTensor({4});
+    const QuantParams wide = QuantParams::perTensor(5.0f / 255.0f, -1); // room for a + b and a + bias
+    auto dequant = [](int q, const QuantParams& p) { return p.scale[0] * (q - p.zeroPoint[0]); };
+
+    const Tensor qa = a.toDType(DType::INT8, wide);
+    const Tensor qb = b.toDType(DType::INT8);
+    Tensor sum = qa.clone();
+    sum.addTensor(qb);
+    for (int i = 0; i < a.size(); ++i) {
+        const float expected = dequant(qa.dataInt8()[i], wide) + dequant(qb.dataInt8()[i], qb.getQuantParams());
+        CHECK(std::fabs(dequant(sum.dataInt8()[i], wide) - expected) <= wide.scale[0] * 0.5001f);
+    }
+
+    Tensor biased = qa.clone();
+    biased.addBias(bias);
+    for (int i = 0; i < a.size(); ++i) {
+        const float expected = dequant(qa.dataInt8()[i], wide) + bias.data()[i / 45];
+        CHECK(std::fabs(dequant(biased.dataInt8()[i], wide) - expected) <= wide.scale[0] * 0.5001f);
+    }
+
+    const Tensor qc = a.toDType(DType::INT8, a.calibrate(1));
+    for (const Tensor* source : {&qa, &qc}) {
+        Tensor relu = source->clone();
+        relu.ReLU();
+        const QuantParams& p = source->getQuantParams();
+        for (int i = 0; i < a.size(); ++i) {
+            const int zp = p.zeroPoint[p.isPerChannel() ? i / 45 : 0];
+            CHECK(relu.dataInt8()[i] == std::max<int>(source->dataInt8()[i], zp));
+        }
+    }
+}
+
+TEST(lowPrecisionViews) {
+    const Tensor x = randomTensor({2, 6, 5, 7});
+    const std::vector<int> order = {0, 2, 3, 1};
+    for (const QuantParams& params : {x.calibrate(), x.calibrate(1)}) {
+        const Tensor q = x.toDType(DType::INT8, params);
+        const Tensor ref = q.toDType(DType::FP32); // what every view below must read back exactly
+        Tensor t = q.view(), refT = ref.view();
+        t.transpose(order);
+        refT.transpose(order);
+        checkAllNear(t.toDType(DType::FP32), refT, 0.0);
+        checkAllNear(t.toContiguous().toDType(DType::FP32), refT, 0.0);
+        checkAllNear(t.clone().toDType(DType::FP32), refT, 0.0);
+        checkAllNear(q.slice(1, 1, 6, 2).toDType(DType::FP32), ref.slice(1, 1, 6, 2), 0.0);
+        checkAllNear(q.select(1, 4).toDType(DType::FP32), ref.select(1, 4), 0.0);
+        checkAllNear(q.select(0, 1).narrow(2, 2, 4).toDType(DType::FP32), ref.select(0, 1).narrow(2, 2, 4), 0.0);
+
+        // In-place INT8 ops write through a strided view
+        Tensor relu = q.clone();
+        relu.slice(3, 1, 7, 2).ReLU();
+        for (int i = 0; i < x.size(); ++i) {
+            const int zp = params.zeroPoint[params.isPerChannel() ? i / 35 % 6 : 0];
+            CHECK(relu.dataInt8()[i] == (i % 7 % 2 == 1 ? std::max<int>(q.dataInt8()[i], zp) : q.dataInt8()[i]));
+        }
+    }
+
+    const Tensor h = x.toDType(DType::FP16);
+    Tensor ht = h.view(), refT = h.toDType(DType::FP32);
+    ht.transpose(order);
+    refT.transpose(order);
+    checkAllNear(ht.toDType(DType::FP32), refT, 0.0);
+    checkAllNear(h.slice(3, 0, 7, 3).toDType(DType::FP32), h.toDType(DType::FP32).slice(3, 0, 7, 3), 0.0);
+}
+
+TEST(floatOpsRejectLowPrecision) {
+    const Tensor x = randomTensor({4, 8});
+    const Tensor q = x.toDType(DType::INT8);
+    auto rejects = [](const std::function<void()>& op) {
+        try {
+            op();
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    Tensor t = q.clone();
+    CHECK(rejects([&] { t.addScalar(1.0f); }));
+    CHECK(rejects([&] { t.sigmoid(); }));
+    CHECK(rejects([&] { t.at({0, 0}) = 1.0f; }));
+    CHECK(rejects([&] { q.matmul(randomTensor({8, 3})); }));
+    CHECK(rejects([&] { q.sum(1); }));
+    CHECK(rejects([&] { q.softmax(-1); }));
+    CHECK(rejects([&] { x.toDType(DType::FP16).mean(0); }));
+    CHECK(rejects([&] { x.dataInt8(); }));
+    for (int i = 0; i < q.size(); ++i) CHECK(t.dataInt8()[i] == q.dataInt8()[i]); // rejected before writing
+    checkAllNear(t.toDType(DType::FP32).sum(1), q.toDType(DType::FP32).sum(1), 0.0);
+}
+
+// Direct convolution reference, NCHW, dilation 1
+Tensor naiveConv(const Tensor& x, const Tensor& w, const Tensor& b, int stride, int pad, int groups) {
+    const std::vector<int>& is = x.getShape();
+    const std::vector<int>& ws = w.getShape();
+    const int outH = convOutputSize(is[2], ws[2], stride, pad);
+    const int outW = convOutputSize(is[3], ws[3], stride, pad);
+    const int cinPerGroup = is[1] / groups, coutPerGroup = ws[0] / groups;
+    Tensor y({is[0], ws[0], outH, outW});
+    for (int n = 0; n < is[0]; ++n) {
+        for (int co = 0; co < ws[0]; ++co) {
+            const int g = co / coutPerGroup;
+            for (int oh = 0; oh < outH; ++oh) {
+                for (int ow = 0; ow < outW; ++ow) {
+                    double acc = b.data()[co];
+                    for (int ci = 0; ci < cinPerGroup; ++ci) {
+                        for (int kh = 0; kh < ws[2]; ++kh) {
+                            for (int kw = 0; kw < ws[3]; ++kw) {
+                                const int ih = oh * stride - pad + kh, iw = ow * stride - pad + kw;
+                                if (ih < 0 || ih >= is[2] || iw < 0 || iw >= is[3]) continue;
+                                acc += (double)x.data()[((n * is[1] + g * cinPerGroup + ci) * is[2] + ih) * is[3] + iw] *
+                                       w.data()[((co * cinPerGroup + ci) * ws[2] + kh) * ws[3] + kw];
+                            }
+                        }
+                    }
+                    y.data()[((n * ws[0] + co) * outH + oh) * outW + ow] = (float)acc;
+                }
+            }
+        }
+    }
+    return y;
+}
+
+TEST(conv2dMatchesNaive) {
+    struct Case {
+        std::vector<int> input, weight;
+        int stride, pad, groups;
+        ConvAlgo algo;
+    };
+    const std::vector<Case> cases = {
+            {{1, 3, 17, 19}, {8, 3, 3, 3}, 1, 1, 1, ConvAlgo::Auto},
+            {{2, 16, 12, 12}, {24, 16, 3, 3}, 2, 1, 1, ConvAlgo::Auto},
+            {{1, 32, 9, 9}, {16, 32, 1, 1}, 1, 0, 1, ConvAlgo::Auto},
+            {{1, 12, 10, 11}, {12, 1, 3, 3}, 1, 1, 12, ConvAlgo::Auto},
+            {{1, 8, 8, 8}, {8, 4, 3, 3}, 1, 0, 2, ConvAlgo::Auto},
+            {{1, 16, 34, 34}, {16, 16, 3, 3}, 1, 1, 1, ConvAlgo::Auto}, // Auto picks Winograd
+            {{1, 3, 17, 19}, {8, 3, 3, 3}, 1, 1, 1, ConvAlgo::Winograd},
+            {{2, 5, 9, 6}, {7, 5, 3, 3}, 1, 0, 1, ConvAlgo::Winograd},
+            {{1, 32, 9, 9}, {16, 32, 1, 1}, 1, 0, 1, ConvAlgo::Direct},
+            {{1, 12, 10, 11}, {12, 1, 3, 3}, 2, 1, 12, ConvAlgo::Direct},
+            {{1, 16, 9, 9}, {16, 16, 3, 3}, 1, 1, 1, ConvAlgo::Im2colGemm},
+    };
+    for (const Case& c : cases) {
+        const Tensor x = randomTensor(c.input);
+        const Tensor w = randomTensor(c.weight);
+        const Tensor b = randomTensor({c.weight[0]});
+        Conv2dParams p;
+        p.strideH = p.strideW = c.stride;
+        p.padH = p.padW = c.pad;
+        p.groups = c.groups;
+        p.algo = c.algo;
+        const Tensor expected = naiveConv(x, w, b, c.stride, c.pad, c.groups);
+        checkAllNear(conv2d(x, w, &b, p), expected, c.algo == ConvAlgo::Winograd ? 1e-3 : 1e-4);
+        // Non-NCHW inputs take the per-format kernels and come back in the input's format
+        for (MemoryFormat format : {MemoryFormat::NHWC, MemoryFormat::NCHWc4, MemoryFormat::NCHWc8}) {
+            const Tensor y = conv2d(x.toMemoryFormat(format), w, &b, p);
+            CHECK(y.getMemoryFormat() == format);
+            checkAllNear(y.toMemoryFormat(MemoryFormat::NCHW), expected, 1e-4);
+        }
+    }
+}
+
+TEST(pooling) {
+    const Tensor x = randomTensor({1, 3, 6, 8});
+    const Tensor y = maxPool2d(x, Pool2dParams());
+    CHECK(y.getShape() == std::vector<int>({1, 3, 3, 4}));
+    for (int c = 0; c < 3; ++c) {
+        for (int h = 0; h < 3; ++h) {
+            for (int w = 0; w < 4; ++w) {
+                const float* p = x.data() + (c * 6 + 2 * h) * 8 + 2 * w;
+                CHECK(y.data()[(c * 3 + h) * 4 + w] == std::max(std::max(p[0], p[1]), std::max(p[8], p[9])));
+            }
+        }
+    }
+    const Tensor g = globalAvgPool(x);
+    double mean = 0.0;
+    for (int i = 0; i < 48; ++i) mean += x.data()[i] / 48.0;
+    CHECK_NEAR(g.data()[0], mean, 1e-5);
+}
+
+TEST(letterbox) {
+    const LetterboxInfo info = computeLetterbox(1280, 720, 640, 640);
+    CHECK(info.newW == 640 && info.newH == 360);
+    CHECK(info.padX == 0 && info.padY == 140);
+
+    // Uniform grey frame: resized rows hold 128/255, padding rows the letterbox value
+    std::vector<uint8_t> rgba(1280 * 720 * 4, 128);
+    Tensor input({1, 3, 640, 640});
+    letterboxNormalize(rgba.data(), 1280, 720, 1280 * 4, PixelFormat::RGBA8888, input);
+    for (int c = 0; c < 3; ++c) {
+        CHECK_NEAR(input.data()[(c * 640 + 0) * 640 + 5], kLetterboxPadValue, 1e-6);
+        CHECK_NEAR(input.data()[(c * 640 + 320) * 640 + 300], 128.0f / 255.0f, 1e-6);
+        CHECK_NEAR(input.data()[(c * 640 + 639) * 640 + 639], kLetterboxPadValue, 1e-6);
+    }
+}
+
+TEST(decodeAndNms) {
+    // Three anchors of a 2-class head: 0 and 1 overlap heavily (class 0), 2 is apart (class 1)
+    const int classes = 2, anchors = 4;
+    std::vector<float> head((4 + classes) * anchors, 0.0f);
+    const float boxes[4][4] = {{100, 100, 40, 40}, {104, 102, 40, 40}, {300, 300, 50, 30}, {500, 500, 10, 10}};
+    const float scores[4][2] = {{0.9f, 0.1f}, {0.8f, 0.2f}, {0.05f, 0.7f}, {0.1f, 0.1f}};
+    for (int a = 0; a < anchors; ++a) {
+        for (int r = 0; r < 4; ++r) head[r * anchors + a] = boxes[a][r];
+        for (int c = 0; c < classes; ++c) head[(4 + c) * anchors + a] = scores[a][c];
+    }
+    LetterboxInfo letterbox;
+    DetectionCandidates candidates;
+    CHECK(decodeYolo(head.data(), classes, anchors, 0.25f, letterbox, candidates) == 3);
+    CHECK_NEAR(candidates.x1[0], 80.0, 1e-6);
+    CHECK_NEAR(candidates.y2[0], 120.0, 1e-6);
+
+    std::vector<int> keep;
+    CHECK(nonMaxSuppression(candidates, NmsConfig(), keep) == 2);
+    CHECK(candidates.score[keep[0]] == 0.9f && candidates.classId[keep[0]] == 0);
+    CHECK(candidates.score[keep[1]] == 0.7f && candidates.classId[keep[1]] == 1);
+}
+
+TEST(threadPoolCoversRange) {
+    std::vector<std::atomic<int>> hits(100000);
+    ThreadPool::getInstance().parallelFor(0, (int)hits.size(), 1000, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) hits[i].fetch_add(1, std::memory_order_relaxed);
+    });
+    int wrong = 0;
+    for (auto& h : hits) wrong += h.load() != 1;
+    CHECK(wrong == 0);
+}
+
+TEST(histogramPercentiles) {
+    Histogram h;
+    for (int i = 1; i <= 10000; ++i) h.record(i * 1000);
+    const LatencySummary s = h.summarize(true);
+    CHECK(s.count == 10000);
+    CHECK_NEAR(s.p50, 5000000, 0.035);
+    CHECK_NEAR(s.p99, 9900000, 0.035);
+    CHECK(s.max == 10000000);
+    CHECK(h.summarize().count == 0);
+}
+
+TEST(memoryTracking) {
+    MemoryTracker& tracker = MemoryTracker::getInstance();
+    const MemorySnapshot before = tracker.snapshot();
+    const int64_t bytes = 1000 * sizeof(float);
+    {
+        MemoryProbe probe;
+        {
+            MemoryTagScope tag(MemoryTag::Weights);
+            Tensor w({10, 100});
+            Tensor a({1000});
+            a.grad();
+            const MemorySnapshot during = tracker.snapshot();
+            CHECK(during.tag[(int)MemoryTag::Weights].liveBytes - before.tag[(int)MemoryTag::Weights].liveBytes == 2 * bytes);
+            CHECK(during.tag[(int)MemoryTag::Gradient].liveBytes - before.tag[(int)MemoryTag::Gradient].liveBytes == bytes);
+            CHECK(during.device[(int)Device::CPU].liveBytes - before.device[(int)Device::CPU].liveBytes == 3 * bytes);
+            CHECK(during.total.liveAllocations - before.total.liveAllocations == 3);
+        }
+        CHECK(probe.peakGrowth() == 3 * bytes);
+        CHECK(currentMemoryTag() == MemoryTag::Activation);
+    }
+    const MemorySnapshot after = tracker.snapshot();
+    CHECK(after.total.liveBytes == before.total.liveBytes);
+    CHECK(after.total.allocations - before.total.allocations == 3);
+    CHECK(after.total.peakBytes >= before.total.liveBytes + 3 * bytes);
+
+    // Views and wrapped buffers are not allocations
+    std::vector<float> external(64);
+    const Tensor view = Tensor::fromBuffer(external.data(), {8, 8});
+    const Tensor slice = view.slice(0, 0, 4);
+    CHECK(tracker.snapshot().total.allocations == after.total.allocations);
+
+    // Probes need not end in reverse order: each keeps its own window
+    {
+        auto outer = std::make_unique<MemoryProbe>();
+        Tensor a({1000});
+        auto inner = std::make_unique<MemoryProbe>();
+        CHECK(outer->peakGrowth() == bytes);
+        outer.reset();
+        Tensor b({1000});
+        CHECK(inner->peakGrowth() == bytes);
+    }
+
+    // Live bytes only grow here, so a probe opened amid other threads' allocations must report
+    // at least what was live once it was open
+    {
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 3; ++t) {
+            workers.emplace_back([&] {
+                std::vector<Tensor> held;
+                while (!stop.load(std::memory_order_relaxed) && held.size() < 20000) held.emplace_back(std::vector<int>{16});
+            });
+        }
+        bool covered = true;
+        for (int i = 0; i < 2000; ++i) {
+            MemoryProbe probe;
+            const int64_t live = tracker.snapshot().total.liveBytes;
+            covered = covered && probe.peakBytes() >= live;
+        }
+        stop = true;
+        for (std::thread& w : workers) w.join();
+        CHECK(covered);
+    }
+}
+
+TEST(poolAllocator) {
+    PoolAllocator pool;
+    float* a = pool.allocate(1000); // 4000 bytes: the 4 KB bucket
+    pool.deallocate(a, 1000);
+    float* b = pool.allocate(900);  // same bucket, recycled
+    float* c = pool.allocate(5000); // 32 KB bucket, new
+    CHECK(b == a);
+    AllocatorStats s = pool.stats();
+    CHECK(s.hits == 1 && s.misses == 2);
+    CHECK(s.bytesInUse == 4096 + 32768 && s.highWaterBytes == 4096 + 32768);
+    pool.deallocate(b, 900);
+    pool.deallocate(c, 5000);
+    s = pool.stats();
+    CHECK(s.bytesInUse == 0 && s.highWaterBytes == 4096 + 32768 && s.reservedBytes == 4096 + 32768);
+    pool.trim();
+    CHECK(pool.stats().reservedBytes == 0);
+}
+
+TEST(arenaAllocator) {
+    ArenaAllocator arena(1024);
+    for (int frame = 0; frame < 2; ++frame) {
+        {
+            AllocatorScope scope(arena);
+            Tensor a({100}); // 448 bytes once aligned
+            Tensor b({200}); // 832 bytes: overflows the first 1 KB chunk into a 2 KB one
+            CHECK(currentAllocator().name() == std::string("arena"));
+        }
+        const AllocatorStats s = arena.stats();
+        CHECK(s.hits == (frame == 0 ? 1u : 3u) && s.misses == 1); // the second frame fits the folded chunk
+        CHECK(s.bytesInUse == 448 + 832 && s.highWaterBytes == 448 + 832);
+        arena.reset();
+        CHECK(arena.stats().bytesInUse == 0 && arena.stats().reservedBytes == 1024 + 2048);
+    }
+    CHECK(currentAllocator().name() != std::string("arena"));
+}
+
+TEST(warmFrameSkipsHeap) {
+    // A frame as the JNI path runs it: letterbox into a new input, conv + activation, a reduction
+    ArenaAllocator arena;
+    std::vector<uint8_t> rgba(96 * 72 * 4, 128);
+    const Tensor w = randomTensor({8, 3, 3, 3});
+    const Tensor b = randomTensor({8});
+    auto runFrame = [&] {
+        FrameAllocatorScope frame(arena);
+        Tensor input({1, 3, 64, 64});
+        letterboxNormalize(rgba.data(), 96, 72, 96 * 4, PixelFormat::RGBA8888, input);
+        Tensor y = conv2d(input, w, &b, Conv2dParams());
+        y.ReLU();
+        const Tensor scores = y.sum(1).softmax(-1);
+        CHECK(scores.size() == 62 * 62);
+    };
+    runFrame();
+    const size_t heapMisses = currentAllocator().stats().misses;
+    const size_t arenaMisses = arena.stats().misses;
+    for (int i = 0; i < 3; ++i) runFrame();
+    CHECK(currentAllocator().stats().misses == heapMisses); // no tensor buffer from the system
+    CHECK(arena.stats().misses == arenaMisses);
+    CHECK(arena.stats().bytesInUse == 0);
+}
+
+TEST(loggerWritesRecords) {
+    const std::string path = "tsr_tests.log";
+    Logger& logger = Logger::getInstance();
+    logger.initialize(path, LogLevel::INFO, false);
+    const uint64_t before = logger.getWrittenCount();
+    LOG_DEBUG("filtered");
+    for (int i = 0; i < 10; ++i) LOG_INFO("record " + std::to_string(i));
+    logger.flush();
+    CHECK(logger.getWrittenCount() - before == 10);
+    logger.close();
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string filter = argc > 1 ? argv[1] : "";
+    int run = 0, failed = 0;
+    for (const TestCase& test : registry()) {
+        if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos) continue;
+        const int before = failures;
+        test.fn();
+        ++run;
+        const bool ok = failures == before;
+        failed += !ok;
+        std::cout << (ok ? "[ OK ] " : "[FAIL] ") << test.name << std::endl;
+    }
+    std::cout << run - failed << "/" << run << " tests passed" << std::endl;
+    return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -1,8 +1,8 @@
 package com.example.tsrapp.data.repository
 
 import android.content.Context
-import android.graphics.Bitmap
 import com.example.tsrapp.data.model.TrafficSign
+import com.example.tsrapp.ml.CameraFrame
 import com.example.tsrapp.ml.OnnxInferenceEngine
 import com.example.tsrapp.util.SettingsManager
 import kotlinx.coroutines.Dispatchers
@@ -23,18 +23,18 @@ class TSRRepository(context: Context) {
      * Returns an empty list if the model file (assets/model.onnx) has not been placed yet.
      * Confidence threshold is read from SettingsManager (user-configurable, default 0.5).
      *
-     * @param bitmap The camera frame as a Bitmap
+     * @param frame The camera frame; the caller keeps ownership and releases it
      * @return List of detected traffic signs with bounding boxes and labels
      */
     val isModelLoaded: Boolean get() = engine.isModelLoaded
 
-    suspend fun detectSignsInFrame(bitmap: Bitmap): List<TrafficSign> {
+    suspend fun detectSignsInFrame(frame: CameraFrame): List<TrafficSign> {
         if (!engine.isModelLoaded) return emptyList()
         val threshold = SettingsManager.getConfidenceThreshold(appContext)
         return withContext(Dispatchers.Default) {
             if (!isActive) return@withContext emptyList()
             try {
-                engine.detect(bitmap, threshold)
+                engine.detect(frame, threshold)
             } catch (_: IllegalStateException) {
                 // Engine was closed mid-inference (activity/viewmodel destroyed)
                 emptyList()
@@ -0,0 +1,48 @@
+package com.example.tsrapp.ml
+
+import android.graphics.Bitmap
+import androidx.core.graphics.createBitmap
+import java.nio.ByteBuffer
+
+/**
+ * One analyzed camera frame.
+ *
+ * The native path keeps the frame as tightly packed RGBA8888 in a direct [pixels] buffer,
+ * which [OnnxInferenceEngine] letterboxes straight from. A Bitmap is only built on demand by
+ * [bitmap], for consumers that crop it (the cascade classifier). Frames from the Kotlin
+ * fallback path start out as a Bitmap and have no buffer.
+ *
+ * [release] recycles the Bitmap and hands the buffer back to its owner for a later frame, so
+ * the frame must not be used afterwards.
+ */
+class CameraFrame private constructor(
+    val width: Int,
+    val height: Int,
+    /** RGBA8888, width * 4 bytes per row; null for Bitmap-backed frames */
+    val pixels: ByteBuffer?,
+    private var cached: Bitmap?,
+    private val onRelease: ((ByteBuffer) -> Unit)?,
+) {
+
+    /** The frame as an ARGB_8888 Bitmap, created from [pixels] on first use */
+    fun bitmap(): Bitmap = cached ?: createBitmap(width, height).also {
+        val buffer = checkNotNull(pixels)
+        buffer.rewind()
+        it.copyPixelsFromBuffer(buffer)
+        cached = it
+    }
+
+    fun release() {
+        cached?.let { if (!it.isRecycled) it.recycle() }
+        cached = null
+        if (pixels != null) onRelease?.invoke(pixels)
+    }
+
+    companion object {
+        fun fromRgba(pixels: ByteBuffer, width: Int, height: Int, onRelease: (ByteBuffer) -> Unit) =
+            CameraFrame(width, height, pixels, null, onRelease)
+
+        /** Wraps [bitmap]; [release] recycles it */
+        fun fromBitmap(bitmap: Bitmap) = CameraFrame(bitmap.width, bitmap.height, null, bitmap, null)
+    }
+}
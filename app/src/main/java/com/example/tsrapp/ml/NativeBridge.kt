@@ -0,0 +1,128 @@
+package com.example.tsrapp.ml
+
+import android.util.Log
+import java.nio.ByteBuffer
+
+/**
+ * JNI entry points into libtraffic_sign_detection (app/src/main/cpp).
+ *
+ * All buffers must be direct ByteBuffers so the native side can read and write
+ * them in place. Callers should check [isAvailable] and keep their Kotlin
+ * fallback for devices where the library failed to load.
+ */
+object NativeBridge {
+
+    private const val TAG = "NativeBridge"
+
+    /** Matches `PixelFormat` in preprocess.hpp. */
+    const val PIXEL_FORMAT_RGBA8888 = 0
+    const val PIXEL_FORMAT_BGRA8888 = 1
+
+    val isAvailable: Boolean = try {
+        System.loadLibrary("traffic_sign_detection")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "Native library unavailable, using Kotlin paths: ${e.message}")
+        false
+    }
+
+    /**
+     * Converts one YUV_420_888 camera frame (the three plane buffers of an ImageProxy) into
+     * RGBA8888 in [dst], rotated clockwise by [rotationDegrees] (0/90/180/270). [dst] needs
+     * width * height * 4 bytes and can be handed straight to Bitmap.copyPixelsFromBuffer.
+     */
+    external fun yuv420ToRgba(
+        y: ByteBuffer,
+        u: ByteBuffer,
+        v: ByteBuffer,
+        width: Int,
+        height: Int,
+        yRowStride: Int,
+        uvRowStride: Int,
+        uvPixelStride: Int,
+        rotationDegrees: Int,
+        dst: ByteBuffer
+    ): Boolean
+
+    /**
+     * Letterboxes [src] (4 bytes per pixel, [srcRowStride] bytes per row) onto a
+     * [dstSize]x[dstSize] grey canvas and writes normalized planar RGB floats into [dst]
+     * (native byte order, capacity >= 3 * dstSize * dstSize * 4 bytes).
+     */
+    external fun letterboxNormalize(
+        src: ByteBuffer,
+        srcWidth: Int,
+        srcHeight: Int,
+        srcRowStride: Int,
+        pixelFormat: Int,
+        dst: ByteBuffer,
+        dstSize: Int
+    ): Boolean
+
+    /**
+     * Decodes a YOLOv8 head ([1, 4 + numClasses, numAnchors] floats in [output]), maps boxes
+     * back through the letterbox and runs greedy NMS at [iouThreshold] (per class when
+     * [classAware]). Writes up to [maxResults] `[x1, y1, x2, y2, score, classId]` float rows,
+     * highest score first, into [results] and returns the row count, or -1 on error.
+     */
+    external fun postprocessYolo(
+        output: ByteBuffer,
+        numClasses: Int,
+        numAnchors: Int,
+        confThreshold: Float,
+        iouThreshold: Float,
+        classAware: Boolean,
+        padX: Int,
+        padY: Int,
+        scale: Float,
+        results: ByteBuffer,
+        maxResults: Int
+    ): Int
+
+    /**
+     * Pipeline trace: while recording (between [traceStart] and [traceStop]) native stages
+     * and [timed] blocks are captured as timeline spans; [traceWrite] exports everything
+     * recorded since the last export as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+     */
+    external fun traceStart()
+    external fun traceStop()
+    external fun isTracing(): Boolean
+    external fun traceWrite(path: String): Boolean
+
+    external fun traceName(name: String): Long
+    external fun stageHistogram(name: String): Long
+    external fun recordStage(traceName: Long, histogram: Long, beginNs: Long, endNs: Long)
+
+    /**
+     * Latency percentiles (p50/p90/p99/p99.9/max) of every pipeline stage plus counters and
+     * gauges, as one "name n=.. p50=.. ms" line per metric or as JSON (nanoseconds).
+     * [reset] starts a new window, e.g. once per debug HUD refresh.
+     */
+    external fun metricsText(reset: Boolean): String
+    external fun metricsJson(reset: Boolean): String
+    /** Writes [metricsText] to the native log. */
+    external fun metricsLog(reset: Boolean)
+
+    /**
+     * Native tensor memory: live/peak bytes and live/total allocation counts overall, per
+     * device and per tag (activation, weights, preproc, ...), one line each.
+     */
+    external fun memoryText(): String
+
+    /** A pipeline stage timed from Kotlin: a trace span name and a latency histogram. */
+    class Stage(name: String) {
+        val span      = if (isAvailable) traceName(name) else 0L
+        val histogram = if (isAvailable) stageHistogram(name) else 0L
+    }
+
+    /** Runs [block], recording its duration in [stage]'s histogram (and trace, while tracing). */
+    inline fun <T> timed(stage: Stage, block: () -> T): T {
+        if (stage.histogram == 0L) return block()
+        val begin = System.nanoTime()
+        try {
+            return block()
+        } finally {
+            recordStage(stage.span, stage.histogram, begin, System.nanoTime())
+        }
+    }
+}
@@ -11,6 +11,8 @@ import android.util.Log
 import com.example.tsrapp.data.model.TrafficSign
 import com.example.tsrapp.util.SignLabelToSpeech
 import org.json.JSONObject
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 import java.nio.FloatBuffer
 import java.util.concurrent.locks.ReentrantReadWriteLock
 import kotlin.concurrent.read
@@ -56,6 +58,9 @@ class OnnxInferenceEngine(
         private const val INPUT_SIZE    = 640
         private const val NUM_ANCHORS   = 8400
         private const val IOU_THRESHOLD = 0.45f
+        private const val MAX_DETECTIONS = 300
+        // Class-agnostic like nms(), so devices with and without the native library keep the same output
+        private const val CLASS_AWARE_NMS = false
 
         // NNAPI requires API 27+ and a native ARM device.
         // GPU support is disabled for emulator
@@ -65,12 +70,50 @@ class OnnxInferenceEngine(
     }
 
     private data class PreprocessedFrame(
-        val inputData: FloatArray,
+        val inputData: FloatBuffer,
         val padX: Int,
         val padY: Int,
         val scale: Float,
     )
 
+    /**
+     * Direct buffers reused across frames by the native preprocessing path.
+     * Thread-local because [detect] may run concurrently under the read lock.
+     */
+    private class NativeBuffers {
+        private var frame: ByteBuffer = ByteBuffer.allocateDirect(0)
+        val input: ByteBuffer = ByteBuffer.allocateDirect(3 * INPUT_SIZE * INPUT_SIZE * 4)
+            .order(ByteOrder.nativeOrder())
+        val inputFloats: FloatBuffer = input.asFloatBuffer()
+
+        private var output: ByteBuffer = ByteBuffer.allocateDirect(0)
+        val results: ByteBuffer = ByteBuffer.allocateDirect(MAX_DETECTIONS * 6 * 4)
+            .order(ByteOrder.nativeOrder())
+        val resultFloats: FloatBuffer = results.asFloatBuffer()
+
+        fun frameBuffer(byteCount: Int): ByteBuffer {
+            if (frame.capacity() < byteCount) frame = ByteBuffer.allocateDirect(byteCount)
+            frame.rewind()
+            return frame
+        }
+
+        fun outputBuffer(floatCount: Int): ByteBuffer {
+            if (output.capacity() < floatCount * 4) {
+                output = ByteBuffer.allocateDirect(floatCount * 4).order(ByteOrder.nativeOrder())
+            }
+            output.rewind()
+            return output
+        }
+    }
+
+    private val nativeBuffers = object : ThreadLocal<NativeBuffers>() {
+        override fun initialValue() = NativeBuffers()
+    }
+
+    /** Kotlin-side pipeline stages for the native trace and latency metrics */
+    private val inferenceStage = NativeBridge.Stage("inference")
+    private val refineStage    = NativeBridge.Stage("cascade refine")
+
     private val modelFile   = region.modelFile
     private val classesFile = region.classesFile
 
@@ -131,108 +174,181 @@ class OnnxInferenceEngine(
      * Detects traffic signs in [bitmap] above [confidenceThreshold].
      * Returns an empty list if the model has not been loaded yet.
      */
-    fun detect(bitmap: Bitmap, confidenceThreshold: Float): List<TrafficSign> {
+    fun detect(bitmap: Bitmap, confidenceThreshold: Float): List<TrafficSign> =
+        detect(CameraFrame.fromBitmap(bitmap), confidenceThreshold) // not released: the caller owns bitmap
+
+    /**
+     * Detects traffic signs in [frame] above [confidenceThreshold]. RGBA frames are letterboxed
+     * straight from their buffer; a Bitmap is only made if the cascade classifier needs crops.
+     */
+    fun detect(frame: CameraFrame, confidenceThreshold: Float): List<TrafficSign> {
         return sessionLock.read {
             val session = ortSession ?: return emptyList()
             if (numClasses == 0) return emptyList()
 
             // 1. Preprocess: letterbox to 640x640, normalize, NCHW float array
-            val preprocessed = preprocess(bitmap)
+            val preprocessed = preprocess(frame)
             val shape        = longArrayOf(1, 3, INPUT_SIZE.toLong(), INPUT_SIZE.toLong())
 
             // 2. Run inference
             val inputName  = session.inputNames.iterator().next()
-            val inputTensor = OnnxTensor.createTensor(ortEnv, FloatBuffer.wrap(preprocessed.inputData), shape)
-            
-            val detections = mutableListOf<FloatArray>() // [x1, y1, x2, y2, conf, classId]
-            
+            val inputTensor = OnnxTensor.createTensor(ortEnv, preprocessed.inputData, shape)
+
+            // 3-4. Decode + Non-Maximum Suppression, 5. map to TrafficSign. The native path
+            //      reads its rows straight out of the pinned results buffer.
+            val signs = ArrayList<TrafficSign>()
             try {
-                session.run(mapOf(inputName to inputTensor)).use { results ->
-                    // 3. Parse output: shape [1][4+numClasses][8400]
-                    @Suppress("UNCHECKED_CAST")
-                    val output = (results[0].value as Array<Array<FloatArray>>)[0]
-
-                    for (a in 0 until NUM_ANCHORS) {
-                        val cx = output[0][a]
-                        val cy = output[1][a]
-                        val w  = output[2][a]
-                        val h  = output[3][a]
-
-                        var maxScore = 0f
-                        var classId  = -1
-                        for (c in 0 until numClasses) {
-                            val score = output[4 + c][a]
-                            if (score > maxScore) {
-                                maxScore = score
-                                classId  = c
-                            }
-                        }
-
-                        if (maxScore < confidenceThreshold) continue
-
-                        // Map from 640x640 letterbox space back to original bitmap coordinates
-                        val x1 = (cx - w / 2f - preprocessed.padX) / preprocessed.scale
-                        val y1 = (cy - h / 2f - preprocessed.padY) / preprocessed.scale
-                        val x2 = (cx + w / 2f - preprocessed.padX) / preprocessed.scale
-                        val y2 = (cy + h / 2f - preprocessed.padY) / preprocessed.scale
-
-                        detections.add(floatArrayOf(x1, y1, x2, y2, maxScore, classId.toFloat()))
+                if (NativeBridge.isAvailable) {
+                    val buffers = nativeBuffers.get()
+                    val count   = runAndPostprocessNative(
+                        session, inputName, inputTensor, preprocessed, confidenceThreshold, buffers
+                    )
+                    val rows    = buffers.resultFloats
+                    for (i in 0 until count) {
+                        val o = i * 6
+                        toSign(frame, rows.get(o), rows.get(o + 1), rows.get(o + 2), rows.get(o + 3),
+                               rows.get(o + 4), rows.get(o + 5).toInt())?.let(signs::add)
+                    }
+                } else {
+                    for (det in nms(runAndDecode(session, inputName, inputTensor, preprocessed, confidenceThreshold))) {
+                        toSign(frame, det[0], det[1], det[2], det[3], det[4], det[5].toInt())?.let(signs::add)
                     }
                 }
             } finally {
                 inputTensor.close()
             }
+            return@read signs
+        }
+    }
 
-            // 4. Non-Maximum Suppression
-            val kept = nms(detections)
-
-            // 5. Map to TrafficSign domain objects — clamp boxes to bitmap bounds,
-            //    enforce minimum size before clamping so coerce order never violates bounds
-            val bitmapW = bitmap.width.toFloat()
-            val bitmapH = bitmap.height.toFloat()
-
-            return@read kept.mapNotNull { det ->
-                val id             = det[5].toInt()
-                val detectorLabel  = classNames.getOrElse(id) { "Unknown ($id)" }
-
-                // Clamp all four edges to bitmap bounds
-                val left   = det[0].coerceIn(0f, bitmapW)
-                val top    = det[1].coerceIn(0f, bitmapH)
-                val right  = det[2].coerceIn(0f, bitmapW)
-                val bottom = det[3].coerceIn(0f, bitmapH)
-
-                // Skip detections that are completely outside or have zero area after clamping
-                if (right <= left || bottom <= top) return@mapNotNull null
-
-                // Apply cascade classifier (US only) to refine the detector label
-                val box   = android.graphics.RectF(left, top, right, bottom)
-                val label = cascadeClassifier?.refine(bitmap, box, detectorLabel) ?: detectorLabel
-
-                TrafficSign(
-                    label       = label,
-                    confidence  = det[4],
-                    boundingBox = TrafficSign.BoundingBox(
-                        left   = left,
-                        top    = top,
-                        right  = right,
-                        bottom = bottom
-                    ),
-                    isCritical = SignLabelToSpeech.isCriticalRoadAlert(label)
-                )
+    // 5. Map one detection to a TrafficSign: clamp the box to the frame bounds and drop it if
+    //    nothing is left, then let the cascade classifier (US only) refine the detector label
+    private fun toSign(
+        frame: CameraFrame,
+        x1: Float, y1: Float, x2: Float, y2: Float,
+        confidence: Float,
+        classId: Int,
+    ): TrafficSign? {
+        val frameW = frame.width.toFloat()
+        val frameH = frame.height.toFloat()
+        val left   = x1.coerceIn(0f, frameW)
+        val top    = y1.coerceIn(0f, frameH)
+        val right  = x2.coerceIn(0f, frameW)
+        val bottom = y2.coerceIn(0f, frameH)
+        if (right <= left || bottom <= top) return null
+
+        val detectorLabel = classNames.getOrElse(classId) { "Unknown ($classId)" }
+        val box   = android.graphics.RectF(left, top, right, bottom)
+        val label = NativeBridge.timed(refineStage) {
+            cascadeClassifier?.refine(frame.bitmap(), box, detectorLabel)
+        } ?: detectorLabel
+
+        return TrafficSign(
+            label       = label,
+            confidence  = confidence,
+            boundingBox = TrafficSign.BoundingBox(
+                left   = left,
+                top    = top,
+                right  = right,
+                bottom = bottom
+            ),
+            isCritical = SignLabelToSpeech.isCriticalRoadAlert(label)
+        )
+    }
+
+    // 3. Parse output: shape [1][4+numClasses][8400] → [x1, y1, x2, y2, conf, classId] per anchor
+    private fun runAndDecode(
+        session: OrtSession,
+        inputName: String,
+        inputTensor: OnnxTensor,
+        preprocessed: PreprocessedFrame,
+        confidenceThreshold: Float,
+    ): MutableList<FloatArray> {
+        val detections = mutableListOf<FloatArray>()
+        NativeBridge.timed(inferenceStage) { session.run(mapOf(inputName to inputTensor)) }.use { results ->
+            @Suppress("UNCHECKED_CAST")
+            val output = (results[0].value as Array<Array<FloatArray>>)[0]
+
+            for (a in 0 until NUM_ANCHORS) {
+                val cx = output[0][a]
+                val cy = output[1][a]
+                val w  = output[2][a]
+                val h  = output[3][a]
+
+                var maxScore = 0f
+                var classId  = -1
+                for (c in 0 until numClasses) {
+                    val score = output[4 + c][a]
+                    if (score > maxScore) {
+                        maxScore = score
+                        classId  = c
+                    }
+                }
+
+                if (maxScore < confidenceThreshold) continue
+
+                // Map from 640x640 letterbox space back to original bitmap coordinates
+                val x1 = (cx - w / 2f - preprocessed.padX) / preprocessed.scale
+                val y1 = (cy - h / 2f - preprocessed.padY) / preprocessed.scale
+                val x2 = (cx + w / 2f - preprocessed.padX) / preprocessed.scale
+                val y2 = (cy + h / 2f - preprocessed.padY) / preprocessed.scale
+
+                detections.add(floatArrayOf(x1, y1, x2, y2, maxScore, classId.toFloat()))
+            }
+        }
+        return detections
+    }
+
+    // 3-4. Same as runAndDecode + nms, but ONNX Runtime writes the head into a pinned direct
+    //      buffer and the native SIMD decoder and NMS run on it without boxing it into arrays.
+    //      Returns the number of [x1, y1, x2, y2, conf, classId] rows in buffers.resultFloats.
+    private fun runAndPostprocessNative(
+        session: OrtSession,
+        inputName: String,
+        inputTensor: OnnxTensor,
+        preprocessed: PreprocessedFrame,
+        confidenceThreshold: Float,
+        buffers: NativeBuffers,
+    ): Int {
+        val rows        = 4 + numClasses
+        val output      = buffers.outputBuffer(rows * NUM_ANCHORS)
+        val outputName  = session.outputNames.iterator().next()
+        val outputShape = longArrayOf(1, rows.toLong(), NUM_ANCHORS.toLong())
+
+        OnnxTensor.createTensor(ortEnv, output.asFloatBuffer(), outputShape).use { outputTensor ->
+            NativeBridge.timed(inferenceStage) {
+                session.run(mapOf(inputName to inputTensor), mapOf(outputName to outputTensor)).close()
             }
         }
+
+        val count = NativeBridge.postprocessYolo(
+            output, numClasses, NUM_ANCHORS, confidenceThreshold, IOU_THRESHOLD, CLASS_AWARE_NMS,
+            preprocessed.padX, preprocessed.padY, preprocessed.scale,
+            buffers.results, MAX_DETECTIONS
+        )
+        return maxOf(count, 0)
     }
 
     // Letterbox to 640x640, normalize [0,1], return NCHW float array.
-    private fun preprocess(bitmap: Bitmap): PreprocessedFrame {
-        val srcW = bitmap.width
-        val srcH = bitmap.height
+    private fun preprocess(frame: CameraFrame): PreprocessedFrame {
+        val srcW = frame.width
+        val srcH = frame.height
         val letterboxScale = minOf(INPUT_SIZE.toFloat() / srcW, INPUT_SIZE.toFloat() / srcH)
         val newW = (srcW * letterboxScale).toInt()
         val newH = (srcH * letterboxScale).toInt()
         val letterboxPadX = (INPUT_SIZE - newW) / 2
         val letterboxPadY = (INPUT_SIZE - newH) / 2
 
+        preprocessNative(frame)?.let { input ->
+            return PreprocessedFrame(
+                inputData = input,
+                padX = letterboxPadX,
+                padY = letterboxPadY,
+                scale = letterboxScale,
+            )
+        }
+
+        val bitmap      = frame.bitmap()
         val resized     = Bitmap.createScaledBitmap(bitmap, newW, newH, true)
         val letterboxed = Bitmap.createBitmap(INPUT_SIZE, INPUT_SIZE, Bitmap.Config.ARGB_8888)
         val canvas      = android.graphics.Canvas(letterboxed)
@@ -254,13 +370,40 @@ class OnnxInferenceEngine(
         if (resized != bitmap) resized.recycle()
         letterboxed.recycle()
         return PreprocessedFrame(
-            inputData = floatArray,
+            inputData = FloatBuffer.wrap(floatArray),
             padX = letterboxPadX,
             padY = letterboxPadY,
             scale = letterboxScale,
         )
     }
 
+    // Fused native letterbox + normalize straight into a reusable direct buffer, which ONNX
+    // Runtime consumes without copying. RGBA frames are read in place; Bitmap-backed frames
+    // (test mode, video files) are staged through a reused buffer first. Returns null when the
+    // Kotlin path must be used instead.
+    private fun preprocessNative(frame: CameraFrame): FloatBuffer? {
+        if (!NativeBridge.isAvailable) return null
+        val buffers = nativeBuffers.get() ?: return null
+        val ok = if (frame.pixels != null) {
+            NativeBridge.letterboxNormalize(
+                frame.pixels, frame.width, frame.height, frame.width * 4,
+                NativeBridge.PIXEL_FORMAT_RGBA8888, buffers.input, INPUT_SIZE
+            )
+        } else {
+            val bitmap = frame.bitmap()
+            if (bitmap.config != Bitmap.Config.ARGB_8888) return null
+            val staged = buffers.frameBuffer(bitmap.byteCount)
+            bitmap.copyPixelsToBuffer(staged)
+            NativeBridge.letterboxNormalize(
+                staged, bitmap.width, bitmap.height, bitmap.rowBytes,
+                NativeBridge.PIXEL_FORMAT_RGBA8888, buffers.input, INPUT_SIZE
+            )
+        }
+        if (!ok) return null
+        buffers.inputFloats.rewind()
+        return buffers.inputFloats
+    }
+
     // Greedy NMS: sort by confidence descending, suppress boxes with IoU >= threshold
     private fun nms(detections: MutableList<FloatArray>): List<FloatArray> {
         if (detections.isEmpty()) return emptyList()
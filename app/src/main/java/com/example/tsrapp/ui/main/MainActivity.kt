@@ -23,13 +23,18 @@ import androidx.camera.lifecycle.ProcessCameraProvider
 import androidx.camera.view.PreviewView
 import androidx.core.content.ContextCompat
 import androidx.core.graphics.createBitmap
+import com.example.tsrapp.BuildConfig
 import com.example.tsrapp.R
 import com.example.tsrapp.databinding.ActivityMainBinding
+import com.example.tsrapp.ml.CameraFrame
+import com.example.tsrapp.ml.NativeBridge
 import com.example.tsrapp.util.DriverAlertFeedback
 import com.example.tsrapp.util.SettingsManager
 import com.example.tsrapp.util.SignLabelToSpeech
 import com.example.tsrapp.util.TextToSpeechHelper
 import java.io.ByteArrayOutputStream
+import java.nio.ByteBuffer
+import java.util.concurrent.ConcurrentLinkedQueue
 import java.util.concurrent.ExecutorService
 import java.util.concurrent.Executors
 import androidx.core.view.ViewCompat
@@ -179,6 +184,13 @@ class MainActivity : AppCompatActivity() {
         viewModel.modelError.observe(this) { msg ->
             if (msg != null) Toast.makeText(this, msg, Toast.LENGTH_LONG).show()
         }
+
+        if (BuildConfig.DEBUG) {
+            viewModel.latencyHud.observe(this) { text ->
+                binding.latencyHud.text = text.trimEnd()
+                binding.latencyHud.visibility = View.VISIBLE
+            }
+        }
     }
 
     private fun showIdleState() {
@@ -238,9 +250,9 @@ class MainActivity : AppCompatActivity() {
                 val imageAnalysis = ImageAnalysis.Builder()
                     .setBackpressureStrategy(ImageAnalysis.STRATEGY_KEEP_ONLY_LATEST)
                     .build().also {
-                        it.setAnalyzer(cameraExecutor, FrameAnalyzer { bitmap ->
-                            binding.detectionOverlay.setSourceSize(bitmap.width, bitmap.height)
-                            viewModel.processFrame(bitmap)
+                        it.setAnalyzer(cameraExecutor, FrameAnalyzer { frame ->
+                            binding.detectionOverlay.setSourceSize(frame.width, frame.height)
+                            viewModel.processFrame(frame)
                         })
                     }
 
@@ -282,16 +294,51 @@ class MainActivity : AppCompatActivity() {
         ttsHelper.shutdown()
     }
 
-    // ── Frame conversion (unchanged) ──────────────────────────────────────────
+    // ── Frame conversion: native YUV→RGBA, Bitmap fallback ───────────────────
 
-    private class FrameAnalyzer(private val onFrameAvailable: (Bitmap) -> Unit) :
+    private class FrameAnalyzer(private val onFrameAvailable: (CameraFrame) -> Unit) :
         ImageAnalysis.Analyzer {
 
+        // RGBA staging buffers for the native conversion. A frame keeps its buffer until the
+        // detector releases it, so steady state cycles between two: one in flight, one filling.
+        private val freeBuffers = ConcurrentLinkedQueue<ByteBuffer>()
+
         override fun analyze(imageProxy: ImageProxy) {
-            val bitmap = imageProxyToBitmap(imageProxy)
-            onFrameAvailable(bitmap)
+            val frame = nativeImageProxyToFrame(imageProxy)
+                ?: CameraFrame.fromBitmap(imageProxyToBitmap(imageProxy))
+            onFrameAvailable(frame)
             imageProxy.close()
         }
+
+        // Converts and rotates the YUV planes in one native pass straight from the camera's
+        // direct buffers, skipping the NV21 copy, JPEG round trip and rotation bitmap. The
+        // RGBA buffer goes to the detector as is; no Bitmap is made unless a crop needs one.
+        private fun nativeImageProxyToFrame(imageProxy: ImageProxy): CameraFrame? {
+            if (!NativeBridge.isAvailable || imageProxy.format != ImageFormat.YUV_420_888) return null
+            val width    = imageProxy.width
+            val height   = imageProxy.height
+            val rotation = imageProxy.imageInfo.rotationDegrees
+            val (y, u, v) = imageProxy.planes
+
+            var rgbaBuffer = freeBuffers.poll()
+            if (rgbaBuffer == null || rgbaBuffer.capacity() < width * height * 4) {
+                rgbaBuffer = ByteBuffer.allocateDirect(width * height * 4)
+            }
+            val ok = NativeBridge.yuv420ToRgba(
+                y.buffer, u.buffer, v.buffer, width, height,
+                y.rowStride, u.rowStride, u.pixelStride, rotation, rgbaBuffer
+            )
+            if (!ok) {
+                freeBuffers.offer(rgbaBuffer)
+                return null
+            }
+
+            val swapped = rotation % 180 != 0
+            return CameraFrame.fromRgba(
+                rgbaBuffer, if (swapped) height else width, if (swapped) width else height
+            ) { buffer -> freeBuffers.offer(buffer) }
+        }
+
         private fun imageProxyToBitmap(imageProxy: ImageProxy): Bitmap {
             val nv21 = yuv420888ToNv21(imageProxy)
             val yuvImage = YuvImage(nv21, ImageFormat.NV21, imageProxy.width, imageProxy.height, null)
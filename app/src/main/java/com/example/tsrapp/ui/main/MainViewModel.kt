@@ -1,13 +1,15 @@
 package com.example.tsrapp.ui.main
 
 import android.app.Application
-import android.graphics.Bitmap
 import androidx.lifecycle.AndroidViewModel
 import androidx.lifecycle.LiveData
 import androidx.lifecycle.MutableLiveData
 import androidx.lifecycle.viewModelScope
+import com.example.tsrapp.BuildConfig
 import com.example.tsrapp.data.model.TrafficSign
 import com.example.tsrapp.data.repository.TSRRepository
+import com.example.tsrapp.ml.CameraFrame
+import com.example.tsrapp.ml.NativeBridge
 import com.example.tsrapp.util.BoundingBoxSmoother
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
@@ -19,6 +21,7 @@ import java.util.concurrent.atomic.AtomicBoolean
 
 private const val DETECTION_PERSIST_MS = 1500L
 private const val STABLE_FRAMES_REQUIRED = 2
+private const val LATENCY_HUD_WINDOW_MS = 1000L
 
 class MainViewModel(application: Application) : AndroidViewModel(application) {
 
@@ -38,6 +41,16 @@ class MainViewModel(application: Application) : AndroidViewModel(application) {
     private val _fps = MutableLiveData<Float>()
     val fps: LiveData<Float> = _fps
 
+    /**
+     * Debug HUD text: p50/p90/p99/p99.9/max per pipeline stage over the last
+     * [LATENCY_HUD_WINDOW_MS], one line per stage, then native memory usage. Only updated in
+     * debug builds with the native library.
+     */
+    private val _latencyHud = MutableLiveData<String>()
+    val latencyHud: LiveData<String> = _latencyHud
+    private val frameStage = NativeBridge.Stage("frame")
+    private var lastHudUpdate = 0L
+
     private var lastFrameTime = 0L
     private val isProcessingFrame = AtomicBoolean(false)
 
@@ -68,7 +81,8 @@ class MainViewModel(application: Application) : AndroidViewModel(application) {
         _detectedSigns.postValue(emptyList())
     }
 
-    fun processFrame(bitmap: Bitmap) {
+    /** Runs detection on [frame] unless one is still in flight; releases the frame either way */
+    fun processFrame(frame: CameraFrame) {
         val now = System.currentTimeMillis()
         if (lastFrameTime > 0) {
             val delta = now - lastFrameTime
@@ -77,7 +91,7 @@ class MainViewModel(application: Application) : AndroidViewModel(application) {
         lastFrameTime = now
 
         if (!isProcessingFrame.compareAndSet(false, true)) {
-            if (!bitmap.isRecycled) bitmap.recycle()
+            frame.release()
             return
         }
 
@@ -92,12 +106,16 @@ class MainViewModel(application: Application) : AndroidViewModel(application) {
                 }
                 val startTime = System.currentTimeMillis()
                 val signs = withContext(Dispatchers.Default) {
-                    repo.detectSignsInFrame(bitmap)
+                    NativeBridge.timed(frameStage) { repo.detectSignsInFrame(frame) }
                 }
                 _inferenceTimeMs.postValue(System.currentTimeMillis() - startTime)
+                if (BuildConfig.DEBUG && NativeBridge.isAvailable && startTime - lastHudUpdate >= LATENCY_HUD_WINDOW_MS) {
+                    lastHudUpdate = startTime
+                    _latencyHud.postValue(NativeBridge.metricsText(reset = true) + NativeBridge.memoryText())
+                }
                 _detectedSigns.postValue(smoother.smooth(stabilize(signs)))
             } finally {
-                if (!bitmap.isRecycled) bitmap.recycle()
+                frame.release()
                 isProcessingFrame.set(false)
             }
         }